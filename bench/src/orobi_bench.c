@@ -0,0 +1,545 @@
+// orobi_bench.c
+// Host-Benchmark der heißen Pfade: Murmur3, XSalsa20-Poly1305 je Krypto-Backend, Paket erstellen/verschlüsseln/
+// entschlüsseln (alt und Wire-Format) und die Ticket-Tabelle bzw. Ticket-Liste mit 10 bis 10000 Einträgen.
+//
+//   make bench && build/orobi_bench [-t ms_pro_benchmark=300] [-f filter]
+//
+// Ausgabe: eine JSON-Zeile pro Benchmark auf stdout (maschinenlesbar, z.B. für Regressionsvergleiche):
+//   {"bench":"murmur3_64","param":"size","value":64,"batch":64,"ops":...,"ops_per_sec":...,
+//    "p50_ns":...,"p99_ns":...,"p999_ns":...,"max_ns":...}
+// Latenzen sind ns pro Operation. Schnelle Operationen werden in Blöcken zu "batch" Aufrufen gemessen,
+// die Perzentile beziehen sich dann auf den Mittelwert eines Blocks.
+// Die Ticket-Tabelle mit 10000 Einträgen braucht -DOROBI_TICKET_CAPACITY=16384 -DOROBI_TICKET_INDEX_BITS=15,
+// sonst wird sie mit "skipped" gemeldet.
+#define _GNU_SOURCE
+#include "orobi_crypto.h"
+#include "orobi_packet.h"
+#include "orobi_ticket.h"
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_SAMPLES   (1u << 20)
+#define BENCH_MIN_SAMPLES   64
+#define BENCH_CRYPT_CHUNK   64          // vorab verschlüsselte Pakete pro Runde (decrypt/decode)
+
+typedef struct {
+    double*     samples;                // ns pro Operation, ein Wert pro Block
+    size_t      count;
+    uint64_t    ops;
+    uint64_t    total_ns;
+    uint64_t    budget_ns;
+} bench_t;
+
+typedef struct {
+    uint128_t       id;
+    unsigned char   public_key[crypto_box_PUBLICKEYBYTES];
+    unsigned char   secret_key[crypto_box_SECRETKEYBYTES];
+    orobi_secure_t  secure;
+} bench_peer_t;
+
+static uint64_t    bench_budget_ms = 300;
+static const char* bench_filter = NULL;
+static volatile uint64_t bench_sink;    // verhindert, dass der Compiler Ergebnisse wegoptimiert
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static bool bench_selected(const char* name) {
+    return !bench_filter || strstr(name, bench_filter) != NULL;
+}
+
+static void bench_begin(bench_t* bench) {
+    bench->count = 0;
+    bench->ops = 0;
+    bench->total_ns = 0;
+    bench->budget_ns = bench_budget_ms * 1000000u;
+}
+
+// Trägt einen gemessenen Block von ops Operationen ein
+static inline void bench_sample(bench_t* bench, uint64_t start, uint64_t end, uint32_t ops) {
+    if (bench->count < BENCH_MAX_SAMPLES) {
+        bench->samples[bench->count++] = (double)(end - start) / ops;
+    }
+    bench->ops += ops;
+    bench->total_ns += end - start;
+}
+
+static bool bench_running(const bench_t* bench) {
+    return bench->count < BENCH_MAX_SAMPLES &&
+           (bench->total_ns < bench->budget_ns || bench->count < BENCH_MIN_SAMPLES);
+}
+
+static int bench_compare(const void* a, const void* b) {
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_percentile(const bench_t* bench, double p) {
+    size_t rank = (size_t)(p * (double)bench->count);
+    return bench->samples[rank < bench->count ? rank : bench->count - 1];
+}
+
+static void bench_report(bench_t* bench, const char* name, const char* param, uint64_t value, uint32_t batch) {
+    if (bench->count == 0 || bench->total_ns == 0) {
+        return;
+    }
+    qsort(bench->samples, bench->count, sizeof(double), bench_compare);
+    printf("{\"bench\":\"%s\",\"param\":\"%s\",\"value\":%" PRIu64 ",\"batch\":%u,\"ops\":%" PRIu64
+           ",\"ops_per_sec\":%.0f,\"p50_ns\":%.1f,\"p99_ns\":%.1f,\"p999_ns\":%.1f,\"max_ns\":%.1f}\n",
+           name, param, value, batch, bench->ops, (double)bench->ops * 1e9 / (double)bench->total_ns,
+           bench_percentile(bench, 0.50), bench_percentile(bench, 0.99), bench_percentile(bench, 0.999),
+           bench->samples[bench->count - 1]);
+    fflush(stdout);
+}
+
+static void bench_skip(const char* name, const char* param, uint64_t value, const char* reason) {
+    printf("{\"bench\":\"%s\",\"param\":\"%s\",\"value\":%" PRIu64 ",\"skipped\":\"%s\"}\n",
+           name, param, value, reason);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Hash
+
+static void bench_hash(bench_t* bench) {
+    static const size_t sizes[] = { 8, 64, 256, 1024, 4096 };
+    static const struct {
+        const char*       name;
+        orobi_hash_algo_t algo;
+    } algos[] = {
+        { "murmur3_64",   OROBI_HASH_MURMUR3_64 },
+        { "murmur3_64x4", OROBI_HASH_MURMUR3_64X4 }
+    };
+    static uint8_t data[4096];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 131u + 7u);
+    }
+
+    for (size_t a = 0; a < sizeof(algos) / sizeof(algos[0]); a++) {
+        if (!bench_selected(algos[a].name) || !orobi_hash_supported(algos[a].algo)) {
+            continue;
+        }
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            const size_t size = sizes[s];
+            const uint32_t batch = size <= 256 ? 64 : 8;
+            uint64_t acc = 0;
+            bench_begin(bench);
+            while (bench_running(bench)) {
+                const uint64_t start = bench_now_ns();
+                for (uint32_t i = 0; i < batch; i++) {
+                    acc += orobi_hash_64(algos[a].algo, data, size, acc);
+                }
+                bench_sample(bench, start, bench_now_ns(), batch);
+            }
+            bench_sink = acc;
+            bench_report(bench, algos[a].name, "size", size, batch);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Krypto-Backends: box/box_open mit crypto_box_ZEROBYTES + size Bytes, wie in orobi_encode_packet
+
+static void bench_crypto(bench_t* bench) {
+    static const size_t sizes[] = { 64, 256, 1024, 4096 };
+    static const struct {
+        const char*             box;
+        const char*             open;
+        orobi_crypto_backend_t  backend;
+    } backends[] = {
+        { "box_nacl",   "box_open_nacl",   OROBI_CRYPTO_NACL },
+        { "box_native", "box_open_native", OROBI_CRYPTO_NATIVE }
+    };
+    static uint8_t plain[crypto_box_ZEROBYTES + 4096], cipher[crypto_box_ZEROBYTES + 4096];
+    uint8_t key[crypto_box_BEFORENMBYTES], nonce[crypto_box_NONCEBYTES];
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (uint8_t)(i * 29u + 3u);
+    }
+    memset(nonce, 0x5A, sizeof(nonce));
+    for (size_t i = crypto_box_ZEROBYTES; i < sizeof(plain); i++) {
+        plain[i] = (uint8_t)(i * 131u + 7u);
+    }
+
+    const orobi_crypto_backend_t active = orobi_crypto_get_backend();
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        if (!bench_selected(backends[b].box) && !bench_selected(backends[b].open)) {
+            continue;
+        }
+        if (orobi_crypto_set_backend(backends[b].backend) != OROBI_OK) {
+            bench_skip(backends[b].box, "size", 0, "self test failed");
+            continue;
+        }
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            const size_t size = crypto_box_ZEROBYTES + sizes[s];
+            const uint32_t batch = sizes[s] <= 256 ? 16 : 4;
+
+            if (bench_selected(backends[b].box)) {
+                bench_begin(bench);
+                while (bench_running(bench)) {
+                    const uint64_t start = bench_now_ns();
+                    for (uint32_t i = 0; i < batch; i++) {
+                        nonce[0] = (uint8_t)i;
+                        orobi_crypto_box_afternm(cipher, plain, size, nonce, key);
+                    }
+                    bench_sample(bench, start, bench_now_ns(), batch);
+                }
+                bench_report(bench, backends[b].box, "size", sizes[s], batch);
+            }
+
+            if (bench_selected(backends[b].open)) {
+                static uint8_t opened[crypto_box_ZEROBYTES + 4096];
+                int failed = 0;
+                nonce[0] = 0;
+                orobi_crypto_box_afternm(cipher, plain, size, nonce, key);
+                bench_begin(bench);
+                while (bench_running(bench)) {
+                    const uint64_t start = bench_now_ns();
+                    for (uint32_t i = 0; i < batch; i++) {
+                        failed |= orobi_crypto_box_open_afternm(opened, cipher, size, nonce, key);
+                    }
+                    bench_sample(bench, start, bench_now_ns(), batch);
+                }
+                bench_sink = (uint64_t)failed;
+                bench_report(bench, backends[b].open, "size", sizes[s], batch);
+            }
+        }
+    }
+    orobi_crypto_set_backend(active);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Pakete
+
+static void bench_peer_init(bench_peer_t* peer, uint128_t id) {
+    peer->id = id;
+    crypto_box_keypair(peer->public_key, peer->secret_key);
+    orobi_secure_init(&peer->secure, id, peer->public_key, peer->secret_key);
+    orobi_secure_alloc_scratch(&peer->secure);
+}
+
+static void bench_packet(bench_t* bench) {
+    static const uint16_t sizes[] = { 16, 256, OROBI_MAXMESSAGESIZE };
+    // Beide Seiten mit derselben id: der Pakethash ist mit der id geseedet
+    const uint128_t id = { .high = 0x0B0B000000000001ull, .low = 42 };
+    bench_peer_t* robot = calloc(2, sizeof(bench_peer_t));
+    bench_peer_t* ground = robot + 1;
+    orobi_packet_t* packet = malloc(sizeof(orobi_packet_t));
+    orobi_packet_t* opened = malloc(sizeof(orobi_packet_t));
+    orobi_crypt_packet_t* crypt = malloc(BENCH_CRYPT_CHUNK * sizeof(orobi_crypt_packet_t));
+    uint8_t* wire = malloc((size_t)BENCH_CRYPT_CHUNK * OROBI_WIRE_SIZE(OROBI_MAXMESSAGESIZE));
+    size_t* wire_size = malloc(BENCH_CRYPT_CHUNK * sizeof(size_t));
+    char* message = malloc(OROBI_MAXMESSAGESIZE);
+    if (!robot || !packet || !opened || !crypt || !wire || !wire_size || !message) {
+        fprintf(stderr, "bench_packet: out of memory\n");
+        exit(1);
+    }
+    bench_peer_init(robot, id);
+    bench_peer_init(ground, id);
+    for (size_t i = 0; i < OROBI_MAXMESSAGESIZE; i++) {
+        message[i] = (char)('a' + i % 26);
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const uint16_t size = sizes[s];
+
+        if (bench_selected("create_packet")) {
+            bench_begin(bench);
+            while (bench_running(bench)) {
+                const uint64_t start = bench_now_ns();
+                orobi_create_packet(&robot->secure, packet, message, size);
+                bench_sample(bench, start, bench_now_ns(), 1);
+            }
+            bench_report(bench, "create_packet", "size", size, 1);
+        }
+
+        // orobi_encrypt_packet/orobi_decrypt_packet verschlüsseln immer das ganze orobi_packet_t,
+        // die Nachrichtengröße ändert nur den Inhalt
+        orobi_create_packet(&robot->secure, packet, message, size);
+        if (bench_selected("encrypt_packet")) {
+            bench_begin(bench);
+            while (bench_running(bench)) {
+                const uint64_t start = bench_now_ns();
+                orobi_encrypt_packet(&robot->secure, packet, &crypt[0], ground->public_key);
+                bench_sample(bench, start, bench_now_ns(), 1);
+            }
+            bench_report(bench, "encrypt_packet", "size", size, 1);
+        }
+
+        // Replay-Schutz: jedes Paket lässt sich nur einmal öffnen, daher in Runden vorab verschlüsseln
+        if (bench_selected("decrypt_packet")) {
+            bench_begin(bench);
+            while (bench_running(bench)) {
+                for (size_t i = 0; i < BENCH_CRYPT_CHUNK; i++) {
+                    orobi_create_packet(&robot->secure, packet, message, size);
+                    orobi_encrypt_packet(&robot->secure, packet, &crypt[i], ground->public_key);
+                }
+                for (size_t i = 0; i < BENCH_CRYPT_CHUNK; i++) {
+                    const uint64_t start = bench_now_ns();
+                    orobi_error_t status = orobi_decrypt_packet(&ground->secure, &crypt[i], opened, robot->public_key);
+                    bench_sample(bench, start, bench_now_ns(), 1);
+                    if (status != OROBI_OK) {
+                        fprintf(stderr, "decrypt_packet: %d\n", status);
+                        exit(1);
+                    }
+                }
+            }
+            bench_report(bench, "decrypt_packet", "size", size, 1);
+        }
+
+        // Kompaktes Wire-Format (Netzwerkpfad), Größe hängt von message_size ab
+        if (bench_selected("encode_packet")) {
+            bench_begin(bench);
+            while (bench_running(bench)) {
+                const uint64_t start = bench_now_ns();
+                orobi_encode_packet(&robot->secure, packet, ground->public_key, wire,
+                                    OROBI_WIRE_SIZE(OROBI_MAXMESSAGESIZE), &wire_size[0]);
+                bench_sample(bench, start, bench_now_ns(), 1);
+            }
+            bench_report(bench, "encode_packet", "size", size, 1);
+        }
+
+        if (bench_selected("decode_packet")) {
+            bench_begin(bench);
+            while (bench_running(bench)) {
+                for (size_t i = 0; i < BENCH_CRYPT_CHUNK; i++) {
+                    orobi_create_packet(&robot->secure, packet, message, size);
+                    orobi_encode_packet(&robot->secure, packet, ground->public_key,
+                                        wire + i * OROBI_WIRE_SIZE(OROBI_MAXMESSAGESIZE),
+                                        OROBI_WIRE_SIZE(OROBI_MAXMESSAGESIZE), &wire_size[i]);
+                }
+                for (size_t i = 0; i < BENCH_CRYPT_CHUNK; i++) {
+                    const uint64_t start = bench_now_ns();
+                    orobi_error_t status = orobi_decode_packet(&ground->secure,
+                                                               wire + i * OROBI_WIRE_SIZE(OROBI_MAXMESSAGESIZE),
+                                                               wire_size[i], opened, robot->public_key);
+                    bench_sample(bench, start, bench_now_ns(), 1);
+                    if (status != OROBI_OK) {
+                        fprintf(stderr, "decode_packet: %d\n", status);
+                        exit(1);
+                    }
+                }
+            }
+            bench_report(bench, "decode_packet", "size", size, 1);
+        }
+    }
+
+    // orobi_secure_close gibt ctx selbst frei, die Kontexte liegen hier im calloc-Block
+    orobi_secure_set_scratch(&robot->secure, NULL, 0);
+    orobi_secure_set_scratch(&ground->secure, NULL, 0);
+    free(robot);
+    free(packet);
+    free(opened);
+    free(crypt);
+    free(wire);
+    free(wire_size);
+    free(message);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Tickets
+
+#define BENCH_TICKET_BATCH  16
+
+// Zufällige, paarweise verschiedene ids (Fisher-Yates über den ganzen uint16-Raum)
+static void bench_ticket_ids(uint16_t* ids, size_t count) {
+    static uint16_t all[UINT16_MAX + 1];
+    for (uint32_t i = 0; i <= UINT16_MAX; i++) {
+        all[i] = (uint16_t)i;
+    }
+    for (uint32_t i = UINT16_MAX; i > 0; i--) {
+        uint32_t j = (uint32_t)rand() % (i + 1);
+        uint16_t tmp = all[i];
+        all[i] = all[j];
+        all[j] = tmp;
+    }
+    memcpy(ids, all, count * sizeof(uint16_t));
+}
+
+static void bench_ticket_table(bench_t* bench, orobi_ticket_table_t* table, const uint16_t* ids, size_t n) {
+    orobi_ticket_t ticket;
+
+    if (bench_selected("ticket_table_create")) {
+        bench_begin(bench);
+        while (bench_running(bench)) {
+            orobi_ticket_table_clear(table);
+            for (size_t i = 0; i < n; i += BENCH_TICKET_BATCH) {
+                const uint32_t batch = (uint32_t)(n - i < BENCH_TICKET_BATCH ? n - i : BENCH_TICKET_BATCH);
+                const uint64_t start = bench_now_ns();
+                for (uint32_t k = 0; k < batch; k++) {
+                    orobi_ticket_table_create(table, ids[i + k], 0x7F000001u, 1000);
+                }
+                bench_sample(bench, start, bench_now_ns(), batch);
+            }
+        }
+        bench_report(bench, "ticket_table_create", "entries", n, BENCH_TICKET_BATCH);
+    }
+
+    orobi_ticket_table_clear(table);
+    for (size_t i = 0; i < n; i++) {
+        orobi_ticket_table_create(table, ids[i], 0x7F000001u, 1000);
+    }
+    if (bench_selected("ticket_table_find")) {
+        size_t next = 0;
+        uint64_t acc = 0;
+        bench_begin(bench);
+        while (bench_running(bench)) {
+            const uint64_t start = bench_now_ns();
+            for (uint32_t k = 0; k < BENCH_TICKET_BATCH; k++) {
+                orobi_ticket_table_find(table, ids[next], &ticket);
+                acc += ticket.ip;
+                next = (next + 7919) % n;
+            }
+            bench_sample(bench, start, bench_now_ns(), BENCH_TICKET_BATCH);
+        }
+        bench_sink = acc;
+        bench_report(bench, "ticket_table_find", "entries", n, BENCH_TICKET_BATCH);
+    }
+
+    if (bench_selected("ticket_table_remove")) {
+        bench_begin(bench);
+        while (bench_running(bench)) {
+            orobi_ticket_table_clear(table);
+            for (size_t i = 0; i < n; i++) {
+                orobi_ticket_table_create(table, ids[i], 0x7F000001u, 1000);
+            }
+            // in anderer Reihenfolge als angelegt entfernen
+            for (size_t i = 0; i < n; i += BENCH_TICKET_BATCH) {
+                const uint32_t batch = (uint32_t)(n - i < BENCH_TICKET_BATCH ? n - i : BENCH_TICKET_BATCH);
+                const uint64_t start = bench_now_ns();
+                for (uint32_t k = 0; k < batch; k++) {
+                    orobi_ticket_table_remove(table, ids[n - 1 - (i + k)]);
+                }
+                bench_sample(bench, start, bench_now_ns(), batch);
+            }
+        }
+        bench_report(bench, "ticket_table_remove", "entries", n, BENCH_TICKET_BATCH);
+    }
+}
+
+static void bench_ticket_list(bench_t* bench, const uint16_t* ids, size_t n) {
+    orobi_ticket_t* list = NULL;
+    orobi_ticket_t* found;
+
+    if (bench_selected("ticket_list_create")) {
+        bench_begin(bench);
+        while (bench_running(bench)) {
+            for (size_t i = 0; i < n; i += BENCH_TICKET_BATCH) {
+                const uint32_t batch = (uint32_t)(n - i < BENCH_TICKET_BATCH ? n - i : BENCH_TICKET_BATCH);
+                const uint64_t start = bench_now_ns();
+                for (uint32_t k = 0; k < batch; k++) {
+                    orobi_ticket_create(ids[i + k], 0x7F000001u, 1000, &list);
+                }
+                bench_sample(bench, start, bench_now_ns(), batch);
+            }
+            orobi_ticket_free(list);
+            list = NULL;
+        }
+        bench_report(bench, "ticket_list_create", "entries", n, BENCH_TICKET_BATCH);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        orobi_ticket_create(ids[i], 0x7F000001u, 1000, &list);
+    }
+    if (bench_selected("ticket_list_find")) {
+        size_t next = 0;
+        uint64_t acc = 0;
+        bench_begin(bench);
+        while (bench_running(bench)) {
+            const uint64_t start = bench_now_ns();
+            for (uint32_t k = 0; k < BENCH_TICKET_BATCH; k++) {
+                orobi_ticket_find(ids[next], list, &found);
+                acc += found->ip;
+                next = (next + 7919) % n;
+            }
+            bench_sample(bench, start, bench_now_ns(), BENCH_TICKET_BATCH);
+        }
+        bench_sink = acc;
+        bench_report(bench, "ticket_list_find", "entries", n, BENCH_TICKET_BATCH);
+    }
+    orobi_ticket_free(list);
+    list = NULL;
+
+    if (bench_selected("ticket_list_remove")) {
+        bench_begin(bench);
+        while (bench_running(bench)) {
+            for (size_t i = 0; i < n; i++) {
+                orobi_ticket_create(ids[i], 0x7F000001u, 1000, &list);
+            }
+            for (size_t i = 0; i < n; i += BENCH_TICKET_BATCH) {
+                const uint32_t batch = (uint32_t)(n - i < BENCH_TICKET_BATCH ? n - i : BENCH_TICKET_BATCH);
+                const uint64_t start = bench_now_ns();
+                for (uint32_t k = 0; k < batch; k++) {
+                    orobi_ticket_remove(ids[i + k], &list);
+                }
+                bench_sample(bench, start, bench_now_ns(), batch);
+            }
+        }
+        bench_report(bench, "ticket_list_remove", "entries", n, BENCH_TICKET_BATCH);
+    }
+}
+
+static void bench_ticket(bench_t* bench) {
+    static const size_t sizes[] = { 10, 100, 1000, 10000 };
+    uint16_t* ids = malloc(10000 * sizeof(uint16_t));
+    orobi_ticket_table_t* table = malloc(sizeof(orobi_ticket_table_t));
+    if (!ids || !table) {
+        fprintf(stderr, "bench_ticket: out of memory\n");
+        exit(1);
+    }
+    orobi_ticket_table_init(table, 0);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const size_t n = sizes[s];
+        bench_ticket_ids(ids, n);
+        if (n <= OROBI_TICKET_CAPACITY) {
+            bench_ticket_table(bench, table, ids, n);
+        } else if (bench_selected("ticket_table")) {
+            bench_skip("ticket_table", "entries", n, "OROBI_TICKET_CAPACITY");
+        }
+        bench_ticket_list(bench, ids, n);
+    }
+
+    free(table);
+    free(ids);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "t:f:")) != -1) {
+        switch (opt) {
+        case 't':
+            bench_budget_ms = strtoull(optarg, NULL, 10);
+            break;
+        case 'f':
+            bench_filter = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t ms_per_benchmark] [-f filter]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench_t bench = { .samples = malloc(BENCH_MAX_SAMPLES * sizeof(double)) };
+    if (!bench.samples) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+
+    printf("{\"meta\":\"orobi_bench\",\"budget_ms\":%" PRIu64 ",\"ticket_capacity\":%u,\"max_message_size\":%u,"
+           "\"crypto\":\"%s\"}\n",
+           bench_budget_ms, (unsigned)OROBI_TICKET_CAPACITY, (unsigned)OROBI_MAXMESSAGESIZE, orobi_crypto_backend_name());
+    bench_hash(&bench);
+    bench_crypto(&bench);
+    bench_packet(&bench);
+    bench_ticket(&bench);
+
+    free(bench.samples);
+    return 0;
+}
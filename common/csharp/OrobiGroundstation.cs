@@ -60,11 +60,13 @@ public class OrobiGroundstation
         robots.Add(newRobot);
     }
 
+    [Obsolete("ASCII-Protokoll, Kommandos mit OrobiBatchWriter als Batch senden")]
     public string CreateCommandString(ushort compass, byte motor, ushort durationMs)
     {
         return $"A{compass:000}{motor:00}{durationMs:0000}#";
     }
 
+    [Obsolete("ASCII-Protokoll, ersetzt durch ProcessTelemetry")]
     public List<OrobiCommandStatus> ProcessResponse(string responseStr)
     {
         List<OrobiCommandStatus> statuses = new List<OrobiCommandStatus>();
@@ -95,6 +97,24 @@ public class OrobiGroundstation
         return statuses;
     }
 
+    // Dekodiert eine entschlüsselte Telemetrie-Nachricht (OrobiSession.TryOpen) nach frames, ohne Allokation.
+    // Rückgabe: Anzahl Frames; -1, wenn message keine Telemetrie ist. Überzählige Frames werden ignoriert.
+    public static int ProcessTelemetry(ReadOnlySpan<byte> message, Span<OrobiTelemetryFrame> frames)
+    {
+        var reader = new OrobiTelemetryReader(message);
+        if (!reader.IsValid)
+        {
+            return -1;
+        }
+
+        int count = 0;
+        while (count < frames.Length && reader.TryRead(out frames[count]))
+        {
+            count++;
+        }
+        return count;
+    }
+
     public void SendPcPublicKey(byte[] pcPublicKey)
     {
         string pcPublicKeyHex = BitConverter.ToString(pcPublicKey).Replace("-", "").ToLowerInvariant();
@@ -16,21 +16,30 @@ public class Program
         // Roboter hinzufügen
         groundstation.AddRobot(robotId, esp32PublicKey, "Robot1");
 
-        // Command-String erstellen
-        string commandStr = groundstation.CreateCommandString(360, 99, 1000);
-        Console.WriteLine($"Command String: {commandStr}");
+        // Kommandos als Batch in einen Puffer schreiben (danach mit OrobiSession.TrySeal verschlüsseln)
+        Span<byte> batchBuffer = stackalloc byte[64];
+        var batch = new OrobiBatchWriter(batchBuffer);
+        batch.TryAddMotor(360, 99, 0);
+        Console.WriteLine($"Batch: {batch.Count} Kommando(s), {batch.Size} Bytes");
 
         // Sende den PC Public Key an den ESP32
         groundstation.SendPcPublicKey(groundPublicKey);
         Console.WriteLine("Ground Public Key sent to ESP32.");
 
-        // Beispielantwort verarbeiten
-        string responseStr = "S0010001636368000#S0020011636668000#S0030021636668001#";
-        List<OrobiCommandStatus> statuses = groundstation.ProcessResponse(responseStr);
+        // Beispielantwort verarbeiten: Marker 0xF1, drei Status-Frames (flags | seq_nr | status | timestamp_ms)
+        byte[] response =
+        {
+            0xF1,
+            0x00, 0x01, 0x00, 0xE8, 0x03, 0x00, 0x00,
+            0x00, 0x02, 0x01, 0xEC, 0x03, 0x00, 0x00,
+            0x00, 0x03, 0x03, 0xF0, 0x03, 0x00, 0x00
+        };
+        Span<OrobiTelemetryFrame> frames = stackalloc OrobiTelemetryFrame[16];
+        int count = OrobiGroundstation.ProcessTelemetry(response, frames);
 
-        foreach (var status in statuses)
+        for (int i = 0; i < count; i++)
         {
-            Console.WriteLine($"SeqNr: {status.SeqNr}, Status: {status.Status}, Timestamp: {status.Timestamp}");
+            Console.WriteLine($"SeqNr: {frames[i].SeqNr}, Status: {frames[i].Status}, Timestamp: {frames[i].TimestampMs} ms");
         }
     }
 }
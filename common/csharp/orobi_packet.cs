@@ -1,76 +1,163 @@
 using System;
 using System.Runtime.InteropServices;
 
+// Binding über orobi_interop.h: opaker Kontext, Puffer als Zeiger + Länge.
+// Spans werden beim Aufruf nur gepinnt (blittable ref byte), es wird kein Struct marshalled und pro Paket
+// weder ein String noch ein Array allokiert. Sende- und Empfangspuffer kommen vom Aufrufer (z.B. ArrayPool).
+public enum OrobiStatus
+{
+    Ok = 0,
+    InvalidInput = -1,
+    PacketTooOld = -2,
+    NonceReplay = -3,
+    EncryptionFailed = -4,
+    DecryptionFailed = -5,
+    HashMismatch = -6,
+    PacketValidationFailed = -7,
+    Memory = -8,
+    InitializationFailed = -9,
+    TimeSync = -10,
+    DependencyMissing = -11,
+    BufferOverflow = -12,
+    InvalidConfiguration = -13,
+    CryptographicFailure = -14,
+    InvalidCommand = -15,
+    CommandOverflow = -16,
+    UnsupportedCommand = -17
+}
+
 public static class OrobiSecure
 {
     private const string DllName = "libopenrobi.so"; // Name deiner kompilierte Bibliothek
 
-    [StructLayout(LayoutKind.Sequential)]
-    public struct OrobiSecureNonce
+    public const int KeyBytes = 32; // crypto_box_PUBLICKEYBYTES / SECRETKEYBYTES
+
+    [DllImport(DllName)]
+    public static extern ulong orobi_murmur3_64(ref byte data, nuint len, ulong seed);
+
+    [DllImport(DllName)]
+    internal static extern OrobiStatus orobi_interop_create(out OrobiSessionHandle handle, ulong id_high, ulong id_low,
+                                                            ref byte public_key, ref byte secret_key);
+
+    [DllImport(DllName)]
+    internal static extern void orobi_interop_destroy(IntPtr handle);
+
+    [DllImport(DllName)]
+    internal static extern OrobiStatus orobi_interop_seal(OrobiSessionHandle handle, ref byte their_public_key,
+                                                          byte seq_nr, ushort api_key, ref byte message, int size,
+                                                          ref byte buffer, int buffer_size, out int written);
+
+    [DllImport(DllName)]
+    internal static extern OrobiStatus orobi_interop_open(OrobiSessionHandle handle, ref byte their_public_key,
+                                                          ref byte data, int size, ref byte message, int message_capacity,
+                                                          out int message_size, out ushort api_key, out byte seq_nr);
+
+    [DllImport(DllName)]
+    internal static extern OrobiStatus orobi_interop_clock_reply(OrobiSessionHandle handle, ref byte request, int size,
+                                                                 ref byte buffer, int buffer_size, out int written);
+
+    [DllImport(DllName)]
+    internal static extern uint orobi_interop_now_ms(OrobiSessionHandle handle);
+
+    [DllImport(DllName)]
+    internal static extern IntPtr orobi_interop_last_error(OrobiSessionHandle handle);
+
+    [DllImport(DllName)]
+    public static extern int orobi_interop_max_packet_size();
+
+    [DllImport(DllName)]
+    public static extern int orobi_interop_max_message_size();
+
+    public static ulong Murmur3(ReadOnlySpan<byte> data, ulong seed)
     {
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 24)] // crypto_box_NONCEBYTES
-        public byte[] bytes;
-        public uint counter;
-        public long timestamp; // time_t is generally long in Unix systems
+        return orobi_murmur3_64(ref MemoryMarshal.GetReference(data), (nuint)data.Length, seed);
     }
+}
+
+internal sealed class OrobiSessionHandle : SafeHandle
+{
+    public OrobiSessionHandle() : base(IntPtr.Zero, true) { }
+
+    public override bool IsInvalid => handle == IntPtr.Zero;
 
-    [StructLayout(LayoutKind.Sequential)]
-    public struct OrobiPacket
+    protected override bool ReleaseHandle()
     {
-        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 4096)] // OROBI_MAXMESSAGESIZE
-        public string message;
-        public ushort message_size;
-        public ulong api_key;
-        public ulong packet_hash;
-        public long timestamp;
-        public OrobiSecureNonce nonce;
+        OrobiSecure.orobi_interop_destroy(handle);
+        return true;
     }
+}
 
-    [StructLayout(LayoutKind.Sequential)]
-    public struct OrobiCryptPacket
+// Sicherer Kontext der Bodenstation. Nicht threadsicher: ein Objekt pro Empfangs-/Sende-Thread.
+public sealed class OrobiSession : IDisposable
+{
+    public static readonly int MaxPacketSize = OrobiSecure.orobi_interop_max_packet_size();
+    public static readonly int MaxMessageSize = OrobiSecure.orobi_interop_max_message_size();
+    public const byte ClockRequestMarker = 0xF4;   // OROBI_CLOCK_REQUEST_MARKER
+    public const int ClockResponseSize = 13;        // OROBI_CLOCK_RESPONSE_SIZE
+
+    private readonly OrobiSessionHandle handle;
+
+    public OrobiSession(ulong idHigh, ulong idLow, ReadOnlySpan<byte> publicKey, ReadOnlySpan<byte> secretKey)
     {
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4112)] // sizeof(packet_t) + crypto_box_ZEROBYTES
-        public byte[] encrypted_data;
-        public ulong crypt_hash;
-        public OrobiSecureNonce nonce;
+        CheckKey(publicKey, nameof(publicKey));
+        CheckKey(secretKey, nameof(secretKey));
+        OrobiStatus status = OrobiSecure.orobi_interop_create(out handle, idHigh, idLow,
+                                                              ref MemoryMarshal.GetReference(publicKey),
+                                                              ref MemoryMarshal.GetReference(secretKey));
+        if (status != OrobiStatus.Ok)
+        {
+            handle.Dispose();
+            throw new InvalidOperationException($"orobi_interop_create: {status}");
+        }
     }
 
-    [StructLayout(LayoutKind.Sequential)]
-    public struct Uint128
+    // Verschlüsselt message als Netzwerkpaket nach destination (mind. MaxPacketSize reicht immer).
+    // Kein Throw im Paketpfad: Fehler als Status, Text bei Bedarf über LastError.
+    public OrobiStatus TrySeal(ReadOnlySpan<byte> theirPublicKey, byte seqNr, ushort apiKey,
+                               ReadOnlySpan<byte> message, Span<byte> destination, out int written)
     {
-        public ulong high;
-        public ulong low;
+        CheckKey(theirPublicKey, nameof(theirPublicKey));
+        return OrobiSecure.orobi_interop_seal(handle, ref MemoryMarshal.GetReference(theirPublicKey), seqNr, apiKey,
+                                              ref MemoryMarshal.GetReference(message), message.Length,
+                                              ref MemoryMarshal.GetReference(destination), destination.Length,
+                                              out written);
     }
 
-    [StructLayout(LayoutKind.Sequential)]
-    public struct OrobiSecureContext
+    // Öffnet ein empfangenes Netzwerkpaket; die Nachricht wird nach message kopiert (mind. MaxMessageSize reicht immer)
+    public OrobiStatus TryOpen(ReadOnlySpan<byte> theirPublicKey, ReadOnlySpan<byte> packet, Span<byte> message,
+                               out int messageSize, out ushort apiKey, out byte seqNr)
     {
-        public Uint128 id;
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)] // crypto_box_PUBLICKEYBYTES
-        public byte[] public_key;
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)] // crypto_box_SECRETKEYBYTES
-        public byte[] secret_key;
-        public OrobiSecureNonce last_seen_nonce;
-        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 128)] // OROBI_ERROR_BUFFER_SIZE
-        public string last_error;
-        public int last_status;
+        CheckKey(theirPublicKey, nameof(theirPublicKey));
+        return OrobiSecure.orobi_interop_open(handle, ref MemoryMarshal.GetReference(theirPublicKey),
+                                              ref MemoryMarshal.GetReference(packet), packet.Length,
+                                              ref MemoryMarshal.GetReference(message), message.Length,
+                                              out messageSize, out apiKey, out seqNr);
     }
 
-    [DllImport(DllName)]
-    public static extern ulong orobi_murmur3_64(IntPtr data, ulong len, ulong seed);
-
-    [DllImport(DllName)]
-    public static extern void orobi_secure_init(ref OrobiSecureContext ctx, Uint128 id, byte[] public_key, byte[] secret_key);
+    // Beantwortet eine mit TryOpen empfangene Uhrabgleich-Anfrage (message[0] == ClockRequestMarker);
+    // die Antwort (ClockResponseSize Bytes) mit TrySeal an den Roboter zurücksenden
+    public OrobiStatus TryClockReply(ReadOnlySpan<byte> request, Span<byte> reply, out int written)
+    {
+        return OrobiSecure.orobi_interop_clock_reply(handle, ref MemoryMarshal.GetReference(request), request.Length,
+                                                     ref MemoryMarshal.GetReference(reply), reply.Length, out written);
+    }
 
-    [DllImport(DllName)]
-    public static extern int orobi_secure_close(ref OrobiSecureContext ctx);
+    // Sitzungszeit in ms, Vergleichsbasis für OrobiTelemetryFrame.TimestampMs synchronisierter Roboter
+    public uint NowMs => OrobiSecure.orobi_interop_now_ms(handle);
 
-    [DllImport(DllName)]
-    public static extern int orobi_create_packet(ref OrobiSecureContext ctx, ref OrobiPacket packet, string message, ushort size);
+    // Text zum letzten Fehler; allokiert einen String, nur im Fehlerfall aufrufen
+    public string LastError => Marshal.PtrToStringUTF8(OrobiSecure.orobi_interop_last_error(handle)) ?? string.Empty;
 
-    [DllImport(DllName)]
-    public static extern int orobi_encrypt_packet(ref OrobiSecureContext ctx, ref OrobiPacket packet, ref OrobiCryptPacket crypt_packet, byte[] their_public_key);
+    public void Dispose()
+    {
+        handle.Dispose();
+    }
 
-    [DllImport(DllName)]
-    public static extern int orobi_decrypt_packet(ref OrobiSecureContext ctx, ref OrobiCryptPacket crypt_packet, ref OrobiPacket packet, byte[] their_public_key);
+    private static void CheckKey(ReadOnlySpan<byte> key, string name)
+    {
+        if (key.Length != OrobiSecure.KeyBytes)
+        {
+            throw new ArgumentException($"Key must be {OrobiSecure.KeyBytes} bytes", name);
+        }
+    }
 }
@@ -0,0 +1,416 @@
+using System;
+using System.Buffers.Binary;
+
+// Binäre Telemetrie (orobi_telemetry.h) und Kommando-Batches (orobi_batch.h) ohne Allokation:
+// gelesen und geschrieben wird direkt in Spans, z.B. in den Nachrichtenpuffer von OrobiSession.TryOpen/TrySeal.
+[Flags]
+public enum OrobiTelemetryFields : byte
+{
+    None = 0,
+    Battery = 0x01,
+    Motor = 0x02,
+    Heading = 0x04,
+    Distance = 0x08,
+    Imu = 0x10,
+    Temperature = 0x20,
+    Rssi = 0x40
+}
+
+public struct OrobiTelemetryFrame
+{
+    public OrobiTelemetryFields Fields;     // nur gesetzte Felder sind gültig
+    public byte SeqNr;                      // seq_nr des Netzwerkpakets, auf das sich Status bezieht
+    public OrobiCommandStatusType Status;
+    public uint TimestampMs;                // Zeit des Roboters
+    public ushort BatteryMv;
+    public ushort Speed;
+    public ushort Rotation;
+    public ushort Heading;                  // 0.01 Grad
+    public ushort DistanceMm;
+    public short AccelX;                    // mg
+    public short AccelY;
+    public short AccelZ;
+    public short Temperature;               // 0.01 Grad C
+    public sbyte Rssi;                      // dBm
+}
+
+public ref struct OrobiTelemetryReader
+{
+    public const byte Marker = 0xF1;
+    public const int HeaderSize = 7;
+    private const byte FieldsMask = 0x7F;
+
+    private readonly ReadOnlySpan<byte> data;
+    private int pos;
+
+    // message: entschlüsselte Nachricht; IsValid == false, wenn es keine Telemetrie ist (z.B. ein Batch)
+    public OrobiTelemetryReader(ReadOnlySpan<byte> message)
+    {
+        IsValid = IsMessage(message);
+        data = IsValid ? message : ReadOnlySpan<byte>.Empty;
+        pos = 1;
+    }
+
+    public bool IsValid { get; }
+
+    public static bool IsMessage(ReadOnlySpan<byte> message)
+    {
+        return message.Length > 0 && message[0] == Marker;
+    }
+
+    public static int FrameSize(OrobiTelemetryFields fields)
+    {
+        int size = HeaderSize;
+        if ((fields & OrobiTelemetryFields.Battery) != 0) size += 2;
+        if ((fields & OrobiTelemetryFields.Motor) != 0) size += 4;
+        if ((fields & OrobiTelemetryFields.Heading) != 0) size += 2;
+        if ((fields & OrobiTelemetryFields.Distance) != 0) size += 2;
+        if ((fields & OrobiTelemetryFields.Imu) != 0) size += 6;
+        if ((fields & OrobiTelemetryFields.Temperature) != 0) size += 2;
+        if ((fields & OrobiTelemetryFields.Rssi) != 0) size += 1;
+        return size;
+    }
+
+    // Nächster Frame. false am Ende oder bei einem defekten Frame (der Rest ist dann nicht lesbar).
+    public bool TryRead(out OrobiTelemetryFrame frame)
+    {
+        frame = default;
+        if (pos + HeaderSize > data.Length)
+        {
+            return false;
+        }
+
+        byte flags = data[pos];
+        byte status = data[pos + 2];
+        if ((flags & ~FieldsMask) != 0 || status > (byte)OrobiCommandStatusType.InvalidCommand)
+        {
+            pos = data.Length;
+            return false;
+        }
+
+        var fields = (OrobiTelemetryFields)flags;
+        if (pos + FrameSize(fields) > data.Length)
+        {
+            pos = data.Length;
+            return false;
+        }
+
+        ReadOnlySpan<byte> p = data.Slice(pos);
+        frame.Fields = fields;
+        frame.SeqNr = p[1];
+        frame.Status = (OrobiCommandStatusType)status;
+        frame.TimestampMs = BinaryPrimitives.ReadUInt32LittleEndian(p.Slice(3));
+        int i = HeaderSize;
+        if ((fields & OrobiTelemetryFields.Battery) != 0)
+        {
+            frame.BatteryMv = BinaryPrimitives.ReadUInt16LittleEndian(p.Slice(i));
+            i += 2;
+        }
+        if ((fields & OrobiTelemetryFields.Motor) != 0)
+        {
+            frame.Speed = BinaryPrimitives.ReadUInt16LittleEndian(p.Slice(i));
+            frame.Rotation = BinaryPrimitives.ReadUInt16LittleEndian(p.Slice(i + 2));
+            i += 4;
+        }
+        if ((fields & OrobiTelemetryFields.Heading) != 0)
+        {
+            frame.Heading = BinaryPrimitives.ReadUInt16LittleEndian(p.Slice(i));
+            i += 2;
+        }
+        if ((fields & OrobiTelemetryFields.Distance) != 0)
+        {
+            frame.DistanceMm = BinaryPrimitives.ReadUInt16LittleEndian(p.Slice(i));
+            i += 2;
+        }
+        if ((fields & OrobiTelemetryFields.Imu) != 0)
+        {
+            frame.AccelX = BinaryPrimitives.ReadInt16LittleEndian(p.Slice(i));
+            frame.AccelY = BinaryPrimitives.ReadInt16LittleEndian(p.Slice(i + 2));
+            frame.AccelZ = BinaryPrimitives.ReadInt16LittleEndian(p.Slice(i + 4));
+            i += 6;
+        }
+        if ((fields & OrobiTelemetryFields.Temperature) != 0)
+        {
+            frame.Temperature = BinaryPrimitives.ReadInt16LittleEndian(p.Slice(i));
+            i += 2;
+        }
+        if ((fields & OrobiTelemetryFields.Rssi) != 0)
+        {
+            frame.Rssi = (sbyte)p[i];
+            i += 1;
+        }
+        pos += i;
+        return true;
+    }
+}
+
+// Kommandos als Batch (type u8 | len u8 | Daten) direkt in den Puffer des Aufrufers; ersetzt CreateCommandString
+public ref struct OrobiBatchWriter
+{
+    private const byte TypeMotor = 0;   // OROBI_COMMAND_MOTORDATA
+    private const byte TypeInt = 2;     // OROBI_COMMAND_INT
+    private const byte TypeUser = 5;    // OROBI_COMMAND_USER
+
+    private readonly Span<byte> buffer;
+
+    public OrobiBatchWriter(Span<byte> buffer)
+    {
+        this.buffer = buffer;
+        Size = 0;
+        Count = 0;
+    }
+
+    public int Size { get; private set; }
+    public int Count { get; private set; }
+    public ReadOnlySpan<byte> Written => buffer.Slice(0, Size);
+
+    // buttons: Bit 0 Bremse, Bit 1 Licht, Bit 2-3 reserviert. false: kein Platz mehr, erst senden.
+    public bool TryAddMotor(ushort speed, ushort rotation, byte buttons)
+    {
+        if (!Reserve(TypeMotor, 5, out Span<byte> p))
+        {
+            return false;
+        }
+        BinaryPrimitives.WriteUInt16LittleEndian(p, speed);
+        BinaryPrimitives.WriteUInt16LittleEndian(p.Slice(2), rotation);
+        p[4] = (byte)(buttons & 0x0F);
+        return true;
+    }
+
+    public bool TryAddInt(uint value)
+    {
+        if (!Reserve(TypeInt, 4, out Span<byte> p))
+        {
+            return false;
+        }
+        BinaryPrimitives.WriteUInt32LittleEndian(p, value);
+        return true;
+    }
+
+    public bool TryAddUser(ReadOnlySpan<byte> data)
+    {
+        if (data.Length > byte.MaxValue)
+        {
+            return false;
+        }
+        if (!Reserve(TypeUser, data.Length, out Span<byte> p))
+        {
+            return false;
+        }
+        data.CopyTo(p);
+        return true;
+    }
+
+    public void Reset()
+    {
+        Size = 0;
+        Count = 0;
+    }
+
+    // false, wenn der Eintrag nicht mehr passt
+    private bool Reserve(byte type, int length, out Span<byte> data)
+    {
+        if (Size + 2 + length > buffer.Length)
+        {
+            data = Span<byte>.Empty;
+            return false;
+        }
+        buffer[Size] = type;
+        buffer[Size + 1] = (byte)length;
+        data = buffer.Slice(Size + 2, length);
+        Size += 2 + length;
+        Count++;
+        return true;
+    }
+}
+
+// Sendewarteschlange wie orobi_txqueue.h, ohne Allokation nach dem Konstruktor:
+//   Steuerung (INT, MOTORDATA mit Bremse): strikte Priorität, FIFO
+//   MOTORDATA: latest value wins, nur der neueste noch nicht gesendete Wert bleibt erhalten
+//   USER: Bulk, FIFO, nur mit dem Platz, den die anderen Klassen übrig lassen
+// Kommandos mit abgelaufener Frist werden beim Füllen verworfen statt verspätet gesendet.
+public sealed class OrobiTxQueue
+{
+    public const uint DefaultMotorTtlMs = 100;
+    public const uint NoDeadline = uint.MaxValue;
+    private const byte BrakeButton = 0x01;
+    private const int ControlSlots = 16;
+    private const int BulkSlots = 8;
+
+    private struct Entry
+    {
+        public bool IsMotor;
+        public uint Value;
+        public ushort Speed;
+        public ushort Rotation;
+        public byte Buttons;
+        public uint Deadline;
+        public bool Expires;
+    }
+
+    private readonly Entry[] control = new Entry[ControlSlots];
+    private readonly Entry[] bulk = new Entry[BulkSlots];
+    private readonly byte[][] bulkData = new byte[BulkSlots][];
+    private readonly int[] bulkLength = new int[BulkSlots];
+    private int controlHead, controlCount, bulkHead, bulkCount;
+    private Entry motor;
+    private bool motorPending;
+
+    public OrobiTxQueue()
+    {
+        for (int i = 0; i < BulkSlots; i++)
+        {
+            bulkData[i] = new byte[byte.MaxValue];
+        }
+    }
+
+    // Vorgabe-Fristen in ms, 0: keine
+    public uint ControlTtlMs { get; set; }
+    public uint MotorTtlMs { get; set; } = DefaultMotorTtlMs;
+    public uint BulkTtlMs { get; set; }
+
+    public long Sent { get; private set; }
+    public long Coalesced { get; private set; }    // MOTORDATA durch neueren Wert ersetzt
+    public long Expired { get; private set; }      // Frist abgelaufen, verworfen
+    public long Rejected { get; private set; }     // Klasse voll
+
+    public int Pending => controlCount + (motorPending ? 1 : 0) + bulkCount;
+    // true, wenn Steuerkommandos warten: sofort senden
+    public bool Urgent => controlCount > 0;
+
+    // buttons wie OrobiBatchWriter.TryAddMotor; ttlMs 0: Vorgabe der Klasse, NoDeadline: keine Frist.
+    // Eine Bremse geht über die Steuerklasse und verwirft den wartenden Sollwert.
+    public bool EnqueueMotor(ushort speed, ushort rotation, byte buttons, uint nowMs, uint ttlMs = 0)
+    {
+        var entry = new Entry { IsMotor = true, Speed = speed, Rotation = rotation, Buttons = buttons };
+        if ((buttons & BrakeButton) != 0)
+        {
+            if (!EnqueueControl(entry, nowMs, ttlMs))
+            {
+                return false;
+            }
+            if (motorPending)
+            {
+                motorPending = false;
+                Coalesced++;
+            }
+            return true;
+        }
+
+        Stamp(ref entry, nowMs, ttlMs == 0 ? MotorTtlMs : ttlMs);
+        if (motorPending)
+        {
+            Coalesced++;
+        }
+        motor = entry;
+        motorPending = true;
+        return true;
+    }
+
+    public bool EnqueueInt(uint value, uint nowMs, uint ttlMs = 0)
+    {
+        return EnqueueControl(new Entry { Value = value }, nowMs, ttlMs);
+    }
+
+    public bool EnqueueUser(ReadOnlySpan<byte> data, uint nowMs, uint ttlMs = 0)
+    {
+        if (data.Length > byte.MaxValue || bulkCount == BulkSlots)
+        {
+            Rejected++;
+            return false;
+        }
+        int slot = (bulkHead + bulkCount) % BulkSlots;
+        var entry = new Entry();
+        Stamp(ref entry, nowMs, ttlMs == 0 ? BulkTtlMs : ttlMs);
+        bulk[slot] = entry;
+        data.CopyTo(bulkData[slot]);
+        bulkLength[slot] = data.Length;
+        bulkCount++;
+        return true;
+    }
+
+    // Steuerung, dann MOTORDATA, dann USER; unmittelbar vor dem Versiegeln aufrufen.
+    // false: Batch voll, es warten noch Kommandos (senden, dann erneut aufrufen).
+    public bool Fill(ref OrobiBatchWriter batch, uint nowMs)
+    {
+        while (controlCount > 0)
+        {
+            ref Entry entry = ref control[controlHead];
+            if (IsExpired(entry, nowMs))
+            {
+                Expired++;
+            }
+            else if (!(entry.IsMotor ? batch.TryAddMotor(entry.Speed, entry.Rotation, entry.Buttons)
+                                     : batch.TryAddInt(entry.Value)))
+            {
+                return false;
+            }
+            else
+            {
+                Sent++;
+            }
+            controlHead = (controlHead + 1) % ControlSlots;
+            controlCount--;
+        }
+
+        if (motorPending)
+        {
+            if (IsExpired(motor, nowMs))
+            {
+                Expired++;
+            }
+            else if (!batch.TryAddMotor(motor.Speed, motor.Rotation, motor.Buttons))
+            {
+                return false;
+            }
+            else
+            {
+                Sent++;
+            }
+            motorPending = false;
+        }
+
+        while (bulkCount > 0)
+        {
+            if (IsExpired(bulk[bulkHead], nowMs))
+            {
+                Expired++;
+            }
+            else if (!batch.TryAddUser(bulkData[bulkHead].AsSpan(0, bulkLength[bulkHead])))
+            {
+                return false;
+            }
+            else
+            {
+                Sent++;
+            }
+            bulkHead = (bulkHead + 1) % BulkSlots;
+            bulkCount--;
+        }
+        return true;
+    }
+
+    private bool EnqueueControl(Entry entry, uint nowMs, uint ttlMs)
+    {
+        if (controlCount == ControlSlots)
+        {
+            Rejected++;
+            return false;
+        }
+        Stamp(ref entry, nowMs, ttlMs == 0 ? ControlTtlMs : ttlMs);
+        control[(controlHead + controlCount) % ControlSlots] = entry;
+        controlCount++;
+        return true;
+    }
+
+    private static void Stamp(ref Entry entry, uint nowMs, uint ttlMs)
+    {
+        entry.Expires = ttlMs != 0 && ttlMs != NoDeadline;
+        entry.Deadline = unchecked(nowMs + ttlMs);
+    }
+
+    private static bool IsExpired(in Entry entry, uint nowMs)
+    {
+        return entry.Expires && unchecked((int)(nowMs - entry.Deadline)) > 0;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef __LIBOPENROBI_BATCH_H__
+#define __LIBOPENROBI_BATCH_H__
+
+#include "orobi_command.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mehrere Kommandos in einer Nachricht: ein Paket (eine Nonce, ein Box-Aufruf, ein Hash) pro Batch.
+// Eintrag: type u8 | len u8 | Daten (little-endian)
+//   MOTORDATA: speed u16 | rotation u16 | buttons u8 (Bit 0-3)                          5 Bytes
+//   STARTDATA: wifi_ssid[16] | wifi_passwd[16] | rw_port u8 | key_station 2 x u32 | api_key u16   43 Bytes
+//   INT / FLOAT: u32 (float als IEEE-754 Bitmuster)                                      4 Bytes
+//   STRING: Zeichen ohne Null-Terminator                                              0-15 Bytes
+//   USER: beliebige Bytes (der Zeiger orobi_command_t.packet wird nicht übertragen)  0-255 Bytes
+// hash und lowWord der einzelnen Kommandos entfallen, das Paket ist als Ganzes authentifiziert.
+#define OROBI_BATCH_ENTRY_HEADER        2
+#define OROBI_BATCH_MAX_ENTRY           255
+#define OROBI_BATCH_CAPACITY            OROBI_MAXMESSAGESIZE
+
+typedef struct {
+    uint8_t         buffer[OROBI_BATCH_CAPACITY];
+    uint16_t        size;
+    uint16_t        count;
+    uint16_t        flush_size;     // ab dieser Größe ist der Batch fällig
+    uint32_t        max_delay;      // ms nach dem ersten Kommando ist der Batch fällig
+    uint32_t        opened;         // Zeit (ms) des ersten Kommandos
+} orobi_batch_t;
+
+// Liest einen empfangenen Batch ohne Kopie; user-Daten zeigen in die Nachricht
+typedef struct {
+    const uint8_t*  data;
+    size_t          size;
+    size_t          pos;
+    uint16_t        index;
+} orobi_batch_reader_t;
+
+// flush_size == 0 oder > OROBI_BATCH_CAPACITY: nur volle Batches sind größenbedingt fällig
+void          orobi_batch_init(orobi_batch_t* batch, uint16_t flush_size, uint32_t max_delay_ms);
+void          orobi_batch_reset(orobi_batch_t* batch);
+// Hängt ein Kommando an. OROBI_ERROR_COMMAND_OVERFLOW: kein Platz mehr, erst senden (orobi_batch_seal).
+// OROBI_COMMAND_USER geht nur über orobi_batch_add_user.
+orobi_error_t orobi_batch_add(orobi_batch_t* batch, const orobi_command_t* command, uint32_t now_ms);
+orobi_error_t orobi_batch_add_user(orobi_batch_t* batch, const void* data, uint8_t size, uint32_t now_ms);
+// true, wenn der Batch wegen Größe oder Wartezeit gesendet werden soll
+bool          orobi_batch_due(const orobi_batch_t* batch, uint32_t now_ms);
+// Sendet den Batch über orobi_netpacket_seal und leert ihn danach (nur bei Erfolg)
+orobi_error_t orobi_batch_seal(orobi_secure_t* ctx, orobi_lz_work_t* work, orobi_packet_t* packet, orobi_batch_t* batch,
+                               uint8_t seq_nr, uint16_t api_key, const unsigned char* their_public_key,
+                               void* buffer, size_t buffer_size, size_t* written);
+
+orobi_error_t orobi_batch_reader_init(orobi_batch_reader_t* reader, const void* message, size_t size);
+// Nächstes Kommando mit eigenem Status:
+//   OK: command gültig (bei USER: user_data/user_size gesetzt, command->packet zeigt auf user_data)
+//   INVALID_COMMAND: Eintrag ungültig und übersprungen, die folgenden Einträge bleiben lesbar
+//   ERROR: Rahmen defekt, der Rest des Batches ist nicht lesbar
+//   NODATA: Ende des Batches
+orobi_command_status_t orobi_batch_next(orobi_batch_reader_t* reader, orobi_command_t* command,
+                                        const uint8_t** user_data, uint8_t* user_size);
+// Dekodiert bis zu max Kommandos mit Status pro Kommando; count = Anzahl der Einträge.
+// OROBI_ERROR_COMMAND_OVERFLOW, wenn der Batch mehr als max Einträge hat.
+orobi_error_t orobi_batch_unpack(const void* message, size_t size, orobi_command_t* commands,
+                                 orobi_command_status_t* status, size_t max, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_BATCH_H__
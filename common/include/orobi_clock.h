@@ -0,0 +1,97 @@
+#ifndef __LIBOPENROBI_CLOCK_H__
+#define __LIBOPENROBI_CLOCK_H__
+
+#include "orobi_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Gemeinsame Sitzungsuhr in Millisekunden über den bestehenden Link (NTP-artig).
+// Die Bodenstation ist Master: ihre Sitzungszeit ist ihre monotone lokale Uhr. Der Roboter schätzt den
+// Offset zum Master aus Anfrage/Antwort-Paaren:
+//   REQUEST:  OROBI_CLOCK_REQUEST_MARKER u8 | t1 u32                     t1: lokale Sendezeit des Clients
+//   RESPONSE: OROBI_CLOCK_RESPONSE_MARKER u8 | t1 u32 | t2 u32 | t3 u32  t2/t3: Empfang/Antwort beim Master
+// Mit t4 = lokaler Empfang: offset = ((t2 - t1) + (t3 - t4)) / 2, rtt = (t4 - t1) - (t3 - t2).
+// Von den letzten OROBI_CLOCK_SAMPLES Messungen gilt die mit der kleinsten RTT (Clock-Filter wie NTP).
+// Korrekturen werden mit höchstens 1 ms je OROBI_CLOCK_SLEW_DIV ms eingeschwenkt, die Sitzungszeit läuft
+// dadurch monoton weiter; nur die erste Messung und Sprünge > OROBI_CLOCK_STEP_MS (Neustart des Masters)
+// setzen sie direkt. Alle Zeiten sind uint32_t ms und werden über den Umlauf hinweg verglichen.
+// Nicht threadsicher; ein Master wird nach orobi_clock_init nur noch gelesen.
+#define OROBI_CLOCK_REQUEST_MARKER      0xF4
+#define OROBI_CLOCK_RESPONSE_MARKER     0xF5
+#define OROBI_CLOCK_REQUEST_SIZE        5
+#define OROBI_CLOCK_RESPONSE_SIZE       13
+#define OROBI_CLOCK_SAMPLES             8
+#define OROBI_CLOCK_POLL_FAST_MS        100     // Abstand der Anfragen, bis der Filter gefüllt ist
+#define OROBI_CLOCK_POLL_MS             2000
+#define OROBI_CLOCK_TIMEOUT_MS          1000    // unbeantwortete Anfrage gilt danach als verloren
+#define OROBI_CLOCK_MAX_RTT_MS          1000    // Messungen mit größerer RTT werden verworfen
+#define OROBI_CLOCK_SLEW_DIV            20      // Korrektur höchstens 1 ms je 20 ms lokaler Zeit
+#define OROBI_CLOCK_STEP_MS             500
+#define OROBI_CLOCK_DRIFT_PPM           100     // angenommene Gangabweichung der Quarze für error_ms
+#define OROBI_CLOCK_HOLDOVER_MS         60000   // ohne Messung gilt die Uhr danach als nicht synchron
+
+// Lokale monotone Uhr in ms (ESP32: esp_timer, sonst CLOCK_MONOTONIC), überschreibbar
+#ifndef OROBI_CLOCK_LOCAL_MS
+#define OROBI_CLOCK_LOCAL_MS()          orobi_clock_local_ms()
+#endif
+
+// Synchronisationsgüte aus Sicht der lokalen Uhr
+typedef struct {
+    bool        synced;
+    uint32_t    offset_ms;      // Sitzungszeit - lokale Zeit (mod 2^32)
+    uint32_t    rtt_ms;         // RTT der gewählten Messung
+    uint32_t    jitter_ms;      // mittlere Abweichung der Offsets im Filter von der gewählten Messung
+    uint32_t    error_ms;       // Fehlerschranke: rtt/2 + jitter + noch einzuschwenken + Drift seit der Messung
+    uint32_t    age_ms;         // seit der letzten gültigen Messung
+    uint32_t    samples;        // gültige Messungen insgesamt
+    uint32_t    rejected;       // Antworten ohne offene Anfrage, mit fremdem t1 oder zu großer RTT
+} orobi_clock_quality_t;
+
+typedef struct {
+    bool        master;
+    bool        synced;
+    uint32_t    base_offset;    // angewendeter Offset zur lokalen Zeit adjust_local
+    uint32_t    target_offset;  // Offset der gewählten Messung, wird eingeschwenkt
+    uint32_t    adjust_local;
+    bool        pending;        // Anfrage unterwegs
+    uint32_t    pending_t1;
+    uint32_t    next_poll;      // lokale Zeit der nächsten Anfrage
+    uint32_t    last_sample;    // lokale Zeit der letzten gültigen Messung
+    uint32_t    offset[OROBI_CLOCK_SAMPLES];
+    uint32_t    rtt[OROBI_CLOCK_SAMPLES];
+    uint8_t     count;
+    uint8_t     head;
+    uint32_t    samples;
+    uint32_t    rejected;
+} orobi_clock_t;
+
+uint32_t      orobi_clock_local_ms(void);
+// master: Sitzungszeit = lokale Zeit, immer synchron. Client: bis zur ersten Messung lokale Zeit, nicht synchron.
+void          orobi_clock_init(orobi_clock_t* clock, bool master);
+// Sitzungszeit zu einer lokalen Zeit (z.B. Empfangszeitpunkt); monoton in local_ms
+uint32_t      orobi_clock_session_ms(const orobi_clock_t* clock, uint32_t local_ms);
+uint32_t      orobi_clock_now(const orobi_clock_t* clock);
+bool          orobi_clock_synced(const orobi_clock_t* clock, uint32_t local_ms);
+// Fehlerschranke der Sitzungszeit in ms (Master: 0, nicht synchron: UINT32_MAX)
+uint32_t      orobi_clock_error_ms(const orobi_clock_t* clock, uint32_t local_ms);
+
+// Client: true, wenn eine Anfrage gesendet werden soll (keine offen bzw. verloren, Intervall erreicht)
+bool          orobi_clock_request_due(const orobi_clock_t* clock, uint32_t local_ms);
+// Client: schreibt die Anfrage (OROBI_CLOCK_REQUEST_SIZE Bytes) und merkt sich t1 = local_ms
+orobi_error_t orobi_clock_request_write(orobi_clock_t* clock, uint32_t local_ms,
+                                        void* buffer, size_t capacity, size_t* written);
+// Master (oder synchroner Client): beantwortet eine Anfrage. rx_local_ms: Empfangszeit der Anfrage.
+// OROBI_ERROR_INVALID_INPUT: keine Anfrage. OROBI_ERROR_TIME_SYNC: selbst nicht synchron.
+orobi_error_t orobi_clock_respond(const orobi_clock_t* clock, const void* request, size_t size, uint32_t rx_local_ms,
+                                  void* buffer, size_t capacity, size_t* written);
+// Client: verarbeitet eine Antwort, rx_local_ms = t4. OROBI_ERROR_TIME_SYNC: verworfen (in rejected gezählt).
+orobi_error_t orobi_clock_response(orobi_clock_t* clock, const void* message, size_t size, uint32_t rx_local_ms);
+void          orobi_clock_get_quality(const orobi_clock_t* clock, uint32_t local_ms, orobi_clock_quality_t* quality);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_CLOCK_H__
@@ -2,6 +2,8 @@
 #define __LIBOPENROBI_COMMAND_H__
 
 #include "orobi_common.h"
+#include "orobi_packet.h"
+#include "orobi_compress.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,16 +63,60 @@ typedef struct orobi_network_packet {        // ESP32 <-> PC
         void*             raw_packet;
         orobi_command_t*  packet; // <--- To Mega
     };
-    char        compressed : 1;
+    bool        compressed : 1;
     uint32_t    compress_size;        
     uint32_t    hash;            // Key muss in esp32 programm und PC gleich sein
 } orobi_netpacket_t;
 
+// Wire-Format eines Netzwerkpakets (little-endian), Nutzlast ist i.d.R. ein orobi_encode_packet:
+//   seq_nr u8 | flags u8 (Bit 0: compressed) | api_key u16 | payload_size u16 | compress_size u32 | hash u32 | payload
+// hash schützt nur vor Übertragungsfehlern. seal/open binden seq_nr, flags, api_key und compress_size als
+// bound an das verschlüsselte Paket (orobi_create_packet_bound), ein veränderter Header scheitert beim Öffnen.
+#define OROBI_NETPACKET_HEADER_SIZE     14
+#define OROBI_NETPACKET_MAXPAYLOAD      OROBI_WIRE_MAXSIZE
+#define OROBI_NETPACKET_MAXSIZE         (OROBI_NETPACKET_HEADER_SIZE + OROBI_NETPACKET_MAXPAYLOAD)
+#define OROBI_NETPACKET_FLAG_COMPRESSED 0x01
+#ifndef OROBI_NETPACKET_HASH_KEY
+#define OROBI_NETPACKET_HASH_KEY        OROBI_MURMUR_SEED  // Muss in esp32 und PC gleich sein
+#endif
+// Nutzlast direkt im Sendepuffer aufbauen, dann orobi_netpacket_serialize
+#define OROBI_NETPACKET_PAYLOAD(buffer) ((uint8_t*)(buffer) + OROBI_NETPACKET_HEADER_SIZE)
+
+// Sicht auf ein empfangenes Paket; payload zeigt in den Puffer des Aufrufers (keine Kopie)
+typedef struct {
+    uint8_t         seq_nr;
+    uint16_t        api_key;
+    bool            compressed;
+    uint32_t        compress_size;   // Größe nach Dekompression, 0 wenn nicht komprimiert
+    uint32_t        hash;
+    const uint8_t*  payload;
+    uint16_t        payload_size;
+    uint32_t        timestamp_ms;    // Sitzungszeit des Absenders (0: nicht synchron), nur nach orobi_netpacket_open
+} orobi_netpacket_view_t;
+
 // Funktion zum Überprüfen der Kommandos
 orobi_error_t orobi_command_validate(const orobi_command_t* command);
 
+// Prüft ein empfangenes Datagramm in-place (Grenzen, Flags, Hash); out->raw_packet zeigt in data.
+// out->compress_size ist bei komprimierten Paketen die Größe nach Dekompression, sonst die Nutzlastgröße.
 orobi_error_t orobi_netpacket_parse(void* data, size_t size, orobi_netpacket_t* out);
 orobi_error_t orobi_netpacket_validate(const orobi_netpacket_t* net);
+orobi_error_t orobi_netpacket_parse_view(const void* data, size_t size, orobi_netpacket_view_t* view);
+// Schreibt Header und Nutzlast nach buffer; liegt payload bereits bei OROBI_NETPACKET_PAYLOAD(buffer), wird nicht kopiert
+orobi_error_t orobi_netpacket_serialize(const orobi_netpacket_view_t* view, void* buffer, size_t buffer_size, size_t* written);
+
+// Versandpfad: Nachricht komprimieren (nur wenn es Bytes spart, work == NULL: nie), mit orobi_create_packet und
+// orobi_encode_packet verschlüsseln und als Netzwerkpaket nach buffer schreiben. packet ist Arbeitsspeicher.
+orobi_error_t orobi_netpacket_seal(orobi_secure_t* ctx, orobi_lz_work_t* work, orobi_packet_t* packet,
+                                   uint8_t seq_nr, uint16_t api_key, const void* message, uint16_t size,
+                                   const unsigned char* their_public_key,
+                                   void* buffer, size_t buffer_size, size_t* written);
+// Empfangspfad: parsen, entschlüsseln und ggf. dekomprimieren. *message zeigt auf packet->message oder,
+// bei komprimierten Paketen, auf inflate_buffer (mind. compress_size Bytes).
+orobi_error_t orobi_netpacket_open(orobi_secure_t* ctx, const void* data, size_t size,
+                                   const unsigned char* their_public_key, orobi_packet_t* packet,
+                                   uint8_t* inflate_buffer, size_t inflate_size, orobi_netpacket_view_t* view,
+                                   const uint8_t** message, size_t* message_size);
 
 #ifdef __cplusplus
 }
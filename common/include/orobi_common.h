@@ -1,6 +1,10 @@
 #ifndef __LIBOROBI_COMMON_H__
 #define __LIBOROBI_COMMON_H__
 
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
 typedef enum {
     OROBI_OK = 0,
     OROBI_ERROR_INVALID_INPUT = -1,
@@ -22,6 +26,9 @@ typedef enum {
     OROBI_ERROR_UNSUPPORTED_COMMAND = -17
 } orobi_error_t;
 
+// Anzahl der Codes inkl. OROBI_OK, für Zähler-Arrays mit Index -status. Bei neuen Codes anpassen.
+#define OROBI_ERROR_COUNT 18
+
 
 typedef union {
     struct {
@@ -31,5 +38,32 @@ typedef union {
     uint64_t    key[2];
 } uint128_t;
 
+// Little-Endian Hilfsfunktionen für das Wire-Format (ESP32 <-> PC)
+static inline void orobi_write_le16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void orobi_write_le32(uint8_t* p, uint32_t v) {
+    orobi_write_le16(p, (uint16_t)v);
+    orobi_write_le16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline void orobi_write_le64(uint8_t* p, uint64_t v) {
+    orobi_write_le32(p, (uint32_t)v);
+    orobi_write_le32(p + 4, (uint32_t)(v >> 32));
+}
+
+static inline uint16_t orobi_read_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static inline uint32_t orobi_read_le32(const uint8_t* p) {
+    return (uint32_t)orobi_read_le16(p) | ((uint32_t)orobi_read_le16(p + 2) << 16);
+}
+
+static inline uint64_t orobi_read_le64(const uint8_t* p) {
+    return (uint64_t)orobi_read_le32(p) | ((uint64_t)orobi_read_le32(p + 4) << 32);
+}
 
 #endif
@@ -0,0 +1,55 @@
+#ifndef __LIBOPENROBI_COMPRESS_H__
+#define __LIBOPENROBI_COMPRESS_H__
+
+#include "orobi_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Kleiner LZ77-Codec (LZ4-artiges Blockformat), ohne Heap-Allokation.
+// Sequenz: token u8 (Literal-Länge << 4 | Match-Länge - 4) | Längen-Erweiterung | Literale | offset u16 | Längen-Erweiterung
+// Die letzte Sequenz hat keinen Match; das Ende ergibt sich aus der bekannten Originalgröße.
+#ifndef OROBI_LZ_HASH_BITS
+#ifdef ESP32
+#define OROBI_LZ_HASH_BITS      10      // 2 KB Arbeitsspeicher
+#else
+#define OROBI_LZ_HASH_BITS      12      // 8 KB Arbeitsspeicher
+#endif
+#endif
+#define OROBI_LZ_MIN_MATCH      4
+#define OROBI_LZ_MAX_INPUT      0xFFFF
+#define OROBI_LZ_MIN_INPUT      32      // kleinere Nachrichten werden nicht komprimiert
+
+// Arbeitsspeicher des Kompressors (Hash-Tabelle), vom Aufrufer bereitgestellt
+typedef struct {
+    uint16_t        table[1 << OROBI_LZ_HASH_BITS];
+} orobi_lz_work_t;
+
+// Streaming-Dekompressor: Eingabe in beliebigen Stücken, Ausgabe in einen Puffer der Originalgröße
+typedef struct {
+    uint8_t*        out;
+    size_t          out_size;
+    size_t          out_pos;
+    size_t          literal_left;
+    size_t          match_len;
+    uint16_t        offset;
+    uint8_t         state;
+} orobi_lz_decoder_t;
+
+// Komprimiert src nach dst. OROBI_ERROR_BUFFER_OVERFLOW, wenn das Ergebnis nicht in dst_size passt
+// (mit dst_size = size - 1 also: Komprimierung spart nichts).
+orobi_error_t   orobi_lz_compress(orobi_lz_work_t* work, const void* src, size_t size,
+                                  void* dst, size_t dst_size, size_t* written);
+// Dekomprimiert einen vollständigen Block; original_size muss exakt stimmen
+orobi_error_t   orobi_lz_decompress(const void* src, size_t size, void* dst, size_t original_size);
+
+void            orobi_lz_decoder_init(orobi_lz_decoder_t* dec, void* out, size_t original_size);
+orobi_error_t   orobi_lz_decoder_update(orobi_lz_decoder_t* dec, const void* data, size_t size);
+bool            orobi_lz_decoder_done(const orobi_lz_decoder_t* dec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_COMPRESS_H__
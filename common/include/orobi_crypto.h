@@ -0,0 +1,44 @@
+#ifndef __LIBOPENROBI_CRYPTO_H__
+#define __LIBOPENROBI_CRYPTO_H__
+
+#include "orobi_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Austauschbares Backend für crypto_box_afternm / crypto_box_open_afternm (XSalsa20-Poly1305).
+// Alle Backends erzeugen byte-identische Ausgaben, das Wire-Format hängt nicht von der Wahl ab.
+typedef enum {
+    OROBI_CRYPTO_NACL   = 0,     // tweetnacl, Referenz
+    OROBI_CRYPTO_NATIVE = 1      // In-Tree Salsa20/Poly1305: x86-64 AVX2 bzw. SSE2 (8 Blöcke parallel),
+                                 // ESP32 skalar mit 32-Bit-Arithmetik
+} orobi_crypto_backend_t;
+
+// Backend beim ersten Aufruf (überschreibbar zur Compile-Zeit). Scheitert der Selbsttest, gilt OROBI_CRYPTO_NACL.
+#ifndef OROBI_CRYPTO_DEFAULT
+#define OROBI_CRYPTO_DEFAULT     OROBI_CRYPTO_NATIVE
+#endif
+
+// Aufrufkonvention wie NaCl: m beginnt mit crypto_box_ZEROBYTES Nullbytes, c mit crypto_box_BOXZEROBYTES.
+// Rückgabe 0 bei Erfolg, -1 bei falscher Länge bzw. ungültigem Authenticator.
+int orobi_crypto_box_afternm(unsigned char* c, const unsigned char* m, unsigned long long mlen,
+                             const unsigned char* n, const unsigned char* k);
+int orobi_crypto_box_open_afternm(unsigned char* m, const unsigned char* c, unsigned long long clen,
+                                  const unsigned char* n, const unsigned char* k);
+
+// Wechselt das Backend, nach bestandenem Selbsttest. Nicht während laufender Ver-/Entschlüsselung aufrufen.
+// Auch die erste Auswahl ist nicht threadsicher: vor dem Start weiterer Threads orobi_crypto_get_backend aufrufen.
+orobi_error_t          orobi_crypto_set_backend(orobi_crypto_backend_t backend);
+orobi_crypto_backend_t orobi_crypto_get_backend(void);
+// Name der aktiven Implementierung, z.B. "native-avx2"
+const char*            orobi_crypto_backend_name(void);
+// Bekannte Testvektoren (Referenzausgabe von NaCl), Roundtrip und Ablehnung manipulierter Boxen.
+// OROBI_ERROR_CRYPTOGRAPHIC_FAILURE bei Abweichung, OROBI_ERROR_INVALID_CONFIGURATION bei unbekanntem Backend.
+orobi_error_t          orobi_crypto_self_test(orobi_crypto_backend_t backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_CRYPTO_H__
@@ -0,0 +1,52 @@
+#ifndef __LIBOPENROBI_INTEROP_H__
+#define __LIBOPENROBI_INTEROP_H__
+
+#include "orobi_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Einstiegspunkte für Bindings (C# P/Invoke): opaker Kontext, Puffer nur als Zeiger + Länge.
+// Kein Struct wird marshalled; der Aufrufer übergibt gepinnte bzw. gepoolte Puffer, pro Paket
+// wird weder hier noch auf der verwalteten Seite Speicher allokiert.
+// Ein Kontext gehört einem Thread, mehrere Kontexte sind unabhängig.
+typedef struct orobi_interop orobi_interop_t;
+
+#define OROBI_INTEROP_KEYBYTES    32      // crypto_box_PUBLICKEYBYTES / SECRETKEYBYTES
+
+// Legt Kontext, Arbeitsspeicher und Schlüssel an; *handle == NULL bei Fehler
+orobi_error_t orobi_interop_create(orobi_interop_t** handle, uint64_t id_high, uint64_t id_low,
+                                   const uint8_t* public_key, const uint8_t* secret_key);
+// Löscht Schlüssel und gibt alles frei (NULL erlaubt)
+void          orobi_interop_destroy(orobi_interop_t* handle);
+
+// Nachricht -> Netzwerkpaket (orobi_netpacket_seal, mit Kompression). buffer_size >= orobi_interop_max_packet_size()
+// reicht immer. message darf bei size == 0 NULL sein.
+orobi_error_t orobi_interop_seal(orobi_interop_t* handle, const uint8_t* their_public_key,
+                                 uint8_t seq_nr, uint16_t api_key, const uint8_t* message, int32_t size,
+                                 uint8_t* buffer, int32_t buffer_size, int32_t* written);
+// Netzwerkpaket -> Nachricht (orobi_netpacket_open), kopiert nach message. api_key und seq_nr dürfen NULL sein.
+orobi_error_t orobi_interop_open(orobi_interop_t* handle, const uint8_t* their_public_key,
+                                 const uint8_t* data, int32_t size, uint8_t* message, int32_t message_capacity,
+                                 int32_t* message_size, uint16_t* api_key, uint8_t* seq_nr);
+
+// Sitzungsuhr (orobi_clock.h): der Kontext ist Master, Pakete mit zu altem Zeitstempel weist open ab.
+// Beantwortet eine mit orobi_interop_open empfangene Uhrabgleich-Anfrage (erstes Byte 0xF4); t2 ist der
+// Zeitpunkt dieses open. Die Antwort (OROBI_CLOCK_RESPONSE_SIZE Bytes) mit orobi_interop_seal zurücksenden.
+// OROBI_ERROR_INVALID_INPUT: keine Anfrage.
+orobi_error_t orobi_interop_clock_reply(orobi_interop_t* handle, const uint8_t* request, int32_t size,
+                                        uint8_t* buffer, int32_t buffer_size, int32_t* written);
+// Sitzungszeit in ms, gemeinsam mit synchronisierten Robotern (z.B. Alter von Telemetrie-Frames)
+uint32_t      orobi_interop_now_ms(orobi_interop_t* handle);
+
+// Text zum letzten Fehler des Kontexts (UTF-8, gültig bis zum nächsten Aufruf mit handle)
+const char*   orobi_interop_last_error(orobi_interop_t* handle);
+int32_t       orobi_interop_max_packet_size(void);
+int32_t       orobi_interop_max_message_size(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_INTEROP_H__
@@ -0,0 +1,63 @@
+#ifndef __LIBOPENROBI_MOTOR_H__
+#define __LIBOPENROBI_MOTOR_H__
+
+#include "orobi_command.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Kompakter Codec für orobi_motordata_t-Ströme (Joystick, 50-100 Hz).
+//   flags u8 (Bit 7: Keyframe, Bit 6: speed, Bit 5: rotation, Bit 0-3: buttons) | seq u8
+//   Keyframe: speed u16 | rotation u16
+//   Delta:    ref_seq u8 | [speed zigzag-varint] | [rotation zigzag-varint]   (Differenz zum bestätigten Frame ref_seq)
+// Unveränderte Werte kosten 3 Bytes, kleine Änderungen 4-5 Bytes, ein Keyframe 6 Bytes.
+// Nur Bibliothek: das Kommando-Format (orobi_batch, orobi_txqueue, Pipeline) überträgt MOTORDATA weiter mit
+// 5 Bytes; eigene Motor-Ströme können den Codec z.B. in USER-Kommandos verwenden.
+#define OROBI_MOTOR_HISTORY             16      // Frames, auf die ein Delta verweisen darf
+#define OROBI_MOTOR_KEYFRAME_INTERVAL   50      // spätestens nach so vielen Frames ein Keyframe
+#define OROBI_MOTOR_MAXFRAME            9
+
+#define OROBI_MOTOR_FLAG_KEYFRAME       0x80
+#define OROBI_MOTOR_FLAG_SPEED          0x40
+#define OROBI_MOTOR_FLAG_ROTATION       0x20
+#define OROBI_MOTOR_BUTTON_MASK         0x0F
+
+typedef struct {
+    orobi_motordata_t   history[OROBI_MOTOR_HISTORY];   // gesendete Frames, Index seq % OROBI_MOTOR_HISTORY
+    orobi_motordata_t   reference;                      // zuletzt bestätigter Frame
+    uint8_t             reference_seq;
+    bool                has_reference;
+    uint8_t             seq;                            // seq des nächsten Frames
+    uint8_t             since_keyframe;
+} orobi_motor_encoder_t;
+
+typedef struct {
+    orobi_motordata_t   history[OROBI_MOTOR_HISTORY];   // dekodierte Frames
+    uint8_t             history_seq[OROBI_MOTOR_HISTORY];
+    bool                history_valid[OROBI_MOTOR_HISTORY];
+    uint8_t             last_seq;
+    bool                has_last;
+} orobi_motor_decoder_t;
+
+void          orobi_motor_encoder_init(orobi_motor_encoder_t* enc);
+orobi_error_t orobi_motor_encode(orobi_motor_encoder_t* enc, const orobi_motordata_t* frame,
+                                 uint8_t* out, size_t out_size, size_t* written);
+// Bestätigung der Gegenstelle: künftige Deltas beziehen sich auf diesen Frame
+void          orobi_motor_ack(orobi_motor_encoder_t* enc, uint8_t seq);
+// Verlust erkannt (Timeout, Fehlermeldung der Gegenstelle): der nächste Frame ist ein Keyframe
+void          orobi_motor_loss(orobi_motor_encoder_t* enc);
+
+void          orobi_motor_decoder_init(orobi_motor_decoder_t* dec);
+// Dekodiert einen Frame; seq sollte bestätigt werden (orobi_motor_ack beim Sender).
+// Ein Keyframe wird immer angenommen und setzt den Decoder neu auf, auch nach einem Verbindungsabbruch.
+// OROBI_ERROR_PACKET_TOO_OLD: überholtes Delta, OROBI_ERROR_PACKET_VALIDATION_FAILED: Referenz fehlt
+// (Sender muss mit orobi_motor_loss einen Keyframe schicken).
+orobi_error_t orobi_motor_decode(orobi_motor_decoder_t* dec, const uint8_t* data, size_t size,
+                                 orobi_motordata_t* frame, uint8_t* seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_MOTOR_H__
@@ -7,23 +7,52 @@
 #include <time.h>
 #include "tweetnacl.h"
 #include "orobi_common.h"
+#include "orobi_random.h"
+#include "orobi_clock.h"
 
 #define OROBI_MAXMESSAGESIZE              4096
 #define OROBI_MURMUR_SEED                 42
-#define OROBI_MAX_PACKET_AGE_SEC          30  // Maximales Alter eines Pakets
+#define OROBI_MAX_PACKET_AGE_MS           100 // Maximales Alter eines Pakets in Sitzungszeit (orobi_secure_set_clock)
 #define OROBI_NONCE_COUNTER_THRESHOLD     0xFFFFFFFF  // Schwelle für Nonce-Reset
 #define OROBI_ERROR_BUFFER_SIZE           128
+#define OROBI_PEER_CACHE_SIZE             8   // Anzahl gecachter Shared-Keys pro Kontext
+#define OROBI_PEER_RETIRED_PREFIXES       4   // abgelöste Nonce-Präfixe pro Gegenstelle, bleiben gesperrt
+#define OROBI_REPLAY_WINDOW_MIN           64
+#define OROBI_REPLAY_WINDOW_MAX           1024
+#define OROBI_REPLAY_WINDOW_DEFAULT       256 // Anti-Replay-Fenster in Nonce-Countern
+#define OROBI_NONCE_PREFIX_SIZE           (crypto_box_NONCEBYTES - 8)  // Zufallsteil der Nonce, fest pro Sitzung
+
+// Sitzungstickets (orobi_secure_session_*): Counter-Vorrat pro Schreibvorgang in den Flash.
+// Bei 100 Paketen/s wird etwa alle 80 s geschrieben.
+#define OROBI_SESSION_VERSION             1
+#define OROBI_SESSION_TX_LEASE            16384   // gesendete Counter pro Ticket
+#define OROBI_SESSION_RX_LEASE            16384   // empfangene Counter pro Ticket; so viele überspringt die Gegenstelle
+
+// Kompaktes Wire-Format: Header + nur message_size Bytes Nutzdaten
+#define OROBI_WIRE_VERSION                3   // 2: Zeitstempel in ms Sitzungszeit statt time(NULL), 3: bound im packet_hash
+#define OROBI_WIRE_HEADER_SIZE            (4 + 8 + crypto_box_NONCEBYTES)   // version, hash_algo, size, crypt_hash, nonce
+#define OROBI_WIRE_INNER_SIZE             24                                // api_key, packet_hash, timestamp
+#define OROBI_WIRE_MACBYTES               (crypto_box_ZEROBYTES - crypto_box_BOXZEROBYTES)
+#define OROBI_WIRE_SIZE(n)                (OROBI_WIRE_HEADER_SIZE + OROBI_WIRE_MACBYTES + OROBI_WIRE_INNER_SIZE + (n))
+#define OROBI_WIRE_MAXSIZE                OROBI_WIRE_SIZE(OROBI_MAXMESSAGESIZE)
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 
+// Versionierte Hash-Algorithmen für crypt_hash im Wire-Format (Byte 1 des Headers).
+// Die IDs sind Teil des Protokolls und dürfen nicht umnummeriert werden.
+typedef enum {
+    OROBI_HASH_MURMUR3_64   = 0,     // orobi_murmur3_64, eine Spur (Standard, ESP32)
+    OROBI_HASH_MURMUR3_64X4 = 1      // orobi_murmur3_64x4, vier Spuren
+} orobi_hash_algo_t;
+
 // Erweiterter Nonce-Struct mit Zeitstempel und Counter
 typedef struct {
     unsigned char            bytes[crypto_box_NONCEBYTES];
     uint32_t                 counter;
-    time_t                   timestamp;
+    uint32_t                 timestamp_ms;  // Sitzungszeit (orobi_clock.h), 0: Absender nicht synchron
 } orobi_secure_nonce_t;
 
 // Erweitertes Paket mit Zeitstempel und Nonce
@@ -32,36 +61,199 @@ typedef struct {
     uint16_t                 message_size;
     uint64_t                 api_key;        // random_id_low
     uint64_t                 packet_hash;    // Hash aus message + size + api_key
-    time_t                   timestamp;        // Zeitstempel für Replay-Schutz
+    uint32_t                 timestamp_ms;     // Sitzungszeit beim Erstellen, wie in der Nonce
+    uint64_t                 bound;          // außerhalb der Box übertragene Felder (Netzpaket-Header), im packet_hash
     orobi_secure_nonce_t     nonce;    // Nonce für diese Nachricht
 } orobi_packet_t;
 
 typedef struct {
-    unsigned char            encrypted_data[sizeof(packet_t) + crypto_box_ZEROBYTES];
+    unsigned char            encrypted_data[sizeof(orobi_packet_t) + crypto_box_ZEROBYTES];
     uint64_t                 crypt_hash;     // Murmur hash der verschlüsselten Daten
     orobi_secure_nonce_t     nonce;    // Kopie der Nonce für Empfänger
 } orobi_crypt_packet_t;
 
+// Anti-Replay-Fenster (IPsec/DTLS-Stil): Ring-Bitmap über die Nonce-Counter unterhalb von top
+typedef struct {
+    uint32_t              top;            // höchster akzeptierter Counter (0: noch keiner)
+    uint64_t              bitmap[OROBI_REPLAY_WINDOW_MAX / 64 + 1];
+} orobi_replay_window_t;
+
+// Vorberechneter Shared-Key (crypto_box_beforenm) und Replay-Zustand einer Gegenstelle.
+// Das Fenster gilt für session_prefix. Ein neuer authentifizierter Präfix löst ihn nur mit einem frischen
+// Zeitstempel (eigene Uhr synchron) ab; ohne ihn ist er nur Kandidat mit streng steigenden Countern, der
+// laufende Präfix bleibt gültig (ein mitgeschnittenes Paket einer alten Sitzung sperrt ihn nicht).
+// Die letzten OROBI_PEER_RETIRED_PREFIXES abgelösten Präfixe werden abgewiesen.
+typedef struct {
+    unsigned char         public_key[crypto_box_PUBLICKEYBYTES];
+    unsigned char         shared_key[crypto_box_BEFORENMBYTES];
+    orobi_replay_window_t replay;
+    uint32_t              last_used;
+    bool                  valid;
+    bool                  prefix_known;   // false: das Fenster gilt für den ersten empfangenen Präfix
+    uint32_t              synced_counter; // höchster Counter mit Zeitstempel unter session_prefix
+    uint8_t               retired_next;
+    uint32_t              candidate_top;  // höchster Counter unter candidate_prefix (0: kein Kandidat)
+    unsigned char         session_prefix[OROBI_NONCE_PREFIX_SIZE];  // Nonce-Präfix der Gegenstelle
+    unsigned char         candidate_prefix[OROBI_NONCE_PREFIX_SIZE];
+    unsigned char         retired_prefix[OROBI_PEER_RETIRED_PREFIXES][OROBI_NONCE_PREFIX_SIZE];
+} orobi_secure_peer_t;
+
+// Persistierbarer Sitzungszustand gegenüber einer Gegenstelle (Roboter -> Bodenstation).
+// Nach einem Neustart setzt orobi_secure_session_resume die Sitzung ohne Curve25519 fort:
+// gesendete Counter beginnen bei tx_limit, empfangene werden erst oberhalb von rx_limit angenommen.
+// Enthält den Shared-Key im Klartext, Schutz wie für den privaten Schlüssel.
+typedef struct {
+    uint32_t              version;
+    uint32_t              tx_limit;        // alle bisher gesendeten Counter < tx_limit
+    uint32_t              rx_limit;        // alle bisher empfangenen Counter <= rx_limit
+    uint32_t              peer_ip;         // Transport der Gegenstelle (Netzwerk-Byteorder, 0: unbekannt),
+    uint16_t              peer_port;       //  wird von orobi_secure_session_export nicht verändert
+    uint16_t              api_key;
+    unsigned char         peer_public_key[crypto_box_PUBLICKEYBYTES];
+    unsigned char         shared_key[crypto_box_BEFORENMBYTES];
+    uint64_t              check;           // Murmur3 über alle Felder davor, geseedet mit id.high
+} orobi_session_ticket_t;
+
+// Metriken pro Kontext (orobi_secure_get_metrics). Zähler laufen immer mit,
+// Zeitmessung und Histogramm werden mit orobi_secure_set_metrics eingeschaltet.
+#define OROBI_METRICS_TIMING              0x01    // Zeit in crypto_box und Hash messen
+#define OROBI_METRICS_HISTOGRAM           0x02    // Latenzhistogramm pro Operation
+#define OROBI_METRICS_DEFAULT             0       // Zeitmessung kostet vier Uhr-Lesungen pro Paket
+#define OROBI_METRICS_HISTOGRAM_BUCKETS   16      // Bucket i: [2^i, 2^(i+1)) µs, Bucket 0 inkl. < 1 µs, letzter offen
+
+typedef enum {
+    OROBI_METRIC_CREATE   = 0,      // orobi_create_packet
+    OROBI_METRIC_ENCRYPT  = 1,      // orobi_encrypt_packet, orobi_encode_packet
+    OROBI_METRIC_DECRYPT  = 2,      // orobi_decrypt_packet, orobi_decode_packet
+    OROBI_METRIC_OPS      = 3
+} orobi_metric_op_t;
+
+typedef struct {
+    uint64_t              ops[OROBI_METRIC_OPS];                // erfolgreiche Operationen
+    uint64_t              failures[OROBI_ERROR_COUNT];          // fehlgeschlagene Operationen, Index -orobi_error_t
+    uint64_t              crypto_ns;                            // Zeit in crypto_box (inkl. Shared-Key)
+    uint64_t              hash_ns;                              // Zeit in crypt_hash und packet_hash
+    uint32_t              histogram[OROBI_METRIC_OPS][OROBI_METRICS_HISTOGRAM_BUCKETS];
+} orobi_secure_metrics_t;
+
 // Kontext-Struktur für den Zustand der Kommunikation
 typedef struct {
     uint128_t             id;
     unsigned char         public_key[crypto_box_PUBLICKEYBYTES];
     unsigned char         secret_key[crypto_box_SECRETKEYBYTES];
-    orobi_secure_nonce_t  last_seen_nonce;
-    char                  last_error[OROBI_ERROR_BUFFER_SIZE];
+    orobi_secure_nonce_t  last_seen_nonce;   // zuletzt akzeptierte Nonce (beliebige Gegenstelle)
+    char                  last_error[OROBI_ERROR_BUFFER_SIZE];  // erst in orobi_secure_last_error formatiert
     orobi_error_t         last_status;
+    const char*           last_detail;     // Format des letzten Fehlers (statisch), Argumente in last_detail_args
+    uint32_t              last_detail_args[2];
+    orobi_secure_peer_t   peers[OROBI_PEER_CACHE_SIZE];
+    uint32_t              peer_clock;
+    uint32_t              tx_counter;      // Nonce-Counter für gesendete Pakete
+    uint8_t               nonce_prefix[OROBI_NONCE_PREFIX_SIZE];   // Sitzungspräfix gesendeter Nonces
+    bool                  nonce_prefix_valid;
+    uint32_t              session_tx_limit; // letztes exportiertes Ticket (0: keins)
+    uint32_t              session_rx_limit;
+    orobi_random_t        random;          // CSPRNG des Kontexts (beim ersten Paket geseedet)
+    const orobi_clock_t*  clock;           // Sitzungsuhr für Zeitstempel und Paketalter (NULL: keine Prüfung)
+    uint32_t              max_packet_age;  // ms
+    uint16_t              replay_window;   // Fenstergröße in Countern (Vielfaches von 64)
+    orobi_hash_algo_t     hash_algo;       // Hash für crypt_hash beim Senden (orobi_encode_packet)
+    unsigned char*        scratch;        // Arbeitspuffer für create/encrypt/decrypt (NULL: malloc pro Aufruf)
+    size_t                scratch_size;
+    bool                  scratch_owned;
+    uint8_t               metrics_flags;   // OROBI_METRICS_*
+    orobi_secure_metrics_t metrics;        // nur der Besitzer des Kontexts schreibt
 } orobi_secure_t;
 
+// Größe des Arbeitspuffers, mit dem kein Paketpfad mehr Heap-Speicher anfordert
+#define OROBI_SECURE_SCRATCH_SIZE         (2 * (sizeof(orobi_packet_t) + crypto_box_ZEROBYTES))
+
+// Inkrementeller Murmur3-Hasher, liefert denselben Hash wie orobi_murmur3_64.
+// Die Gesamtlänge geht ins Seed-Mixing ein und muss deshalb schon bei init bekannt sein.
+typedef struct {
+    uint64_t                 h;
+    uint8_t                  tail[8];     // angefangener 64-Bit Block
+    size_t                   tail_size;
+} orobi_murmur3_state_t;
+
 uint64_t         orobi_murmur3_64(const void* data, size_t len, uint64_t seed);
+void             orobi_murmur3_64_init(orobi_murmur3_state_t* state, size_t len, uint64_t seed);
+void             orobi_murmur3_64_update(orobi_murmur3_state_t* state, const void* data, size_t size);
+uint64_t         orobi_murmur3_64_final(const orobi_murmur3_state_t* state);
+// Mehrspuriger Murmur3 (andere Hashwerte als orobi_murmur3_64), Implementierung per CPU-Dispatch
+uint64_t         orobi_murmur3_64x4(const void* data, size_t len, uint64_t seed);
+uint64_t         orobi_hash_64(orobi_hash_algo_t algo, const void* data, size_t len, uint64_t seed);
+bool             orobi_hash_supported(orobi_hash_algo_t algo);
 
 void             orobi_secure_init(orobi_secure_t* ctx, uint128_t id, const unsigned char* public_key, const unsigned char* secret_key);
 orobi_error_t    orobi_secure_close(orobi_secure_t* ctx);
+// Text zu einem Fehlercode (statisch)
+const char*      orobi_error_string(orobi_error_t status);
+// Formatiert den letzten Fehler des Kontexts erst bei Bedarf nach ctx->last_error
+const char*      orobi_secure_last_error(orobi_secure_t* ctx);
+// flags: OROBI_METRICS_*; die Zähler selbst sind immer aktiv
+orobi_error_t    orobi_secure_set_metrics(orobi_secure_t* ctx, uint8_t flags);
+// Momentaufnahme der Metriken, darf aus einem anderen Thread als dem Besitzer gelesen werden
+// (jedes Feld für sich konsistent, auf 32-Bit-Zielen wie dem ESP32 nur 32-Bit-Felder)
+orobi_error_t    orobi_secure_get_metrics(const orobi_secure_t* ctx, orobi_secure_metrics_t* metrics);
+// Nur vom Besitzer des Kontexts aufrufen
+void             orobi_secure_reset_metrics(orobi_secure_t* ctx);
+// Ersetzt das eigene Schlüsselpaar und verwirft alle gecachten Shared-Keys
+orobi_error_t    orobi_secure_set_keys(orobi_secure_t* ctx, const unsigned char* public_key, const unsigned char* secret_key);
+// Verwirft den gecachten Shared-Key einer Gegenstelle (z.B. nach Schlüsselwechsel des Roboters)
+orobi_error_t    orobi_secure_invalidate_peer(orobi_secure_t* ctx, const unsigned char* their_public_key);
+void             orobi_secure_invalidate_peers(orobi_secure_t* ctx);
+// Hash-Algorithmus für gesendete Pakete; der Empfänger nimmt den Algorithmus aus dem Header
+orobi_error_t    orobi_secure_set_hash_algo(orobi_secure_t* ctx, orobi_hash_algo_t algo);
+// Setzt die Größe des Anti-Replay-Fensters (Vielfaches von 64, OROBI_REPLAY_WINDOW_MIN..MAX).
+// Setzt den Replay-Zustand aller Gegenstellen zurück; das Fenster gilt danach für den nächsten Präfix.
+orobi_error_t    orobi_secure_set_replay_window(orobi_secure_t* ctx, uint16_t window);
+// Sitzungstickets für eine einzelne Gegenstelle (Roboter <-> Bodenstation).
+// export: aktualisiert Schlüssel und Counter-Grenzen in ticket (Transportfelder bleiben), danach persistieren.
+// due: true, sobald die Hälfte eines Counter-Vorrats verbraucht ist (oder noch kein Ticket existiert);
+//      nur dann muss neu exportiert und geschrieben werden.
+// resume: setzt die Sitzung aus einem geprüften Ticket fort. Die Gegenstelle erkennt den neuen Nonce-Präfix
+//      am ersten gesendeten Paket und überspringt OROBI_SESSION_RX_LEASE eigene Counter, sofern sie den
+//      alten Präfix noch kennt (nicht aus dem Peer-Cache verdrängt); ihre Antworten werden damit nach
+//      einem Round-Trip wieder angenommen. Den alten Präfix löst der neue erst mit dem ersten Paket mit
+//      Zeitstempel nach dem Uhrabgleich ab. OROBI_ERROR_HASH_MISMATCH: Ticket beschädigt.
+orobi_error_t    orobi_secure_session_export(orobi_secure_t* ctx, const unsigned char* their_public_key,
+                                             orobi_session_ticket_t* ticket);
+bool             orobi_secure_session_due(const orobi_secure_t* ctx, const unsigned char* their_public_key);
+orobi_error_t    orobi_secure_session_resume(orobi_secure_t* ctx, const orobi_session_ticket_t* ticket);
+// Sitzungsuhr (orobi_clock.h) für Zeitstempel und Alter der Pakete, max_age_ms 0: OROBI_MAX_PACKET_AGE_MS.
+// Gesendet wird die Sitzungszeit, solange die Uhr synchron ist, sonst 0. Empfangene Pakete mit Zeitstempel
+// werden bei synchroner Uhr abgewiesen (OROBI_ERROR_PACKET_TOO_OLD), wenn sie um mehr als max_age_ms plus
+// Fehlerschranke der Uhr von der Sitzungszeit abweichen. Pakete ohne Zeitstempel haben kein Alter; sie werden
+// abgewiesen, wenn ihr Counter nicht über dem letzten Paket mit Zeitstempel desselben Präfixes liegt
+// (kein Replay aus der Zeit vor dem Uhrabgleich, auch nicht nach orobi_secure_set_replay_window).
+// Die Uhr muss länger leben als der Kontext.
+orobi_error_t    orobi_secure_set_clock(orobi_secure_t* ctx, const orobi_clock_t* clock, uint32_t max_age_ms);
+// Arbeitspuffer setzen (nach orobi_secure_init). buffer == NULL entfernt den Puffer wieder.
+// Bei size >= OROBI_SECURE_SCRATCH_SIZE allokiert der Paketpfad keinen Heap-Speicher mehr.
+orobi_error_t    orobi_secure_set_scratch(orobi_secure_t* ctx, void* buffer, size_t size);
+// Allokiert einmalig einen eigenen Arbeitspuffer (OROBI_SECURE_SCRATCH_SIZE), freigegeben in orobi_secure_close
+orobi_error_t    orobi_secure_alloc_scratch(orobi_secure_t* ctx);
 orobi_error_t    orobi_create_packet(orobi_secure_t* ctx, orobi_packet_t* packet, const char* message, uint16_t size);
+// Wie orobi_create_packet, bindet zusätzlich bound (z.B. die Felder eines Klartext-Headers) an das Paket:
+// der Empfänger muss denselben Wert an orobi_decode_packet_bound übergeben, sonst OROBI_ERROR_HASH_MISMATCH
+orobi_error_t    orobi_create_packet_bound(orobi_secure_t* ctx, orobi_packet_t* packet, const char* message,
+                                           uint16_t size, uint64_t bound);
 // Verschlüsselt ein Paket mit erweiterten Sicherheitsfeatures
 orobi_error_t    orobi_encrypt_packet(orobi_secure_t* ctx, const orobi_packet_t* packet, orobi_crypt_packet_t* crypt_packet, const unsigned char* their_public_key);
 // Decrypt and validate
 orobi_error_t    orobi_decrypt_packet(orobi_secure_t* ctx, const orobi_crypt_packet_t* crypt_packet, orobi_packet_t* packet, const unsigned char* their_public_key) ;
 
+// Verschlüsselt ein Paket in das kompakte Wire-Format (OROBI_WIRE_SIZE(message_size) Bytes)
+orobi_error_t    orobi_encode_packet(orobi_secure_t* ctx, const orobi_packet_t* packet, const unsigned char* their_public_key,
+                                     uint8_t* buffer, size_t buffer_size, size_t* written);
+// Decode, decrypt und validate eines Pakets im kompakten Wire-Format
+orobi_error_t    orobi_decode_packet(orobi_secure_t* ctx, const uint8_t* buffer, size_t size,
+                                     orobi_packet_t* packet, const unsigned char* their_public_key);
+// Gegenstück zu orobi_create_packet_bound; die Nonce wird nur bei passendem bound verbraucht
+orobi_error_t    orobi_decode_packet_bound(orobi_secure_t* ctx, const uint8_t* buffer, size_t size, uint64_t bound,
+                                           orobi_packet_t* packet, const unsigned char* their_public_key);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,40 @@
+#ifndef __LIBOPENROBI_RANDOM_H__
+#define __LIBOPENROBI_RANDOM_H__
+
+#include "orobi_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Gepufferter CSPRNG: Salsa20-Keystream, einmal aus der Systemquelle geseedet
+// (esp_fill_random auf dem ESP32, getrandom unter Linux). Nach jedem Nachfüllen wird der
+// Schlüssel aus dem Keystream ersetzt (fast key erasure), ausgegebene Bytes lassen sich danach
+// nicht mehr rekonstruieren. Nicht threadsicher, ein Generator pro Kontext.
+#define OROBI_RANDOM_KEYBYTES     32
+#ifndef OROBI_RANDOM_BUFFER_SIZE
+#define OROBI_RANDOM_BUFFER_SIZE  128                 // Vielfaches von 64 (Salsa20-Block)
+#endif
+
+typedef struct {
+    uint8_t     key[OROBI_RANDOM_KEYBYTES];
+    uint64_t    block;                                // Nonce des nächsten Keystream-Abschnitts
+    uint8_t     buffer[OROBI_RANDOM_BUFFER_SIZE];     // ab pos noch nicht ausgegeben
+    uint16_t    pos;
+    bool        seeded;
+} orobi_random_t;
+
+// Seedet aus der Systemquelle. OROBI_ERROR_INITIALIZATION_FAILED: keine Quelle verfügbar
+orobi_error_t orobi_random_init(orobi_random_t* random);
+// Deterministischer Seed (Tests, Benchmarks)
+void          orobi_random_seed(orobi_random_t* random, const uint8_t seed[OROBI_RANDOM_KEYBYTES]);
+// Füllt data mit size Zufallsbytes; ungeseedet: OROBI_ERROR_INITIALIZATION_FAILED
+orobi_error_t orobi_random_bytes(orobi_random_t* random, void* data, size_t size);
+// Löscht Schlüssel und Puffer
+void          orobi_random_wipe(orobi_random_t* random);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_RANDOM_H__
@@ -0,0 +1,123 @@
+#ifndef __LIBOPENROBI_RELIABLE_H__
+#define __LIBOPENROBI_RELIABLE_H__
+
+#include "orobi_common.h"
+#include "orobi_ticket.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Zuverlässiger Kanal über beliebige Nachrichten (i.d.R. Batches): Sliding Window mit bis zu
+// OROBI_RELIABLE_WINDOW Paketen unterwegs, kumulative Bestätigung plus SACK-Bitmap,
+// wiederholt werden nur verlorene Pakete. Jede Übertragung wird neu versiegelt (eigene Nonce).
+// Nachrichten (little-endian):
+//   DATA: OROBI_RELIABLE_DATA_MARKER u8 | epoch u32 | seq u16 | base u16 | Nutzlast
+//         epoch: zufällig je Sender-Instanz, ein Wechsel (Neustart) setzt den Empfänger zurück.
+//                32 Bit: ein neu gestarteter Sender trifft die alte Epoche praktisch nie
+//         base: ältestes unbestätigtes seq des Senders, der Empfänger überspringt alles darunter
+//   ACK:  OROBI_RELIABLE_ACK_MARKER u8 | next u16 | sack u32
+//         next: alle seq < next empfangen; Bit i von sack: next + 1 + i empfangen
+// Intern zählen beide Seiten mit 32 Bit; übertragen werden die unteren 16 Bit und relativ zum
+// eigenen Stand erweitert (Fenster << 2^15, daher eindeutig auch über den Umlauf).
+// Zustellung beim Empfänger: jedes seq genau einmal, aber in Ankunftsreihenfolge.
+#define OROBI_RELIABLE_DATA_MARKER      0xF2
+#define OROBI_RELIABLE_ACK_MARKER       0xF3
+#define OROBI_RELIABLE_HEADER_SIZE      9
+#define OROBI_RELIABLE_ACK_SIZE         7
+#define OROBI_RELIABLE_WINDOW_BITS      5
+#define OROBI_RELIABLE_WINDOW           (1u << OROBI_RELIABLE_WINDOW_BITS)    // = Bits der SACK-Bitmap
+#ifndef OROBI_RELIABLE_SLOT_SIZE
+#define OROBI_RELIABLE_SLOT_SIZE        512     // max. Nachricht inkl. Kopf, gepuffert bis zur Bestätigung
+#endif
+#define OROBI_RELIABLE_MAXPAYLOAD       (OROBI_RELIABLE_SLOT_SIZE - OROBI_RELIABLE_HEADER_SIZE)
+// Retransmission-Timeout nach RFC 6298 in ms, verdoppelt bei jedem Timeout
+#define OROBI_RELIABLE_RTO_INIT_MS      200
+#define OROBI_RELIABLE_RTO_MIN_MS       50      // WLAN-Jitter; Verluste deckt meist schon SACK ab
+#define OROBI_RELIABLE_RTO_MAX_MS       2000
+// Paket gilt als verloren, wenn so viele später gesendete seq bestätigt sind
+#define OROBI_RELIABLE_DUPTHRESH        3
+
+// Wiederholungs-Timer liegen in einer gemeinsamen Ticket-Tabelle (ein Timing-Wheel für alle Kanäle):
+// id = channel << OROBI_RELIABLE_WINDOW_BITS | Fensterplatz, ip = seq. Abgelaufene Tickets aus
+// orobi_ticket_tick gibt der Besitzer der Tabelle an orobi_reliable_timeout des Kanals (id >> WINDOW_BITS).
+#define OROBI_RELIABLE_MAX_CHANNELS     (0x10000u >> OROBI_RELIABLE_WINDOW_BITS)
+#define OROBI_RELIABLE_TICKET_ID(channel, seq) \
+    ((uint16_t)(((channel) << OROBI_RELIABLE_WINDOW_BITS) | ((seq) & (OROBI_RELIABLE_WINDOW - 1))))
+
+typedef struct {
+    uint64_t    sent;               // Erstübertragungen
+    uint64_t    retransmitted;
+    uint64_t    timeouts;
+    uint64_t    fast_retransmits;   // über SACK erkannt
+    uint64_t    acked;
+} orobi_reliable_stats_t;
+
+// Sendeseite, ein Kanal pro Gegenstelle. Nicht threadsicher (auch nicht die Ticket-Tabelle).
+typedef struct {
+    orobi_ticket_table_t*   timers;
+    uint16_t                channel;
+    uint32_t                epoch;
+    uint32_t                base;           // ältestes unbestätigtes seq
+    uint32_t                next;           // seq der nächsten neuen Nachricht
+    uint32_t                unacked;        // Bit pro Fensterplatz: belegt, noch nicht bestätigt
+    uint32_t                pending;        // Bit pro Fensterplatz: (erneut) zu senden
+    uint32_t                tx_order;       // fortlaufende Nummer jeder Übertragung
+    uint32_t                acked_order;    // höchste tx_order einer bestätigten Übertragung
+    uint32_t                acked_sent_ms;  // deren Sendezeit
+    uint32_t                srtt;           // ms, 0: noch keine Messung
+    uint32_t                rttvar;
+    uint32_t                rto;
+    uint32_t                sent_ms[OROBI_RELIABLE_WINDOW];
+    uint32_t                order[OROBI_RELIABLE_WINDOW];
+    uint16_t                size[OROBI_RELIABLE_WINDOW];
+    uint8_t                 transmissions[OROBI_RELIABLE_WINDOW];
+    orobi_reliable_stats_t  stats;
+    uint8_t                 data[OROBI_RELIABLE_WINDOW][OROBI_RELIABLE_SLOT_SIZE];
+} orobi_reliable_tx_t;
+
+// Empfangsseite; klein genug für den ESP32
+typedef struct {
+    uint32_t    next;               // alle seq < next empfangen
+    uint64_t    window;             // Bit i: next + i empfangen (Bit 0 ist nach jedem Empfang 0)
+    uint32_t    epoch;
+    bool        synced;             // false bis zum ersten DATA
+    bool        ack_due;            // seit dem letzten ACK etwas empfangen
+    uint32_t    received;
+    uint32_t    duplicates;
+} orobi_reliable_rx_t;
+
+// channel < OROBI_RELIABLE_MAX_CHANNELS, eindeutig pro Ticket-Tabelle.
+// random: Zufallszahl je Instanz, ergibt Start-seq (Bit 0-15) und Epoche (Bit 16-47)
+orobi_error_t orobi_reliable_tx_init(orobi_reliable_tx_t* tx, orobi_ticket_table_t* timers, uint16_t channel,
+                                     uint64_t random);
+// Verwirft alle unbestätigten Nachrichten und ihre Timer; der Empfänger folgt über base (gleiche Epoche)
+void          orobi_reliable_tx_reset(orobi_reliable_tx_t* tx);
+// Übernimmt eine Kopie der Nachricht. OROBI_ERROR_COMMAND_OVERFLOW: Fenster voll, erst Bestätigungen abwarten.
+orobi_error_t orobi_reliable_send(orobi_reliable_tx_t* tx, const void* message, size_t size);
+// Nächste zu (wieder)holende Nachricht, kleinstes seq zuerst, und startet ihren Timer.
+// now_ms in der Zeitbasis der Ticket-Tabelle: der Timer läuft rto ms nach now_ms ab, auch wenn der
+// letzte orobi_ticket_tick zurückliegt. message zeigt in den Kanal und bleibt bis zur Bestätigung gültig.
+// false: nichts zu senden (oder Ticket-Tabelle voll, dann beim nächsten Aufruf erneut).
+bool          orobi_reliable_poll(orobi_reliable_tx_t* tx, uint32_t now_ms, const uint8_t** message, size_t* size);
+// Verarbeitet ein ACK: gibt bestätigte Plätze frei, misst die RTT und markiert per SACK erkannte Verluste
+orobi_error_t orobi_reliable_ack(orobi_reliable_tx_t* tx, const void* message, size_t size, uint32_t now_ms);
+// Abgelaufenes Ticket dieses Kanals: Nachricht erneut senden, RTO verdoppeln
+void          orobi_reliable_timeout(orobi_reliable_tx_t* tx, const orobi_ticket_t* ticket);
+// Unbestätigte Nachrichten
+uint32_t      orobi_reliable_in_flight(const orobi_reliable_tx_t* tx);
+
+void          orobi_reliable_rx_init(orobi_reliable_rx_t* rx);
+// Prüft eine DATA-Nachricht. OROBI_OK: neu, payload zustellen. OROBI_ERROR_NONCE_REPLAY: schon zugestellt
+// bzw. veraltet.
+// OROBI_ERROR_INVALID_INPUT: kein DATA bzw. außerhalb des Fensters. Ein ACK ist in den ersten beiden Fällen fällig.
+orobi_error_t orobi_reliable_receive(orobi_reliable_rx_t* rx, const void* message, size_t size,
+                                     const uint8_t** payload, size_t* payload_size);
+// Schreibt das ACK (OROBI_RELIABLE_ACK_SIZE Bytes) und setzt ack_due zurück
+orobi_error_t orobi_reliable_ack_write(orobi_reliable_rx_t* rx, void* buffer, size_t capacity, size_t* written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_RELIABLE_H__
@@ -0,0 +1,50 @@
+#ifndef __LIBOPENROBI_RING_H__
+#define __LIBOPENROBI_RING_H__
+
+#include "orobi_common.h"
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lock-freier Single-Producer/Single-Consumer Ring über vorallokierte Slots fester Größe.
+// Genau ein Task schreibt (acquire_write/commit_write), genau ein Task liest (acquire_read/release_read);
+// die Slots werden in-place befüllt und gelesen, es wird nichts kopiert.
+#ifndef OROBI_CACHELINE
+#define OROBI_CACHELINE     64
+#endif
+
+typedef struct {
+    // Producer-Seite
+    _Alignas(OROBI_CACHELINE) atomic_uint_fast32_t  head;       // nächster zu schreibender Slot (fortlaufend)
+    uint32_t                                        high_water; // maximale Füllung
+    atomic_uint_fast32_t                            dropped;    // abgewiesene Schreibversuche (Ring voll)
+    // Consumer-Seite
+    _Alignas(OROBI_CACHELINE) atomic_uint_fast32_t  tail;       // nächster zu lesender Slot (fortlaufend)
+    // Unveränderlich nach init
+    _Alignas(OROBI_CACHELINE) uint8_t*              slots;
+    size_t                                          slot_size;
+    uint32_t                                        mask;
+} orobi_ring_t;
+
+// capacity muss eine Zweierpotenz sein, storage mindestens capacity * slot_size Bytes
+orobi_error_t orobi_ring_init(orobi_ring_t* ring, void* storage, size_t slot_size, uint32_t capacity);
+
+// Producer: freier Slot oder NULL (Ring voll, wird in dropped gezählt)
+void*         orobi_ring_acquire_write(orobi_ring_t* ring);
+void          orobi_ring_commit_write(orobi_ring_t* ring);
+
+// Consumer: ältester belegter Slot oder NULL (Ring leer)
+void*         orobi_ring_acquire_read(orobi_ring_t* ring);
+void          orobi_ring_release_read(orobi_ring_t* ring);
+
+// Aktuelle Füllung; von beiden Seiten aufrufbar, bei nebenläufigem Zugriff eine Momentaufnahme
+uint32_t      orobi_ring_depth(const orobi_ring_t* ring);
+uint32_t      orobi_ring_capacity(const orobi_ring_t* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_RING_H__
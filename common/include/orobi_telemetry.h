@@ -0,0 +1,83 @@
+#ifndef __LIBOPENROBI_TELEMETRY_H__
+#define __LIBOPENROBI_TELEMETRY_H__
+
+#include "orobi_command.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binäre Status-/Telemetrie-Frames Roboter -> Bodenstation (ersetzt "S<seq> <status> <zeit>#").
+// Nachricht: OROBI_TELEMETRY_MARKER u8 | Frames hintereinander. Der Marker unterscheidet die Nachricht
+// von einem Batch (dort beginnt jeder Eintrag mit einem orobi_command_packet_t < 0x80).
+// Frame (little-endian):
+//   flags u8 | seq_nr u8 | status u8 (orobi_command_status_t) | timestamp_ms u32
+//   danach je gesetztem Flag, in Bit-Reihenfolge:
+//     BATTERY     battery_mv u16                                  2 Bytes
+//     MOTOR       speed u16 | rotation u16                        4 Bytes
+//     HEADING     heading u16 (0.01 Grad, 0-35999)                2 Bytes
+//     DISTANCE    distance_mm u16                                 2 Bytes
+//     IMU         accel x/y/z i16 (mg)                            6 Bytes
+//     TEMPERATURE temperature i16 (0.01 Grad C)                   2 Bytes
+//     RSSI        rssi i8 (dBm)                                   1 Byte
+// Ein reiner Status-Frame hat 7 Bytes, ein voller Frame 26. Bit 7 ist reserviert (Frame ungültig).
+#define OROBI_TELEMETRY_MARKER              0xF1    // Telemetrie, Version 1
+#define OROBI_TELEMETRY_HEADER_SIZE         7
+#define OROBI_TELEMETRY_MAXFRAME            26
+
+#define OROBI_TELEMETRY_HAS_BATTERY         0x01
+#define OROBI_TELEMETRY_HAS_MOTOR           0x02
+#define OROBI_TELEMETRY_HAS_HEADING         0x04
+#define OROBI_TELEMETRY_HAS_DISTANCE        0x08
+#define OROBI_TELEMETRY_HAS_IMU             0x10
+#define OROBI_TELEMETRY_HAS_TEMPERATURE     0x20
+#define OROBI_TELEMETRY_HAS_RSSI            0x40
+#define OROBI_TELEMETRY_FLAGS_MASK          0x7F
+
+typedef struct {
+    uint8_t                 flags;          // OROBI_TELEMETRY_HAS_*, nur gesetzte Felder werden übertragen
+    uint8_t                 seq_nr;         // seq_nr des Netzwerkpakets, auf das sich status bezieht
+    orobi_command_status_t  status;
+    uint32_t                timestamp_ms;   // Sitzungszeit des Roboters (orobi_clock.h)
+    uint16_t                battery_mv;
+    uint16_t                speed;
+    uint16_t                rotation;
+    uint16_t                heading;
+    uint16_t                distance_mm;
+    int16_t                 accel[3];
+    int16_t                 temperature;
+    int8_t                  rssi;
+} orobi_telemetry_t;
+
+// Baut eine Nachricht direkt im Puffer des Aufrufers auf (z.B. im Nutzlastbereich des Sendepuffers)
+typedef struct {
+    uint8_t*        buffer;
+    size_t          capacity;
+    size_t          size;
+    uint16_t        count;
+} orobi_telemetry_writer_t;
+
+typedef struct {
+    const uint8_t*  data;
+    size_t          size;
+    size_t          pos;
+} orobi_telemetry_reader_t;
+
+// Größe eines Frames mit diesen Flags
+size_t        orobi_telemetry_frame_size(uint8_t flags);
+// true, wenn message eine Telemetrie-Nachricht ist
+bool          orobi_telemetry_is_message(const void* message, size_t size);
+
+orobi_error_t orobi_telemetry_writer_init(orobi_telemetry_writer_t* writer, void* buffer, size_t capacity);
+// OROBI_ERROR_COMMAND_OVERFLOW: Frame passt nicht mehr, erst senden und neu beginnen
+orobi_error_t orobi_telemetry_append(orobi_telemetry_writer_t* writer, const orobi_telemetry_t* frame);
+
+orobi_error_t orobi_telemetry_reader_init(orobi_telemetry_reader_t* reader, const void* message, size_t size);
+// Nächster Frame: OK, NODATA am Ende, ERROR bei defektem Frame (der Rest ist nicht lesbar)
+orobi_command_status_t orobi_telemetry_next(orobi_telemetry_reader_t* reader, orobi_telemetry_t* frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_TELEMETRY_H__
@@ -7,13 +7,69 @@
 extern "C" {
 #endif
 
-typedef struct {
+#ifndef OROBI_TICKET_CAPACITY
+#define OROBI_TICKET_CAPACITY     1024                          // max. gleichzeitige Tickets pro Tabelle
+#endif
+#ifndef OROBI_TICKET_INDEX_BITS
+#define OROBI_TICKET_INDEX_BITS   11                            // Index mit 2^11 Einträgen (Füllgrad <= 50%)
+#endif
+#if OROBI_TICKET_CAPACITY >= 0xFFFF || (2 * OROBI_TICKET_CAPACITY) > (1 << OROBI_TICKET_INDEX_BITS)
+#error "OROBI_TICKET_INDEX_BITS zu klein für OROBI_TICKET_CAPACITY (Füllgrad <= 50%, Kapazität < 0xFFFF)"
+#endif
+#define OROBI_TICKET_INDEX_SIZE   (1u << OROBI_TICKET_INDEX_BITS)
+#define OROBI_TICKET_NONE         0xFFFF
+
+// Zwei-stufiges Timing-Wheel in Millisekunden: Stufe 0 = 256 x 1 ms, Stufe 1 = 256 x 256 ms.
+// Deckt die maximale Wartezeit von 65535 ms (uint16_t wait) ab.
+#define OROBI_TICKET_WHEEL_BITS   8
+#define OROBI_TICKET_WHEEL_SIZE   (1u << OROBI_TICKET_WHEEL_BITS)
+#define OROBI_TICKET_WHEEL_DUE    (2 * OROBI_TICKET_WHEEL_SIZE)   // Liste bereits fälliger Tickets
+#define OROBI_TICKET_WHEEL_LISTS  (OROBI_TICKET_WHEEL_DUE + 1)
+
+typedef struct orobi_ticket {
     uint16_t id;
     uint32_t ip;
     uint16_t wait;
     struct orobi_ticket* next;
 } orobi_ticket_t;
 
+// Ticket-Tabelle mit fester Kapazität: Slab-Speicher als Struct-of-Arrays,
+// dazu ein Open-Addressing-Index (linear probing) id -> Slot und ein Timing-Wheel
+// über die Ablaufzeit (now + wait). Keine Heap-Allokation.
+typedef struct {
+    uint16_t ids[OROBI_TICKET_CAPACITY];
+    uint32_t ips[OROBI_TICKET_CAPACITY];
+    uint16_t waits[OROBI_TICKET_CAPACITY];
+    uint32_t deadlines[OROBI_TICKET_CAPACITY];                  // Ablaufzeit in ms
+    uint16_t wheel_next[OROBI_TICKET_CAPACITY];                 // doppelt verkettete Wheel-Listen
+    uint16_t wheel_prev[OROBI_TICKET_CAPACITY];
+    uint16_t wheel_list[OROBI_TICKET_CAPACITY];                 // Liste, in der der Slot hängt
+    uint16_t next_free[OROBI_TICKET_CAPACITY];                  // Freiliste des Slabs
+    uint16_t free_head;
+    uint16_t count;
+    uint16_t index[OROBI_TICKET_INDEX_SIZE];                    // Slot oder OROBI_TICKET_NONE
+    uint16_t wheel_head[OROBI_TICKET_WHEEL_LISTS];
+    uint32_t wheel_used[OROBI_TICKET_WHEEL_SIZE / 32];          // belegte Slots der Stufe 0
+    uint32_t wheel_used1[OROBI_TICKET_WHEEL_SIZE / 32];         // belegte Slots der Stufe 1
+    uint32_t now;                                               // bis hierhin abgearbeitet (ms)
+} orobi_ticket_table_t;
+
+// now_ms: Startzeit der Tabelle, gleiche Zeitbasis wie bei orobi_ticket_tick
+void          orobi_ticket_table_init(orobi_ticket_table_t* table, uint32_t now_ms);
+// Legt ein Ticket an bzw. aktualisiert ip/wait eines vorhandenen Tickets mit gleicher id. O(1)
+// Das Ticket läuft wait ms nach der Zeit des letzten orobi_ticket_tick ab.
+orobi_error_t orobi_ticket_table_create(orobi_ticket_table_t* table, uint16_t id, uint32_t ip, uint16_t wait);
+orobi_error_t orobi_ticket_table_remove(orobi_ticket_table_t* table, uint16_t id);
+// Kopiert das Ticket nach ticket (next ist immer NULL). O(1)
+orobi_error_t orobi_ticket_table_find(const orobi_ticket_table_t* table, uint16_t id, orobi_ticket_t* ticket);
+void          orobi_ticket_table_clear(orobi_ticket_table_t* table);
+// Rückt die Zeit auf now_ms vor und entnimmt abgelaufene Tickets (aus der Tabelle entfernt).
+// Aufwand O(abgelaufene + belegte Wheel-Slots); leere Slots beider Stufen werden über Bitmaps übersprungen,
+// auch die Kaskadenpunkte alle 256 ms. Ist expired voll, liefert der nächste Aufruf den Rest.
+orobi_error_t orobi_ticket_tick(orobi_ticket_table_t* table, uint32_t now_ms,
+                                orobi_ticket_t* expired, size_t max_expired, size_t* count);
+
+// Kompatibilitäts-API: verkettete Liste mit einer Heap-Allokation pro Ticket, O(n) Suche
 orobi_error_t orobi_ticket_create(uint16_t id, uint32_t ip, uint16_t ms, orobi_ticket_t** ticket_buffer);
 orobi_error_t orobi_ticket_remove(uint16_t id, orobi_ticket_t** ticket_buffer);
 orobi_error_t orobi_ticket_find(uint16_t id, orobi_ticket_t* ticket_buffer, orobi_ticket_t** ticket);
@@ -0,0 +1,92 @@
+#ifndef __LIBOPENROBI_TXQUEUE_H__
+#define __LIBOPENROBI_TXQUEUE_H__
+
+#include "orobi_batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sendewarteschlange für Kommandos mit drei Klassen, geleert in einen orobi_batch_t:
+//   CONTROL: strikte Priorität, FIFO (STARTDATA, INT, FLOAT und MOTORDATA mit gedrückter Bremse)
+//   MOTOR:   MOTORDATA, latest value wins: nur der neueste noch nicht gesendete Wert bleibt erhalten
+//   BULK:    STRING und USER, FIFO, nur mit dem Platz, den CONTROL und MOTOR übrig lassen
+// Jedes Kommando kann eine Frist haben; ist sie beim Leeren abgelaufen, wird es verworfen statt verspätet
+// gesendet. Eine Bremse in CONTROL verwirft den wartenden MOTOR-Wert, damit kein älterer Sollwert nach ihr
+// ankommt. Keine Heap-Allokation, nicht threadsicher.
+#ifndef OROBI_TXQUEUE_CONTROL_SLOTS
+#define OROBI_TXQUEUE_CONTROL_SLOTS     16      // Zweierpotenz
+#endif
+#ifndef OROBI_TXQUEUE_BULK_SLOTS
+#define OROBI_TXQUEUE_BULK_SLOTS        8       // Zweierpotenz, je ca. 320 Bytes
+#endif
+#define OROBI_TXQUEUE_MOTOR_TTL_MS      100     // Vorgabe-Frist für MOTORDATA
+#define OROBI_TXQUEUE_NO_DEADLINE       UINT32_MAX
+
+typedef enum orobi_txqueue_class {
+    OROBI_TXQUEUE_CONTROL,
+    OROBI_TXQUEUE_MOTOR,
+    OROBI_TXQUEUE_BULK,
+    OROBI_TXQUEUE_CLASSES
+} orobi_txqueue_class_t;
+
+typedef struct {
+    uint64_t    queued;
+    uint64_t    sent;           // in einen Batch übernommen
+    uint64_t    coalesced;      // durch einen neueren Wert ersetzt (nur MOTOR)
+    uint64_t    expired;        // Frist abgelaufen, verworfen
+    uint64_t    rejected;       // Klasse voll
+} orobi_txqueue_stats_t;
+
+typedef struct {
+    orobi_command_t command;
+    uint32_t        deadline;   // ms, nur gültig wenn expires
+    bool            expires;
+} orobi_txqueue_entry_t;
+
+typedef struct {
+    orobi_txqueue_entry_t   entry;
+    uint8_t                 user_size;  // Kopie der USER-Daten
+    uint8_t                 user[OROBI_BATCH_MAX_ENTRY];
+} orobi_txqueue_bulk_entry_t;
+
+typedef struct {
+    orobi_txqueue_entry_t       control[OROBI_TXQUEUE_CONTROL_SLOTS];
+    uint8_t                     control_head;
+    uint8_t                     control_count;
+    orobi_txqueue_entry_t       motor;
+    bool                        motor_pending;
+    orobi_txqueue_bulk_entry_t  bulk[OROBI_TXQUEUE_BULK_SLOTS];
+    uint8_t                     bulk_head;
+    uint8_t                     bulk_count;
+    uint32_t                    ttl[OROBI_TXQUEUE_CLASSES];     // Vorgabe-Frist in ms, 0: keine
+    orobi_txqueue_stats_t       stats[OROBI_TXQUEUE_CLASSES];
+} orobi_txqueue_t;
+
+// Vorgabe-Fristen: MOTOR OROBI_TXQUEUE_MOTOR_TTL_MS, CONTROL und BULK keine
+void                  orobi_txqueue_init(orobi_txqueue_t* queue);
+void                  orobi_txqueue_reset(orobi_txqueue_t* queue);
+// ttl_ms 0: keine Frist für diese Klasse
+void                  orobi_txqueue_set_ttl(orobi_txqueue_t* queue, orobi_txqueue_class_t cls, uint32_t ttl_ms);
+orobi_txqueue_class_t orobi_txqueue_classify(const orobi_command_t* command);
+// Reiht ein Kommando seiner Klasse ein. ttl_ms: Frist ab now_ms, 0: Vorgabe der Klasse,
+// OROBI_TXQUEUE_NO_DEADLINE: keine. OROBI_ERROR_COMMAND_OVERFLOW: Klasse voll.
+// OROBI_COMMAND_USER geht nur über orobi_txqueue_push_user.
+orobi_error_t         orobi_txqueue_push(orobi_txqueue_t* queue, const orobi_command_t* command,
+                                         uint32_t ttl_ms, uint32_t now_ms);
+orobi_error_t         orobi_txqueue_push_user(orobi_txqueue_t* queue, const void* data, uint8_t size,
+                                              uint32_t ttl_ms, uint32_t now_ms);
+// Übernimmt CONTROL, dann MOTOR, dann BULK in den Batch und verwirft abgelaufene Kommandos.
+// Unmittelbar vor orobi_batch_seal aufrufen, im Batch gilt keine Frist mehr.
+// OROBI_ERROR_COMMAND_OVERFLOW: Batch voll, es warten noch Kommandos (senden, dann erneut aufrufen).
+orobi_error_t         orobi_txqueue_fill(orobi_txqueue_t* queue, orobi_batch_t* batch, uint32_t now_ms);
+// Wartende Kommandos (inkl. noch nicht verworfener abgelaufener)
+uint32_t              orobi_txqueue_pending(const orobi_txqueue_t* queue);
+// true, wenn CONTROL etwas enthält: Batch sofort senden statt max_delay abzuwarten
+bool                  orobi_txqueue_urgent(const orobi_txqueue_t* queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_TXQUEUE_H__
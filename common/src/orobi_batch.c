@@ -0,0 +1,270 @@
+#include "orobi_batch.h"
+#include <string.h>
+
+#define OROBI_BATCH_MOTOR_SIZE  5
+#define OROBI_BATCH_START_SIZE  43
+
+// Reserviert einen Eintrag und liefert den Zeiger auf seine Daten; NULL, wenn der Batch voll ist
+static uint8_t* __orobi_batch_reserve(orobi_batch_t* batch, orobi_command_packet_t type, uint8_t size, uint32_t now_ms) {
+    if ((size_t)batch->size + OROBI_BATCH_ENTRY_HEADER + size > OROBI_BATCH_CAPACITY) {
+        return NULL;
+    }
+
+    uint8_t* entry = batch->buffer + batch->size;
+    entry[0] = (uint8_t)type;
+    entry[1] = size;
+    if (batch->count == 0) {
+        batch->opened = now_ms;
+    }
+    batch->size += OROBI_BATCH_ENTRY_HEADER + size;
+    batch->count++;
+    return entry + OROBI_BATCH_ENTRY_HEADER;
+}
+
+void orobi_batch_init(orobi_batch_t* batch, uint16_t flush_size, uint32_t max_delay_ms) {
+    if (!batch) {
+        return;
+    }
+
+    batch->flush_size = (flush_size == 0 || flush_size > OROBI_BATCH_CAPACITY) ? OROBI_BATCH_CAPACITY : flush_size;
+    batch->max_delay = max_delay_ms;
+    orobi_batch_reset(batch);
+}
+
+void orobi_batch_reset(orobi_batch_t* batch) {
+    if (batch) {
+        batch->size = 0;
+        batch->count = 0;
+        batch->opened = 0;
+    }
+}
+
+orobi_error_t orobi_batch_add(orobi_batch_t* batch, const orobi_command_t* command, uint32_t now_ms) {
+    if (!batch || !command) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (command->type == OROBI_COMMAND_USER) {
+        return OROBI_ERROR_UNSUPPORTED_COMMAND;
+    }
+
+    orobi_error_t status = orobi_command_validate(command);
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    uint8_t* p;
+    switch (command->type) {
+        case OROBI_COMMAND_MOTORDATA: {
+            if (!(p = __orobi_batch_reserve(batch, command->type, OROBI_BATCH_MOTOR_SIZE, now_ms))) {
+                return OROBI_ERROR_COMMAND_OVERFLOW;
+            }
+            uint8_t buttons = 0;
+            for (int i = 0; i < 4; i++) {
+                buttons |= command->motor.buttons[i] ? (uint8_t)(1u << i) : 0;
+            }
+            orobi_write_le16(p, command->motor.speed);
+            orobi_write_le16(p + 2, command->motor.rotation);
+            p[4] = buttons;
+            break;
+        }
+        case OROBI_COMMAND_STARTDATA: {
+            if (!(p = __orobi_batch_reserve(batch, command->type, OROBI_BATCH_START_SIZE, now_ms))) {
+                return OROBI_ERROR_COMMAND_OVERFLOW;
+            }
+            const orobi_start_t* start = &command->start;
+            memcpy(p, start->wifi_ssid, 16);
+            memcpy(p + 16, start->wifi_passwd, 16);
+            p[32] = start->rw_port;
+            orobi_write_le32(p + 33, start->key_station[0]);
+            orobi_write_le32(p + 37, start->key_station[1]);
+            orobi_write_le16(p + 41, start->api_key);
+            break;
+        }
+        case OROBI_COMMAND_INT:
+        case OROBI_COMMAND_FLOAT: {
+            uint32_t bits = command->value;
+            if (command->type == OROBI_COMMAND_FLOAT) {
+                memcpy(&bits, &command->fvalue, sizeof(uint32_t));
+            }
+            if (!(p = __orobi_batch_reserve(batch, command->type, sizeof(uint32_t), now_ms))) {
+                return OROBI_ERROR_COMMAND_OVERFLOW;
+            }
+            orobi_write_le32(p, bits);
+            break;
+        }
+        case OROBI_COMMAND_STRING: {
+            const uint8_t length = (uint8_t)strnlen(command->string, sizeof(command->string));
+            if (!(p = __orobi_batch_reserve(batch, command->type, length, now_ms))) {
+                return OROBI_ERROR_COMMAND_OVERFLOW;
+            }
+            memcpy(p, command->string, length);
+            break;
+        }
+        default:
+            return OROBI_ERROR_UNSUPPORTED_COMMAND;
+    }
+
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_batch_add_user(orobi_batch_t* batch, const void* data, uint8_t size, uint32_t now_ms) {
+    if (!batch || (!data && size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    uint8_t* p = __orobi_batch_reserve(batch, OROBI_COMMAND_USER, size, now_ms);
+    if (!p) {
+        return OROBI_ERROR_COMMAND_OVERFLOW;
+    }
+    if (size > 0) {
+        memcpy(p, data, size);
+    }
+    return OROBI_OK;
+}
+
+bool orobi_batch_due(const orobi_batch_t* batch, uint32_t now_ms) {
+    if (!batch || batch->count == 0) {
+        return false;
+    }
+    return batch->size >= batch->flush_size || (uint32_t)(now_ms - batch->opened) >= batch->max_delay;
+}
+
+orobi_error_t orobi_batch_seal(orobi_secure_t* ctx, orobi_lz_work_t* work, orobi_packet_t* packet, orobi_batch_t* batch,
+                               uint8_t seq_nr, uint16_t api_key, const unsigned char* their_public_key,
+                               void* buffer, size_t buffer_size, size_t* written) {
+    if (!batch || batch->count == 0) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_error_t status = orobi_netpacket_seal(ctx, work, packet, seq_nr, api_key, batch->buffer, batch->size,
+                                                their_public_key, buffer, buffer_size, written);
+    if (status == OROBI_OK) {
+        orobi_batch_reset(batch);
+    }
+    return status;
+}
+
+orobi_error_t orobi_batch_reader_init(orobi_batch_reader_t* reader, const void* message, size_t size) {
+    if (!reader || (!message && size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    reader->data = (const uint8_t*)message;
+    reader->size = size;
+    reader->pos = 0;
+    reader->index = 0;
+    return OROBI_OK;
+}
+
+orobi_command_status_t orobi_batch_next(orobi_batch_reader_t* reader, orobi_command_t* command,
+                                        const uint8_t** user_data, uint8_t* user_size) {
+    if (!reader || !command) {
+        return OROBI_COMMAND_STATUS_ERROR;
+    }
+    if (reader->pos == reader->size) {
+        return OROBI_COMMAND_STATUS_NODATA;
+    }
+    if (reader->size - reader->pos < OROBI_BATCH_ENTRY_HEADER ||
+        reader->size - reader->pos - OROBI_BATCH_ENTRY_HEADER < reader->data[reader->pos + 1]) {
+        reader->pos = reader->size;
+        return OROBI_COMMAND_STATUS_ERROR;
+    }
+
+    const uint8_t type = reader->data[reader->pos];
+    const uint8_t size = reader->data[reader->pos + 1];
+    const uint8_t* p = reader->data + reader->pos + OROBI_BATCH_ENTRY_HEADER;
+    reader->pos += OROBI_BATCH_ENTRY_HEADER + size;
+    reader->index++;
+
+    memset(command, 0, sizeof(orobi_command_t));
+    command->type = (orobi_command_packet_t)type;
+
+    switch (type) {
+        case OROBI_COMMAND_MOTORDATA:
+            if (size != OROBI_BATCH_MOTOR_SIZE || (p[4] & ~0x0F)) {
+                return OROBI_COMMAND_STATUS_INVALID_COMMAND;
+            }
+            command->motor.speed = orobi_read_le16(p);
+            command->motor.rotation = orobi_read_le16(p + 2);
+            for (int i = 0; i < 4; i++) {
+                command->motor.buttons[i] = (p[4] >> i) & 1;
+            }
+            break;
+        case OROBI_COMMAND_STARTDATA:
+            if (size != OROBI_BATCH_START_SIZE) {
+                return OROBI_COMMAND_STATUS_INVALID_COMMAND;
+            }
+            memcpy(command->start.wifi_ssid, p, 16);
+            memcpy(command->start.wifi_passwd, p + 16, 16);
+            command->start.rw_port = p[32];
+            command->start.key_station[0] = orobi_read_le32(p + 33);
+            command->start.key_station[1] = orobi_read_le32(p + 37);
+            command->start.api_key = orobi_read_le16(p + 41);
+            break;
+        case OROBI_COMMAND_INT:
+        case OROBI_COMMAND_FLOAT: {
+            if (size != sizeof(uint32_t)) {
+                return OROBI_COMMAND_STATUS_INVALID_COMMAND;
+            }
+            const uint32_t bits = orobi_read_le32(p);
+            if (type == OROBI_COMMAND_FLOAT) {
+                memcpy(&command->fvalue, &bits, sizeof(float));
+            } else {
+                command->value = bits;
+            }
+            break;
+        }
+        case OROBI_COMMAND_STRING:
+            if (size >= sizeof(command->string)) {
+                return OROBI_COMMAND_STATUS_INVALID_COMMAND;
+            }
+            memcpy(command->string, p, size);
+            break;
+        case OROBI_COMMAND_USER:
+            // Zeigt in die Nachricht; packet ist nur gesetzt, damit orobi_command_validate greift
+            command->packet = (void*)p;
+            if (user_data) {
+                *user_data = p;
+            }
+            if (user_size) {
+                *user_size = size;
+            }
+            break;
+        default:
+            return OROBI_COMMAND_STATUS_INVALID_COMMAND;
+    }
+
+    return orobi_command_validate(command) == OROBI_OK ? OROBI_COMMAND_STATUS_OK : OROBI_COMMAND_STATUS_INVALID_COMMAND;
+}
+
+orobi_error_t orobi_batch_unpack(const void* message, size_t size, orobi_command_t* commands,
+                                 orobi_command_status_t* status, size_t max, size_t* count) {
+    if (!commands || !status || !count) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_batch_reader_t reader;
+    orobi_error_t result = orobi_batch_reader_init(&reader, message, size);
+    if (result != OROBI_OK) {
+        return result;
+    }
+
+    size_t n = 0;
+    for (;;) {
+        if (n == max) {
+            *count = n;
+            return reader.pos == reader.size ? OROBI_OK : OROBI_ERROR_COMMAND_OVERFLOW;
+        }
+        const orobi_command_status_t s = orobi_batch_next(&reader, &commands[n], NULL, NULL);
+        if (s == OROBI_COMMAND_STATUS_NODATA) {
+            break;
+        }
+        status[n++] = s;
+        if (s == OROBI_COMMAND_STATUS_ERROR) {
+            break;
+        }
+    }
+
+    *count = n;
+    return OROBI_OK;
+}
@@ -0,0 +1,227 @@
+#include "orobi_clock.h"
+#include <string.h>
+
+#ifdef ESP32
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif
+
+uint32_t orobi_clock_local_ms(void) {
+#ifdef ESP32
+    return (uint32_t)(esp_timer_get_time() / 1000);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+#endif
+}
+
+static uint32_t __orobi_clock_abs(int32_t value) {
+    return value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+}
+
+// Angewendeter Offset: von base_offset mit begrenzter Rate auf target_offset zu
+static uint32_t __orobi_clock_offset(const orobi_clock_t* clock, uint32_t local_ms) {
+    const int32_t elapsed = (int32_t)(local_ms - clock->adjust_local);
+    const int32_t max = elapsed > 0 ? elapsed / OROBI_CLOCK_SLEW_DIV : 0;
+    const int32_t diff = (int32_t)(clock->target_offset - clock->base_offset);
+    if (diff > max) {
+        return clock->base_offset + (uint32_t)max;
+    }
+    if (diff < -max) {
+        return clock->base_offset - (uint32_t)max;
+    }
+    return clock->target_offset;
+}
+
+// Index der Messung mit der kleinsten RTT
+static uint8_t __orobi_clock_best(const orobi_clock_t* clock) {
+    uint8_t best = 0;
+    for (uint8_t i = 1; i < clock->count; i++) {
+        if (clock->rtt[i] < clock->rtt[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static uint32_t __orobi_clock_jitter(const orobi_clock_t* clock, uint8_t best) {
+    if (clock->count < 2) {
+        return 0;
+    }
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < clock->count; i++) {
+        sum += __orobi_clock_abs((int32_t)(clock->offset[i] - clock->offset[best]));
+    }
+    return sum / (uint32_t)(clock->count - 1);
+}
+
+void orobi_clock_init(orobi_clock_t* clock, bool master) {
+    if (!clock) {
+        return;
+    }
+
+    memset(clock, 0, sizeof(*clock));
+    clock->master = master;
+    clock->synced = master;
+}
+
+uint32_t orobi_clock_session_ms(const orobi_clock_t* clock, uint32_t local_ms) {
+    if (!clock || clock->master) {
+        return local_ms;
+    }
+    return local_ms + __orobi_clock_offset(clock, local_ms);
+}
+
+uint32_t orobi_clock_now(const orobi_clock_t* clock) {
+    return orobi_clock_session_ms(clock, OROBI_CLOCK_LOCAL_MS());
+}
+
+bool orobi_clock_synced(const orobi_clock_t* clock, uint32_t local_ms) {
+    if (!clock || !clock->synced) {
+        return false;
+    }
+    return clock->master || local_ms - clock->last_sample < OROBI_CLOCK_HOLDOVER_MS;
+}
+
+uint32_t orobi_clock_error_ms(const orobi_clock_t* clock, uint32_t local_ms) {
+    if (!orobi_clock_synced(clock, local_ms)) {
+        return UINT32_MAX;
+    }
+    if (clock->master) {
+        return 0;
+    }
+
+    const uint8_t best = __orobi_clock_best(clock);
+    const uint32_t age = local_ms - clock->last_sample;
+    const uint32_t slew = __orobi_clock_abs((int32_t)(clock->target_offset - __orobi_clock_offset(clock, local_ms)));
+    return (clock->rtt[best] + 1) / 2 + __orobi_clock_jitter(clock, best) + slew +
+           (uint32_t)(((uint64_t)age * OROBI_CLOCK_DRIFT_PPM + 999999u) / 1000000u);
+}
+
+bool orobi_clock_request_due(const orobi_clock_t* clock, uint32_t local_ms) {
+    if (!clock || clock->master) {
+        return false;
+    }
+    if (clock->pending && local_ms - clock->pending_t1 < OROBI_CLOCK_TIMEOUT_MS) {
+        return false;
+    }
+    return clock->samples == 0 || (int32_t)(local_ms - clock->next_poll) >= 0;
+}
+
+orobi_error_t orobi_clock_request_write(orobi_clock_t* clock, uint32_t local_ms,
+                                        void* buffer, size_t capacity, size_t* written) {
+    if (!clock || !buffer || !written || clock->master) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (capacity < OROBI_CLOCK_REQUEST_SIZE) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    uint8_t* p = buffer;
+    p[0] = OROBI_CLOCK_REQUEST_MARKER;
+    orobi_write_le32(p + 1, local_ms);
+    clock->pending = true;
+    clock->pending_t1 = local_ms;
+    clock->next_poll = local_ms + (clock->count < OROBI_CLOCK_SAMPLES ? OROBI_CLOCK_POLL_FAST_MS : OROBI_CLOCK_POLL_MS);
+    *written = OROBI_CLOCK_REQUEST_SIZE;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_clock_respond(const orobi_clock_t* clock, const void* request, size_t size, uint32_t rx_local_ms,
+                                  void* buffer, size_t capacity, size_t* written) {
+    const uint8_t* in = request;
+    if (!clock || !in || !buffer || !written || size != OROBI_CLOCK_REQUEST_SIZE ||
+        in[0] != OROBI_CLOCK_REQUEST_MARKER) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (capacity < OROBI_CLOCK_RESPONSE_SIZE) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+    const uint32_t now = OROBI_CLOCK_LOCAL_MS();
+    if (!orobi_clock_synced(clock, now)) {
+        return OROBI_ERROR_TIME_SYNC;
+    }
+
+    uint8_t* p = buffer;
+    p[0] = OROBI_CLOCK_RESPONSE_MARKER;
+    memcpy(p + 1, in + 1, sizeof(uint32_t));
+    orobi_write_le32(p + 5, orobi_clock_session_ms(clock, rx_local_ms));
+    orobi_write_le32(p + 9, orobi_clock_session_ms(clock, now));
+    *written = OROBI_CLOCK_RESPONSE_SIZE;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_clock_response(orobi_clock_t* clock, const void* message, size_t size, uint32_t rx_local_ms) {
+    const uint8_t* p = message;
+    if (!clock || !p || size != OROBI_CLOCK_RESPONSE_SIZE || p[0] != OROBI_CLOCK_RESPONSE_MARKER || clock->master) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    // Nur die Antwort auf die offene Anfrage; Duplikate und verspätete Antworten verwerfen
+    const uint32_t t1 = orobi_read_le32(p + 1);
+    const uint32_t t2 = orobi_read_le32(p + 5);
+    const uint32_t t3 = orobi_read_le32(p + 9);
+    const uint32_t t4 = rx_local_ms;
+    const int32_t rtt = (int32_t)((t4 - t1) - (t3 - t2));
+    if (!clock->pending || t1 != clock->pending_t1 || (int32_t)(t3 - t2) < 0 || rtt < 0 ||
+        rtt > OROBI_CLOCK_MAX_RTT_MS) {
+        clock->rejected++;
+        return OROBI_ERROR_TIME_SYNC;
+    }
+    clock->pending = false;
+
+    // Modulo 2^32: (t2 - t1) + ((t3 - t4) - (t2 - t1)) / 2, die Differenz ist -rtt und damit klein
+    const uint32_t forward = t2 - t1;
+    const uint32_t offset = forward + (uint32_t)((int32_t)((t3 - t4) - forward) / 2);
+
+    // Master neu gestartet bzw. Zeitsprung: alte Messungen passen nicht mehr
+    if (clock->count > 0 &&
+        __orobi_clock_abs((int32_t)(offset - clock->offset[__orobi_clock_best(clock)])) > OROBI_CLOCK_STEP_MS) {
+        clock->count = 0;
+        clock->head = 0;
+    }
+    clock->offset[clock->head] = offset;
+    clock->rtt[clock->head] = (uint32_t)rtt;
+    clock->head = (uint8_t)((clock->head + 1) % OROBI_CLOCK_SAMPLES);
+    if (clock->count < OROBI_CLOCK_SAMPLES) {
+        clock->count++;
+    }
+    clock->samples++;
+    clock->last_sample = t4;
+
+    const uint32_t target = clock->offset[__orobi_clock_best(clock)];
+    const uint32_t applied = __orobi_clock_offset(clock, t4);
+    if (!clock->synced || __orobi_clock_abs((int32_t)(target - applied)) > OROBI_CLOCK_STEP_MS) {
+        clock->base_offset = target;
+    } else {
+        clock->base_offset = applied;
+    }
+    clock->target_offset = target;
+    clock->adjust_local = t4;
+    clock->synced = true;
+    return OROBI_OK;
+}
+
+void orobi_clock_get_quality(const orobi_clock_t* clock, uint32_t local_ms, orobi_clock_quality_t* quality) {
+    if (!quality) {
+        return;
+    }
+    memset(quality, 0, sizeof(*quality));
+    if (!clock) {
+        return;
+    }
+
+    quality->synced = orobi_clock_synced(clock, local_ms);
+    quality->offset_ms = orobi_clock_session_ms(clock, local_ms) - local_ms;
+    quality->error_ms = orobi_clock_error_ms(clock, local_ms);
+    quality->samples = clock->samples;
+    quality->rejected = clock->rejected;
+    if (clock->count > 0) {
+        const uint8_t best = __orobi_clock_best(clock);
+        quality->rtt_ms = clock->rtt[best];
+        quality->jitter_ms = __orobi_clock_jitter(clock, best);
+        quality->age_ms = local_ms - clock->last_sample;
+    }
+}
@@ -2,5 +2,238 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
+// Hash über Header (ohne Hash-Feld) und Nutzlast, ohne Zwischenpuffer
+static uint32_t __orobi_netpacket_hash(const uint8_t* header, const uint8_t* payload, uint16_t payload_size) {
+    orobi_murmur3_state_t state;
+    orobi_murmur3_64_init(&state, OROBI_NETPACKET_HEADER_SIZE - 4 + payload_size, OROBI_NETPACKET_HASH_KEY);
+    orobi_murmur3_64_update(&state, header, OROBI_NETPACKET_HEADER_SIZE - 4);
+    orobi_murmur3_64_update(&state, payload, payload_size);
+    return (uint32_t)orobi_murmur3_64_final(&state);
+}
 
+static orobi_error_t __orobi_netpacket_check_compression(bool compressed, uint32_t compress_size) {
+    if (compressed) {
+        return (compress_size > 0 && compress_size <= OROBI_NETPACKET_MAXPAYLOAD) ? OROBI_OK : OROBI_ERROR_PACKET_VALIDATION_FAILED;
+    }
+    return compress_size == 0 ? OROBI_OK : OROBI_ERROR_PACKET_VALIDATION_FAILED;
+}
+
+// Zeichenkette muss innerhalb des Feldes terminiert sein
+static inline bool __orobi_command_terminated(const char* s, size_t size) {
+    return memchr(s, '\0', size) != NULL;
+}
+
+orobi_error_t orobi_command_validate(const orobi_command_t* command) {
+    if (!command) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    switch (command->type) {
+        case OROBI_COMMAND_MOTORDATA:
+        case OROBI_COMMAND_INT:
+            return OROBI_OK;
+        case OROBI_COMMAND_STARTDATA:
+            if (!__orobi_command_terminated(command->start.wifi_ssid, sizeof(command->start.wifi_ssid)) ||
+                !__orobi_command_terminated(command->start.wifi_passwd, sizeof(command->start.wifi_passwd))) {
+                return OROBI_ERROR_INVALID_COMMAND;
+            }
+            return OROBI_OK;
+        case OROBI_COMMAND_FLOAT:
+            return isfinite(command->fvalue) ? OROBI_OK : OROBI_ERROR_INVALID_COMMAND;
+        case OROBI_COMMAND_STRING:
+            return __orobi_command_terminated(command->string, sizeof(command->string)) ? OROBI_OK : OROBI_ERROR_INVALID_COMMAND;
+        case OROBI_COMMAND_USER:
+            return command->packet ? OROBI_OK : OROBI_ERROR_INVALID_COMMAND;
+        default:
+            return OROBI_ERROR_UNSUPPORTED_COMMAND;
+    }
+}
+
+orobi_error_t orobi_netpacket_parse_view(const void* data, size_t size, orobi_netpacket_view_t* view) {
+    if (!data || !view) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (size < OROBI_NETPACKET_HEADER_SIZE) {
+        return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+    }
+
+    const uint8_t* header = (const uint8_t*)data;
+    const uint8_t flags = header[1];
+    const uint16_t payload_size = orobi_read_le16(header + 4);
+
+    if ((flags & ~OROBI_NETPACKET_FLAG_COMPRESSED) != 0 ||
+        payload_size > OROBI_NETPACKET_MAXPAYLOAD ||
+        size != (size_t)OROBI_NETPACKET_HEADER_SIZE + payload_size) {
+        return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+    }
+
+    view->seq_nr = header[0];
+    view->compressed = (flags & OROBI_NETPACKET_FLAG_COMPRESSED) != 0;
+    view->api_key = orobi_read_le16(header + 2);
+    view->payload_size = payload_size;
+    view->compress_size = orobi_read_le32(header + 6);
+    view->hash = orobi_read_le32(header + 10);
+    view->payload = header + OROBI_NETPACKET_HEADER_SIZE;
+    view->timestamp_ms = 0;
+
+    if (__orobi_netpacket_check_compression(view->compressed, view->compress_size) != OROBI_OK) {
+        return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+    }
+    if (__orobi_netpacket_hash(header, view->payload, payload_size) != view->hash) {
+        return OROBI_ERROR_HASH_MISMATCH;
+    }
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_netpacket_serialize(const orobi_netpacket_view_t* view, void* buffer, size_t buffer_size, size_t* written) {
+    if (!view || !buffer || !written || (!view->payload && view->payload_size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (view->payload_size > OROBI_NETPACKET_MAXPAYLOAD ||
+        __orobi_netpacket_check_compression(view->compressed, view->compress_size) != OROBI_OK) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (buffer_size < (size_t)OROBI_NETPACKET_HEADER_SIZE + view->payload_size) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    uint8_t* header = (uint8_t*)buffer;
+    uint8_t* payload = OROBI_NETPACKET_PAYLOAD(buffer);
+    if (view->payload_size > 0 && view->payload != payload) {
+        memmove(payload, view->payload, view->payload_size);
+    }
+
+    header[0] = view->seq_nr;
+    header[1] = view->compressed ? OROBI_NETPACKET_FLAG_COMPRESSED : 0;
+    orobi_write_le16(header + 2, view->api_key);
+    orobi_write_le16(header + 4, view->payload_size);
+    orobi_write_le32(header + 6, view->compress_size);
+    orobi_write_le32(header + 10, __orobi_netpacket_hash(header, payload, view->payload_size));
+
+    *written = OROBI_NETPACKET_HEADER_SIZE + view->payload_size;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_netpacket_parse(void* data, size_t size, orobi_netpacket_t* out) {
+    if (!out) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_netpacket_view_t view;
+    orobi_error_t status = orobi_netpacket_parse_view(data, size, &view);
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    out->seq_nr = view.seq_nr;
+    out->api_key = view.api_key;
+    out->raw_packet = (void*)view.payload;
+    out->compressed = view.compressed;
+    out->compress_size = view.compressed ? view.compress_size : view.payload_size;
+    out->hash = view.hash;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_netpacket_validate(const orobi_netpacket_t* net) {
+    if (!net) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (!net->raw_packet || net->compress_size == 0 || net->compress_size > OROBI_NETPACKET_MAXPAYLOAD) {
+        return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+    }
+    return OROBI_OK;
+}
+
+// Header-Felder, die die Nutzlast interpretieren: an das verschlüsselte Paket gebunden
+static uint64_t __orobi_netpacket_bound(const orobi_netpacket_view_t* view) {
+    return (uint64_t)view->seq_nr | (uint64_t)(view->compressed ? OROBI_NETPACKET_FLAG_COMPRESSED : 0) << 8 |
+           (uint64_t)view->api_key << 16 | (uint64_t)view->compress_size << 32;
+}
+
+orobi_error_t orobi_netpacket_seal(orobi_secure_t* ctx, orobi_lz_work_t* work, orobi_packet_t* packet,
+                                   uint8_t seq_nr, uint16_t api_key, const void* message, uint16_t size,
+                                   const unsigned char* their_public_key,
+                                   void* buffer, size_t buffer_size, size_t* written) {
+    if (!ctx || !packet || !message || !their_public_key || !buffer || !written || size > OROBI_MAXMESSAGESIZE) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (buffer_size < (size_t)OROBI_NETPACKET_HEADER_SIZE + OROBI_WIRE_SIZE(size)) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    orobi_netpacket_view_t view = {
+        .seq_nr = seq_nr,
+        .api_key = api_key,
+        .compressed = false,
+        .compress_size = 0,
+        .payload = OROBI_NETPACKET_PAYLOAD(buffer)
+    };
+
+    // Komprimiert wird in den Nutzlastbereich des Sendepuffers, orobi_create_packet kopiert von dort
+    const char* body = (const char*)message;
+    uint16_t body_size = size;
+    size_t compressed_size = 0;
+    if (work && size >= OROBI_LZ_MIN_INPUT &&
+        orobi_lz_compress(work, message, size, OROBI_NETPACKET_PAYLOAD(buffer), size - 1, &compressed_size) == OROBI_OK) {
+        body = (const char*)OROBI_NETPACKET_PAYLOAD(buffer);
+        body_size = (uint16_t)compressed_size;
+        view.compressed = true;
+        view.compress_size = size;
+    }
+
+    orobi_error_t status = orobi_create_packet_bound(ctx, packet, body, body_size, __orobi_netpacket_bound(&view));
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    size_t wire_size = 0;
+    status = orobi_encode_packet(ctx, packet, their_public_key, OROBI_NETPACKET_PAYLOAD(buffer),
+                                 buffer_size - OROBI_NETPACKET_HEADER_SIZE, &wire_size);
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    view.payload_size = (uint16_t)wire_size;
+    return orobi_netpacket_serialize(&view, buffer, buffer_size, written);
+}
+
+orobi_error_t orobi_netpacket_open(orobi_secure_t* ctx, const void* data, size_t size,
+                                   const unsigned char* their_public_key, orobi_packet_t* packet,
+                                   uint8_t* inflate_buffer, size_t inflate_size, orobi_netpacket_view_t* view,
+                                   const uint8_t** message, size_t* message_size) {
+    if (!ctx || !packet || !view || !message || !message_size) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_error_t status = orobi_netpacket_parse_view(data, size, view);
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    status = orobi_decode_packet_bound(ctx, view->payload, view->payload_size, __orobi_netpacket_bound(view),
+                                       packet, their_public_key);
+    if (status != OROBI_OK) {
+        return status;
+    }
+    view->timestamp_ms = packet->timestamp_ms;
+
+    if (!view->compressed) {
+        *message = (const uint8_t*)packet->message;
+        *message_size = packet->message_size;
+        return OROBI_OK;
+    }
+
+    if (!inflate_buffer || inflate_size < view->compress_size) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+    status = orobi_lz_decompress(packet->message, packet->message_size, inflate_buffer, view->compress_size);
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    *message = inflate_buffer;
+    *message_size = view->compress_size;
+    return OROBI_OK;
+}
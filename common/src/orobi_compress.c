@@ -0,0 +1,256 @@
+#include "orobi_compress.h"
+#include <string.h>
+
+enum {
+    OROBI_LZ_STATE_TOKEN,
+    OROBI_LZ_STATE_LITLEN,
+    OROBI_LZ_STATE_LITERALS,
+    OROBI_LZ_STATE_OFFSET_LO,
+    OROBI_LZ_STATE_OFFSET_HI,
+    OROBI_LZ_STATE_MATCHLEN,
+    OROBI_LZ_STATE_DONE
+};
+
+static inline uint32_t __orobi_lz_hash(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(uint32_t));
+    return (v * 2654435761u) >> (32 - OROBI_LZ_HASH_BITS);
+}
+
+// Schreibt eine Längen-Erweiterung (255, 255, ..., Rest); false bei vollem Ausgabepuffer
+static bool __orobi_lz_put_length(uint8_t** op, const uint8_t* oend, size_t len) {
+    uint8_t* o = *op;
+    while (len >= 255) {
+        if (o >= oend) {
+            return false;
+        }
+        *o++ = 255;
+        len -= 255;
+    }
+    if (o >= oend) {
+        return false;
+    }
+    *o++ = (uint8_t)len;
+    *op = o;
+    return true;
+}
+
+// Schreibt eine Sequenz; match_len == 0 kennzeichnet die letzte Sequenz (nur Literale)
+static bool __orobi_lz_put_sequence(uint8_t** op, const uint8_t* oend, const uint8_t* literals,
+                                    size_t literal_len, uint16_t offset, size_t match_len) {
+    uint8_t* o = *op;
+    const size_t ml = match_len ? match_len - OROBI_LZ_MIN_MATCH : 0;
+
+    if (o >= oend) {
+        return false;
+    }
+    uint8_t* token = o++;
+    *token = (uint8_t)(((literal_len < 15 ? literal_len : 15) << 4) | (ml < 15 ? ml : 15));
+
+    if (literal_len >= 15 && !__orobi_lz_put_length(&o, oend, literal_len - 15)) {
+        return false;
+    }
+    if ((size_t)(oend - o) < literal_len) {
+        return false;
+    }
+    memcpy(o, literals, literal_len);
+    o += literal_len;
+
+    if (match_len) {
+        if (oend - o < 2) {
+            return false;
+        }
+        orobi_write_le16(o, offset);
+        o += 2;
+        if (ml >= 15 && !__orobi_lz_put_length(&o, oend, ml - 15)) {
+            return false;
+        }
+    }
+
+    *op = o;
+    return true;
+}
+
+orobi_error_t orobi_lz_compress(orobi_lz_work_t* work, const void* src, size_t size,
+                                void* dst, size_t dst_size, size_t* written) {
+    if (!work || (!src && size > 0) || !dst || !written || size > OROBI_LZ_MAX_INPUT) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    const uint8_t* in = (const uint8_t*)src;
+    uint8_t* op = (uint8_t*)dst;
+    const uint8_t* oend = op + dst_size;
+    size_t ip = 0;
+    size_t anchor = 0;
+
+    memset(work->table, 0, sizeof(work->table));
+
+    // Greedy-Suche über eine Hash-Tabelle der letzten Position je 4-Byte-Präfix
+    while (ip + OROBI_LZ_MIN_MATCH <= size) {
+        const uint32_t h = __orobi_lz_hash(in + ip);
+        const size_t ref = work->table[h];
+        work->table[h] = (uint16_t)ip;
+
+        if (ref >= ip || memcmp(in + ref, in + ip, OROBI_LZ_MIN_MATCH) != 0) {
+            ip++;
+            continue;
+        }
+
+        size_t len = OROBI_LZ_MIN_MATCH;
+        while (ip + len < size && in[ref + len] == in[ip + len]) {
+            len++;
+        }
+
+        if (!__orobi_lz_put_sequence(&op, oend, in + anchor, ip - anchor, (uint16_t)(ip - ref), len)) {
+            return OROBI_ERROR_BUFFER_OVERFLOW;
+        }
+        ip += len;
+        anchor = ip;
+    }
+
+    if (anchor < size && !__orobi_lz_put_sequence(&op, oend, in + anchor, size - anchor, 0, 0)) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    *written = (size_t)(op - (uint8_t*)dst);
+    return OROBI_OK;
+}
+
+void orobi_lz_decoder_init(orobi_lz_decoder_t* dec, void* out, size_t original_size) {
+    memset(dec, 0, sizeof(orobi_lz_decoder_t));
+    dec->out = (uint8_t*)out;
+    dec->out_size = original_size;
+    dec->state = original_size ? OROBI_LZ_STATE_TOKEN : OROBI_LZ_STATE_DONE;
+}
+
+bool orobi_lz_decoder_done(const orobi_lz_decoder_t* dec) {
+    return dec->out_pos == dec->out_size &&
+           (dec->state == OROBI_LZ_STATE_TOKEN || dec->state == OROBI_LZ_STATE_DONE);
+}
+
+// Nach den Literalen: Ende des Blocks oder Offset des Matches
+static void __orobi_lz_literals_done(orobi_lz_decoder_t* dec) {
+    dec->state = (dec->out_pos == dec->out_size) ? OROBI_LZ_STATE_DONE : OROBI_LZ_STATE_OFFSET_LO;
+}
+
+// Kopiert den Match (darf sich mit der Ausgabe überlappen)
+static orobi_error_t __orobi_lz_copy_match(orobi_lz_decoder_t* dec) {
+    if (dec->match_len > dec->out_size - dec->out_pos) {
+        return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+    }
+
+    uint8_t* o = dec->out + dec->out_pos;
+    const uint8_t* m = o - dec->offset;
+    if (dec->offset >= dec->match_len) {
+        memcpy(o, m, dec->match_len);
+    } else {
+        for (size_t i = 0; i < dec->match_len; i++) {
+            o[i] = m[i];
+        }
+    }
+    dec->out_pos += dec->match_len;
+    dec->state = OROBI_LZ_STATE_TOKEN;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_lz_decoder_update(orobi_lz_decoder_t* dec, const void* data, size_t size) {
+    if (!dec || (!data && size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + size;
+
+    while (p < end) {
+        switch (dec->state) {
+            case OROBI_LZ_STATE_TOKEN: {
+                if (dec->out_pos == dec->out_size) {
+                    return OROBI_ERROR_PACKET_VALIDATION_FAILED;  // Daten nach Blockende
+                }
+                const uint8_t token = *p++;
+                dec->literal_left = token >> 4;
+                dec->match_len = (token & 15) + OROBI_LZ_MIN_MATCH;
+                if (dec->literal_left == 15) {
+                    dec->state = OROBI_LZ_STATE_LITLEN;
+                } else if (dec->literal_left > 0) {
+                    dec->state = OROBI_LZ_STATE_LITERALS;
+                } else {
+                    __orobi_lz_literals_done(dec);
+                }
+                break;
+            }
+            case OROBI_LZ_STATE_LITLEN: {
+                const uint8_t b = *p++;
+                dec->literal_left += b;
+                if (dec->literal_left > dec->out_size - dec->out_pos) {
+                    return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+                }
+                if (b != 255) {
+                    dec->state = OROBI_LZ_STATE_LITERALS;
+                }
+                break;
+            }
+            case OROBI_LZ_STATE_LITERALS: {
+                if (dec->literal_left > dec->out_size - dec->out_pos) {
+                    return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+                }
+                size_t n = (size_t)(end - p);
+                if (n > dec->literal_left) {
+                    n = dec->literal_left;
+                }
+                memcpy(dec->out + dec->out_pos, p, n);
+                p += n;
+                dec->out_pos += n;
+                dec->literal_left -= n;
+                if (dec->literal_left == 0) {
+                    __orobi_lz_literals_done(dec);
+                }
+                break;
+            }
+            case OROBI_LZ_STATE_OFFSET_LO:
+                dec->offset = *p++;
+                dec->state = OROBI_LZ_STATE_OFFSET_HI;
+                break;
+            case OROBI_LZ_STATE_OFFSET_HI:
+                dec->offset |= (uint16_t)(*p++) << 8;
+                if (dec->offset == 0 || dec->offset > dec->out_pos) {
+                    return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+                }
+                if (dec->match_len == 15 + OROBI_LZ_MIN_MATCH) {
+                    dec->state = OROBI_LZ_STATE_MATCHLEN;
+                } else if (__orobi_lz_copy_match(dec) != OROBI_OK) {
+                    return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+                }
+                break;
+            case OROBI_LZ_STATE_MATCHLEN: {
+                const uint8_t b = *p++;
+                dec->match_len += b;
+                if (dec->match_len > dec->out_size - dec->out_pos) {
+                    return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+                }
+                if (b != 255 && __orobi_lz_copy_match(dec) != OROBI_OK) {
+                    return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+                }
+                break;
+            }
+            default:
+                return OROBI_ERROR_PACKET_VALIDATION_FAILED;  // Daten nach Blockende
+        }
+    }
+
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_lz_decompress(const void* src, size_t size, void* dst, size_t original_size) {
+    if (!dst && original_size > 0) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_lz_decoder_t dec;
+    orobi_lz_decoder_init(&dec, dst, original_size);
+    orobi_error_t status = orobi_lz_decoder_update(&dec, src, size);
+    if (status != OROBI_OK) {
+        return status;
+    }
+    return orobi_lz_decoder_done(&dec) ? OROBI_OK : OROBI_ERROR_PACKET_VALIDATION_FAILED;
+}
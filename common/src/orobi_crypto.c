@@ -0,0 +1,547 @@
+#include "orobi_crypto.h"
+#include "orobi_packet.h"
+#include "tweetnacl.h"
+#include <string.h>
+
+// XSalsa20-Poly1305 wie crypto_secretbox in NaCl:
+//   Teilschlüssel = HSalsa20(k, n[0..16]), Keystream = Salsa20(Teilschlüssel, n[16..24]) ab Block 0.
+//   Die ersten 32 Keystream-Bytes sind der Poly1305-Schlüssel, verschlüsselt wird ab Byte 32.
+
+#define __OROBI_ROTL32(v, n)    (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define __OROBI_SALSA_QR(a, b, c, d)        \
+    do {                                    \
+        b ^= __OROBI_ROTL32(a + d, 7);      \
+        c ^= __OROBI_ROTL32(b + a, 9);      \
+        d ^= __OROBI_ROTL32(c + b, 13);     \
+        a ^= __OROBI_ROTL32(d + c, 18);     \
+    } while (0)
+
+// 20 Runden auf x (Spalten- und Zeilenrunden im Wechsel). Mit skalarem T einzeln, mit Vektortyp blockweise parallel.
+#define __OROBI_SALSA_ROUNDS(x)                                     \
+    for (int round = 0; round < 20; round += 2) {                   \
+        __OROBI_SALSA_QR(x[0], x[4], x[8], x[12]);                  \
+        __OROBI_SALSA_QR(x[5], x[9], x[13], x[1]);                  \
+        __OROBI_SALSA_QR(x[10], x[14], x[2], x[6]);                 \
+        __OROBI_SALSA_QR(x[15], x[3], x[7], x[11]);                 \
+        __OROBI_SALSA_QR(x[0], x[1], x[2], x[3]);                   \
+        __OROBI_SALSA_QR(x[5], x[6], x[7], x[4]);                   \
+        __OROBI_SALSA_QR(x[10], x[11], x[8], x[9]);                 \
+        __OROBI_SALSA_QR(x[15], x[12], x[13], x[14]);               \
+    }
+
+#define OROBI_SALSA_BLOCK       64
+#define OROBI_SALSA_LANES       8       // Blöcke pro Durchlauf des Vektorkerns
+
+static const uint32_t __orobi_sigma[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };  // "expand 32-byte k"
+
+static void __orobi_salsa_setup(uint32_t state[16], const uint8_t key[32], const uint8_t* input, size_t input_size) {
+    state[0] = __orobi_sigma[0];
+    state[5] = __orobi_sigma[1];
+    state[10] = __orobi_sigma[2];
+    state[15] = __orobi_sigma[3];
+    for (int i = 0; i < 4; i++) {
+        state[1 + i] = orobi_read_le32(key + 4 * i);
+        state[11 + i] = orobi_read_le32(key + 16 + 4 * i);
+    }
+    // Salsa20: Nonce (8) und Blockzähler (8, ab 0), HSalsa20: 16 Bytes Nonce
+    state[6] = orobi_read_le32(input);
+    state[7] = orobi_read_le32(input + 4);
+    state[8] = input_size == 16 ? orobi_read_le32(input + 8) : 0;
+    state[9] = input_size == 16 ? orobi_read_le32(input + 12) : 0;
+}
+
+static void __orobi_hsalsa20(uint8_t out[32], const uint8_t key[32], const uint8_t nonce[16]) {
+    uint32_t x[16];
+    __orobi_salsa_setup(x, key, nonce, 16);
+    __OROBI_SALSA_ROUNDS(x);
+
+    static const int words[8] = { 0, 5, 10, 15, 6, 7, 8, 9 };
+    for (int i = 0; i < 8; i++) {
+        orobi_write_le32(out + 4 * i, x[words[i]]);
+    }
+}
+
+static inline void __orobi_salsa_advance(uint32_t state[16], uint32_t blocks) {
+    const uint64_t counter = ((uint64_t)state[9] << 32 | state[8]) + blocks;
+    state[8] = (uint32_t)counter;
+    state[9] = (uint32_t)(counter >> 32);
+}
+
+// Ein Block, 32-Bit skalar (ESP32, Reste auf dem Host). Zustand bleibt in Registern.
+static void __orobi_salsa20_block(uint8_t out[OROBI_SALSA_BLOCK], uint32_t state[16]) {
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+    __OROBI_SALSA_ROUNDS(x);
+    for (int i = 0; i < 16; i++) {
+        orobi_write_le32(out + 4 * i, x[i] + state[i]);
+    }
+    __orobi_salsa_advance(state, 1);
+}
+
+static void __orobi_salsa20_xor_scalar(uint8_t* out, const uint8_t* in, size_t len, uint32_t state[16]) {
+    // Volle Blöcke wortweise
+    while (len >= OROBI_SALSA_BLOCK) {
+        uint32_t x[16];
+        memcpy(x, state, sizeof(x));
+        __OROBI_SALSA_ROUNDS(x);
+        for (int i = 0; i < 16; i++) {
+            orobi_write_le32(out + 4 * i, orobi_read_le32(in + 4 * i) ^ (x[i] + state[i]));
+        }
+        __orobi_salsa_advance(state, 1);
+        out += OROBI_SALSA_BLOCK;
+        in += OROBI_SALSA_BLOCK;
+        len -= OROBI_SALSA_BLOCK;
+    }
+    if (len > 0) {
+        uint8_t block[OROBI_SALSA_BLOCK];
+        __orobi_salsa20_block(block, state);
+        for (size_t i = 0; i < len; i++) {
+            out[i] = in[i] ^ block[i];
+        }
+        memset(block, 0, sizeof(block));
+    }
+}
+
+#ifndef ESP32
+// Acht Blöcke parallel: jedes Zustandswort ist ein Vektor über die Blöcke (Block i = Spur i).
+// Ohne AVX2 zerlegt der Compiler die 256-Bit-Vektoren in SSE2-Paare.
+typedef uint32_t __orobi_salsa_vec_t __attribute__((vector_size(4 * OROBI_SALSA_LANES)));
+
+static inline __attribute__((always_inline))
+void __orobi_salsa20_xor_kernel(uint8_t* out, const uint8_t* in, size_t len, uint32_t state[16]) {
+    // Kurze Nachrichten: Aufbau und Transponieren lohnen sich erst ab einigen Blöcken
+    while (len > 2 * OROBI_SALSA_BLOCK) {
+        __orobi_salsa_vec_t x[16], input[16];
+        for (int w = 0; w < 16; w++) {
+            input[w] = (__orobi_salsa_vec_t){ 0 } + state[w];
+        }
+        for (uint32_t l = 0; l < OROBI_SALSA_LANES; l++) {
+            const uint64_t counter = ((uint64_t)state[9] << 32 | state[8]) + l;
+            input[8][l] = (uint32_t)counter;
+            input[9][l] = (uint32_t)(counter >> 32);
+        }
+        memcpy(x, input, sizeof(x));
+        __OROBI_SALSA_ROUNDS(x);
+
+        uint32_t keystream[16][OROBI_SALSA_LANES];
+        for (int w = 0; w < 16; w++) {
+            const __orobi_salsa_vec_t sum = x[w] + input[w];
+            memcpy(keystream[w], &sum, sizeof(sum));
+        }
+
+        const size_t chunk = len < OROBI_SALSA_LANES * OROBI_SALSA_BLOCK ? len : OROBI_SALSA_LANES * OROBI_SALSA_BLOCK;
+        const uint32_t blocks = (uint32_t)(chunk / OROBI_SALSA_BLOCK);
+        for (uint32_t l = 0; l < blocks; l++) {
+            const uint8_t* src = in + l * OROBI_SALSA_BLOCK;
+            uint8_t* dst = out + l * OROBI_SALSA_BLOCK;
+            for (int w = 0; w < 16; w++) {
+                orobi_write_le32(dst + 4 * w, orobi_read_le32(src + 4 * w) ^ keystream[w][l]);
+            }
+        }
+        const size_t rest = chunk - blocks * OROBI_SALSA_BLOCK;
+        for (size_t i = 0; i < rest; i++) {
+            const size_t pos = blocks * OROBI_SALSA_BLOCK + i;
+            out[pos] = in[pos] ^ (uint8_t)(keystream[i / 4][blocks] >> (8 * (i & 3)));
+        }
+
+        __orobi_salsa_advance(state, blocks + (rest > 0));
+        out += chunk;
+        in += chunk;
+        len -= chunk;
+    }
+    __orobi_salsa20_xor_scalar(out, in, len, state);
+}
+
+static void __orobi_salsa20_xor_vec(uint8_t* out, const uint8_t* in, size_t len, uint32_t state[16]) {
+    __orobi_salsa20_xor_kernel(out, in, len, state);
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define OROBI_CRYPTO_DISPATCH 1
+__attribute__((target("avx2")))
+static void __orobi_salsa20_xor_avx2(uint8_t* out, const uint8_t* in, size_t len, uint32_t state[16]) {
+    __orobi_salsa20_xor_kernel(out, in, len, state);
+}
+#endif
+#endif // ESP32
+
+typedef void (*orobi_salsa20_xor_fn_t)(uint8_t* out, const uint8_t* in, size_t len, uint32_t state[16]);
+static orobi_salsa20_xor_fn_t __orobi_salsa20_xor_impl = NULL;
+static const char* __orobi_native_name = "native";
+
+// Wählt beim ersten Aufruf den Salsa20-Kern passend zur CPU (ESP32: immer skalar)
+static orobi_salsa20_xor_fn_t __orobi_salsa20_xor_resolve(void) {
+#ifdef ESP32
+    orobi_salsa20_xor_fn_t fn = __orobi_salsa20_xor_scalar;
+    __orobi_native_name = "native-scalar32";
+#else
+    orobi_salsa20_xor_fn_t fn = __orobi_salsa20_xor_vec;
+    __orobi_native_name = "native-vec";
+#ifdef OROBI_CRYPTO_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        fn = __orobi_salsa20_xor_avx2;
+        __orobi_native_name = "native-avx2";
+    }
+#endif
+#endif
+    __orobi_salsa20_xor_impl = fn;
+    return fn;
+}
+
+static void __orobi_salsa20_xor(uint8_t* out, const uint8_t* in, size_t len, uint32_t state[16]) {
+    orobi_salsa20_xor_fn_t fn = __orobi_salsa20_xor_impl;
+    if (!fn) {
+        fn = __orobi_salsa20_xor_resolve();
+    }
+    fn(out, in, len, state);
+}
+
+#if defined(__SIZEOF_INT128__) && !defined(OROBI_POLY1305_32)
+// Poly1305 mit drei 44/44/42-Bit-Limbs und 64x64->128 Multiplikation (Host)
+static void __orobi_poly1305(uint8_t out[16], const uint8_t* m, size_t len, const uint8_t key[32]) {
+    typedef unsigned __int128 u128;
+    const uint64_t mask44 = 0xfffffffffffULL, mask42 = 0x3ffffffffffULL;
+
+    uint64_t t0 = orobi_read_le64(key), t1 = orobi_read_le64(key + 8);
+    const uint64_t r0 = t0 & 0xffc0fffffffULL;
+    const uint64_t r1 = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+    const uint64_t r2 = (t1 >> 24) & 0x00ffffffc0fULL;
+    const uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+    uint64_t h0 = 0, h1 = 0, h2 = 0, c;
+
+    while (len > 0) {
+        uint8_t block[16];
+        const uint8_t* p = m;
+        uint64_t hibit = 1ULL << 40;
+        if (len < 16) {
+            memset(block, 0, sizeof(block));
+            memcpy(block, m, len);
+            block[len] = 1;
+            p = block;
+            hibit = 0;
+        }
+        t0 = orobi_read_le64(p);
+        t1 = orobi_read_le64(p + 8);
+        h0 += t0 & mask44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & mask44;
+        h2 += ((t1 >> 24) & mask42) | hibit;
+
+        const u128 d0 = (u128)h0 * r0 + (u128)h1 * s2 + (u128)h2 * s1;
+        u128 d1 = (u128)h0 * r1 + (u128)h1 * r0 + (u128)h2 * s2;
+        u128 d2 = (u128)h0 * r2 + (u128)h1 * r1 + (u128)h2 * r0;
+        c = (uint64_t)(d0 >> 44); h0 = (uint64_t)d0 & mask44;
+        d1 += c; c = (uint64_t)(d1 >> 44); h1 = (uint64_t)d1 & mask44;
+        d2 += c; c = (uint64_t)(d2 >> 42); h2 = (uint64_t)d2 & mask42;
+        h0 += c * 5; c = h0 >> 44; h0 &= mask44;
+        h1 += c;
+
+        const size_t n = len < 16 ? len : 16;
+        m += n;
+        len -= n;
+    }
+
+    // Vollständig reduzieren, h mod 2^130-5
+    c = h1 >> 44; h1 &= mask44; h2 += c;
+    c = h2 >> 42; h2 &= mask42; h0 += c * 5;
+    c = h0 >> 44; h0 &= mask44; h1 += c;
+    c = h1 >> 44; h1 &= mask44; h2 += c;
+    c = h2 >> 42; h2 &= mask42; h0 += c * 5;
+    c = h0 >> 44; h0 &= mask44; h1 += c;
+
+    uint64_t g0 = h0 + 5; c = g0 >> 44; g0 &= mask44;
+    uint64_t g1 = h1 + c; c = g1 >> 44; g1 &= mask44;
+    uint64_t g2 = h2 + c - (1ULL << 42);
+    c = (g2 >> 63) - 1;     // alle Bits gesetzt, wenn h >= p
+    h0 = (h0 & ~c) | (g0 & c);
+    h1 = (h1 & ~c) | (g1 & c);
+    h2 = (h2 & ~c) | (g2 & c);
+
+    // h + s mod 2^128
+    t0 = orobi_read_le64(key + 16);
+    t1 = orobi_read_le64(key + 24);
+    h0 += t0 & mask44; c = h0 >> 44; h0 &= mask44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & mask44) + c; c = h1 >> 44; h1 &= mask44;
+    h2 += ((t1 >> 24) & mask42) + c; h2 &= mask42;
+
+    orobi_write_le64(out, h0 | (h1 << 44));
+    orobi_write_le64(out + 8, (h1 >> 20) | (h2 << 24));
+}
+#else
+// Poly1305 mit fünf 26-Bit-Limbs, nur 32x32->64 Multiplikationen (ESP32: Xtensa/RISC-V ohne 64-Bit-Multiplikation)
+static void __orobi_poly1305(uint8_t out[16], const uint8_t* m, size_t len, const uint8_t key[32]) {
+    const uint32_t mask = 0x3ffffff;
+    const uint32_t r0 = orobi_read_le32(key) & 0x3ffffff;
+    const uint32_t r1 = (orobi_read_le32(key + 3) >> 2) & 0x3ffff03;
+    const uint32_t r2 = (orobi_read_le32(key + 6) >> 4) & 0x3ffc0ff;
+    const uint32_t r3 = (orobi_read_le32(key + 9) >> 6) & 0x3f03fff;
+    const uint32_t r4 = (orobi_read_le32(key + 12) >> 8) & 0x00fffff;
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = 0, h1 = 0, h2 = 0, h3 = 0, h4 = 0, c;
+
+    while (len > 0) {
+        uint8_t block[16];
+        const uint8_t* p = m;
+        uint32_t hibit = 1u << 24;
+        if (len < 16) {
+            memset(block, 0, sizeof(block));
+            memcpy(block, m, len);
+            block[len] = 1;
+            p = block;
+            hibit = 0;
+        }
+        h0 += orobi_read_le32(p) & mask;
+        h1 += (orobi_read_le32(p + 3) >> 2) & mask;
+        h2 += (orobi_read_le32(p + 6) >> 4) & mask;
+        h3 += (orobi_read_le32(p + 9) >> 6) & mask;
+        h4 += (orobi_read_le32(p + 12) >> 8) | hibit;
+
+        const uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+        c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & mask;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & mask;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & mask;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & mask;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & mask;
+        h0 += c * 5; c = h0 >> 26; h0 &= mask;
+        h1 += c;
+
+        const size_t n = len < 16 ? len : 16;
+        m += n;
+        len -= n;
+    }
+
+    // Vollständig reduzieren, h mod 2^130-5
+    c = h1 >> 26; h1 &= mask; h2 += c;
+    c = h2 >> 26; h2 &= mask; h3 += c;
+    c = h3 >> 26; h3 &= mask; h4 += c;
+    c = h4 >> 26; h4 &= mask; h0 += c * 5;
+    c = h0 >> 26; h0 &= mask; h1 += c;
+
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= mask;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= mask;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= mask;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= mask;
+    uint32_t g4 = h4 + c - (1u << 26);
+    c = (g4 >> 31) - 1;     // alle Bits gesetzt, wenn h >= p
+    h0 = (h0 & ~c) | (g0 & c);
+    h1 = (h1 & ~c) | (g1 & c);
+    h2 = (h2 & ~c) | (g2 & c);
+    h3 = (h3 & ~c) | (g3 & c);
+    h4 = (h4 & ~c) | (g4 & c);
+
+    // h + s mod 2^128
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+    uint64_t f = (uint64_t)h0 + orobi_read_le32(key + 16);
+    orobi_write_le32(out, (uint32_t)f);
+    f = (uint64_t)h1 + orobi_read_le32(key + 20) + (f >> 32);
+    orobi_write_le32(out + 4, (uint32_t)f);
+    f = (uint64_t)h2 + orobi_read_le32(key + 24) + (f >> 32);
+    orobi_write_le32(out + 8, (uint32_t)f);
+    f = (uint64_t)h3 + orobi_read_le32(key + 28) + (f >> 32);
+    orobi_write_le32(out + 12, (uint32_t)f);
+}
+#endif
+
+static int __orobi_native_box(unsigned char* c, const unsigned char* m, unsigned long long mlen,
+                              const unsigned char* n, const unsigned char* k) {
+    if (mlen < crypto_box_ZEROBYTES) {
+        return -1;
+    }
+
+    uint8_t subkey[32];
+    uint32_t state[16];
+    __orobi_hsalsa20(subkey, k, n);
+    __orobi_salsa_setup(state, subkey, n + 16, 8);
+
+    // m beginnt mit 32 Nullbytes: c[0..32] ist danach der Poly1305-Schlüssel
+    __orobi_salsa20_xor(c, m, (size_t)mlen, state);
+    uint8_t tag[16];
+    __orobi_poly1305(tag, c + crypto_box_ZEROBYTES, (size_t)mlen - crypto_box_ZEROBYTES, c);
+    memset(c, 0, crypto_box_BOXZEROBYTES);
+    memcpy(c + crypto_box_BOXZEROBYTES, tag, sizeof(tag));
+
+    memset(subkey, 0, sizeof(subkey));
+    memset(state, 0, sizeof(state));
+    return 0;
+}
+
+static int __orobi_native_box_open(unsigned char* m, const unsigned char* c, unsigned long long clen,
+                                   const unsigned char* n, const unsigned char* k) {
+    if (clen < crypto_box_ZEROBYTES) {
+        return -1;
+    }
+
+    uint8_t subkey[32];
+    uint8_t block[OROBI_SALSA_BLOCK];
+    uint32_t state[16];
+    __orobi_hsalsa20(subkey, k, n);
+    __orobi_salsa_setup(state, subkey, n + 16, 8);
+    __orobi_salsa20_block(block, state);
+
+    uint8_t tag[16];
+    __orobi_poly1305(tag, c + crypto_box_ZEROBYTES, (size_t)clen - crypto_box_ZEROBYTES, block);
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; i++) {
+        diff |= tag[i] ^ c[crypto_box_BOXZEROBYTES + i];
+    }
+
+    int rc = -1;
+    if (diff == 0) {
+        // Rest von Block 0 direkt, ab Block 1 über den Kern
+        const size_t first = clen < OROBI_SALSA_BLOCK ? (size_t)clen : OROBI_SALSA_BLOCK;
+        for (size_t i = crypto_box_ZEROBYTES; i < first; i++) {
+            m[i] = c[i] ^ block[i];
+        }
+        __orobi_salsa20_xor(m + first, c + first, (size_t)clen - first, state);
+        memset(m, 0, crypto_box_ZEROBYTES);
+        rc = 0;
+    }
+
+    memset(subkey, 0, sizeof(subkey));
+    memset(block, 0, sizeof(block));
+    memset(state, 0, sizeof(state));
+    return rc;
+}
+
+static int __orobi_nacl_box(unsigned char* c, const unsigned char* m, unsigned long long mlen,
+                            const unsigned char* n, const unsigned char* k) {
+    return crypto_box_afternm(c, m, mlen, n, k);
+}
+
+static int __orobi_nacl_box_open(unsigned char* m, const unsigned char* c, unsigned long long clen,
+                                 const unsigned char* n, const unsigned char* k) {
+    return crypto_box_open_afternm(m, c, clen, n, k);
+}
+
+typedef int (*orobi_box_fn_t)(unsigned char* out, const unsigned char* in, unsigned long long len,
+                              const unsigned char* n, const unsigned char* k);
+
+typedef struct {
+    orobi_box_fn_t  box;
+    orobi_box_fn_t  open;
+} orobi_crypto_ops_t;
+
+static const orobi_crypto_ops_t __orobi_crypto_table[] = {
+    [OROBI_CRYPTO_NACL]   = { __orobi_nacl_box, __orobi_nacl_box_open },
+    [OROBI_CRYPTO_NATIVE] = { __orobi_native_box, __orobi_native_box_open }
+};
+#define OROBI_CRYPTO_BACKENDS   (sizeof(__orobi_crypto_table) / sizeof(__orobi_crypto_table[0]))
+
+static const orobi_crypto_ops_t* __orobi_crypto_ops = NULL;
+static orobi_crypto_backend_t __orobi_crypto_backend = OROBI_CRYPTO_NACL;
+
+// Testvektoren: Schlüssel, Nonce und Nachricht deterministisch erzeugt, erwartet ist Murmur3-64 (Seed 0)
+// über die vollständige Box der NaCl-Referenz. Die Längen decken leere Nachrichten, Blockgrenzen,
+// den skalaren Rest und mehrere Durchläufe des 8-Block-Kerns ab.
+static const struct {
+    uint16_t    size;       // Nachricht ohne crypto_box_ZEROBYTES
+    uint64_t    digest;
+} __orobi_crypto_vectors[] = {
+    { 0,    0x06d7e38344979b3eULL },
+    { 1,    0xad0c5e2efb054c37ULL },
+    { 31,   0x1ce3a3e817420a47ULL },
+    { 32,   0xc105beb14c0a1348ULL },
+    { 95,   0xbf97f5b725236817ULL },
+    { 131,  0x0bb41c1c11d412c4ULL },
+    { 600,  0xb7b541ea79f31ae8ULL },
+    { 1100, 0x77a6bf5ac17a270bULL }
+};
+#define OROBI_CRYPTO_TEST_MAX   (1100 + crypto_box_ZEROBYTES)
+
+orobi_error_t orobi_crypto_self_test(orobi_crypto_backend_t backend) {
+    if ((unsigned)backend >= OROBI_CRYPTO_BACKENDS) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+    const orobi_crypto_ops_t* ops = &__orobi_crypto_table[backend];
+
+    static uint8_t plain[OROBI_CRYPTO_TEST_MAX], cipher[OROBI_CRYPTO_TEST_MAX], opened[OROBI_CRYPTO_TEST_MAX];
+    uint8_t key[32], nonce[crypto_box_NONCEBYTES];
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)(i * 7 + 1);
+    }
+    for (int i = 0; i < crypto_box_NONCEBYTES; i++) {
+        nonce[i] = (uint8_t)(0xA0 + i);
+    }
+    memset(plain, 0, crypto_box_ZEROBYTES);
+    for (size_t i = crypto_box_ZEROBYTES; i < sizeof(plain); i++) {
+        plain[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    for (size_t v = 0; v < sizeof(__orobi_crypto_vectors) / sizeof(__orobi_crypto_vectors[0]); v++) {
+        const size_t size = crypto_box_ZEROBYTES + __orobi_crypto_vectors[v].size;
+        if (ops->box(cipher, plain, size, nonce, key) != 0 ||
+            orobi_murmur3_64(cipher, size, 0) != __orobi_crypto_vectors[v].digest ||
+            ops->open(opened, cipher, size, nonce, key) != 0 ||
+            memcmp(opened, plain, size) != 0) {
+            return OROBI_ERROR_CRYPTOGRAPHIC_FAILURE;
+        }
+        // Manipuliertes Chiffrat bzw. manipulierter Authenticator
+        cipher[size - 1] ^= 0x01;
+        if (ops->open(opened, cipher, size, nonce, key) == 0) {
+            return OROBI_ERROR_CRYPTOGRAPHIC_FAILURE;
+        }
+    }
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_crypto_set_backend(orobi_crypto_backend_t backend) {
+    const orobi_error_t status = orobi_crypto_self_test(backend);
+    if (status != OROBI_OK) {
+        return status;
+    }
+    __orobi_crypto_backend = backend;
+    __orobi_crypto_ops = &__orobi_crypto_table[backend];
+    return OROBI_OK;
+}
+
+// Beim ersten Aufruf: Standard-Backend, sofern der Selbsttest besteht
+static const orobi_crypto_ops_t* __orobi_crypto_resolve(void) {
+    if (orobi_crypto_set_backend(OROBI_CRYPTO_DEFAULT) != OROBI_OK) {
+        __orobi_crypto_backend = OROBI_CRYPTO_NACL;
+        __orobi_crypto_ops = &__orobi_crypto_table[OROBI_CRYPTO_NACL];
+    }
+    return __orobi_crypto_ops;
+}
+
+orobi_crypto_backend_t orobi_crypto_get_backend(void) {
+    if (!__orobi_crypto_ops) {
+        __orobi_crypto_resolve();
+    }
+    return __orobi_crypto_backend;
+}
+
+const char* orobi_crypto_backend_name(void) {
+    if (orobi_crypto_get_backend() == OROBI_CRYPTO_NACL) {
+        return "nacl";
+    }
+    if (!__orobi_salsa20_xor_impl) {
+        __orobi_salsa20_xor_resolve();
+    }
+    return __orobi_native_name;
+}
+
+int orobi_crypto_box_afternm(unsigned char* c, const unsigned char* m, unsigned long long mlen,
+                             const unsigned char* n, const unsigned char* k) {
+    const orobi_crypto_ops_t* ops = __orobi_crypto_ops;
+    if (!ops) {
+        ops = __orobi_crypto_resolve();
+    }
+    return ops->box(c, m, mlen, n, k);
+}
+
+int orobi_crypto_box_open_afternm(unsigned char* m, const unsigned char* c, unsigned long long clen,
+                                  const unsigned char* n, const unsigned char* k) {
+    const orobi_crypto_ops_t* ops = __orobi_crypto_ops;
+    if (!ops) {
+        ops = __orobi_crypto_resolve();
+    }
+    return ops->open(m, c, clen, n, k);
+}
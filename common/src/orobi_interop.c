@@ -0,0 +1,157 @@
+#include "orobi_interop.h"
+#include "orobi_command.h"
+#include "orobi_crypto.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct orobi_interop {
+    orobi_secure_t*     secure;         // eigene Allokation, orobi_secure_close gibt sie frei
+    orobi_packet_t      packet;
+    orobi_lz_work_t     lz_work;
+    uint8_t             inflate[OROBI_MAXMESSAGESIZE];
+    orobi_clock_t       clock;          // Master der Sitzungsuhr
+    uint32_t            rx_ms;          // lokale Zeit des letzten orobi_interop_open, t2 für clock_reply
+    orobi_error_t       last_status;    // auch Fehler, die nicht über den Kontext laufen (Parsen, Puffergröße)
+};
+
+orobi_error_t orobi_interop_create(orobi_interop_t** handle, uint64_t id_high, uint64_t id_low,
+                                   const uint8_t* public_key, const uint8_t* secret_key) {
+    if (!handle) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    *handle = NULL;
+    if (!public_key || !secret_key) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_interop_t* h = calloc(1, sizeof(orobi_interop_t));
+    if (!h) {
+        return OROBI_ERROR_MEMORY;
+    }
+    h->secure = malloc(sizeof(orobi_secure_t));
+    if (!h->secure) {
+        free(h);
+        return OROBI_ERROR_MEMORY;
+    }
+
+    const uint128_t id = { .high = id_high, .low = id_low };
+    orobi_secure_init(h->secure, id, public_key, secret_key);
+    if (orobi_secure_alloc_scratch(h->secure) != OROBI_OK) {
+        orobi_secure_close(h->secure);
+        free(h);
+        return OROBI_ERROR_MEMORY;
+    }
+
+    orobi_clock_init(&h->clock, true);
+    orobi_secure_set_clock(h->secure, &h->clock, 0);
+
+    // Krypto-Backend hier wählen: die Bodenstation legt Kontexte vor ihren Worker-Threads an
+    orobi_crypto_get_backend();
+
+    h->last_status = OROBI_OK;
+    *handle = h;
+    return OROBI_OK;
+}
+
+void orobi_interop_destroy(orobi_interop_t* handle) {
+    if (!handle) {
+        return;
+    }
+    orobi_secure_close(handle->secure);
+    memset(handle, 0, sizeof(orobi_interop_t));
+    free(handle);
+}
+
+orobi_error_t orobi_interop_seal(orobi_interop_t* handle, const uint8_t* their_public_key,
+                                 uint8_t seq_nr, uint16_t api_key, const uint8_t* message, int32_t size,
+                                 uint8_t* buffer, int32_t buffer_size, int32_t* written) {
+    if (!handle) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (!their_public_key || !buffer || !written || size < 0 || size > OROBI_MAXMESSAGESIZE ||
+        buffer_size < 0 || (size > 0 && !message)) {
+        return handle->last_status = OROBI_ERROR_INVALID_INPUT;
+    }
+
+    size_t out = 0;
+    handle->last_status = orobi_netpacket_seal(handle->secure, &handle->lz_work, &handle->packet, seq_nr, api_key,
+                                               size > 0 ? message : (const uint8_t*)"", (uint16_t)size,
+                                               their_public_key, buffer, (size_t)buffer_size, &out);
+    *written = handle->last_status == OROBI_OK ? (int32_t)out : 0;
+    return handle->last_status;
+}
+
+orobi_error_t orobi_interop_open(orobi_interop_t* handle, const uint8_t* their_public_key,
+                                 const uint8_t* data, int32_t size, uint8_t* message, int32_t message_capacity,
+                                 int32_t* message_size, uint16_t* api_key, uint8_t* seq_nr) {
+    if (!handle) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (!their_public_key || !data || size < 0 || !message_size || message_capacity < 0 ||
+        (message_capacity > 0 && !message)) {
+        return handle->last_status = OROBI_ERROR_INVALID_INPUT;
+    }
+    *message_size = 0;
+    handle->rx_ms = orobi_clock_local_ms();
+
+    orobi_netpacket_view_t view;
+    const uint8_t* plain = NULL;
+    size_t plain_size = 0;
+    handle->last_status = orobi_netpacket_open(handle->secure, data, (size_t)size, their_public_key, &handle->packet,
+                                               handle->inflate, sizeof(handle->inflate), &view, &plain, &plain_size);
+    if (handle->last_status != OROBI_OK) {
+        return handle->last_status;
+    }
+    if (plain_size > (size_t)message_capacity) {
+        return handle->last_status = OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    memcpy(message, plain, plain_size);
+    *message_size = (int32_t)plain_size;
+    if (api_key) {
+        *api_key = view.api_key;
+    }
+    if (seq_nr) {
+        *seq_nr = view.seq_nr;
+    }
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_interop_clock_reply(orobi_interop_t* handle, const uint8_t* request, int32_t size,
+                                        uint8_t* buffer, int32_t buffer_size, int32_t* written) {
+    if (!handle) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (!request || size < 0 || !buffer || buffer_size < 0 || !written) {
+        return handle->last_status = OROBI_ERROR_INVALID_INPUT;
+    }
+
+    size_t out = 0;
+    handle->last_status = orobi_clock_respond(&handle->clock, request, (size_t)size, handle->rx_ms,
+                                              buffer, (size_t)buffer_size, &out);
+    *written = handle->last_status == OROBI_OK ? (int32_t)out : 0;
+    return handle->last_status;
+}
+
+uint32_t orobi_interop_now_ms(orobi_interop_t* handle) {
+    return handle ? orobi_clock_now(&handle->clock) : 0;
+}
+
+const char* orobi_interop_last_error(orobi_interop_t* handle) {
+    if (!handle) {
+        return orobi_error_string(OROBI_ERROR_INVALID_INPUT);
+    }
+    // Detailtext nur, wenn der Fehler aus dem Kontext stammt
+    if (handle->last_status != OROBI_OK && handle->secure->last_status == handle->last_status) {
+        return orobi_secure_last_error(handle->secure);
+    }
+    return orobi_error_string(handle->last_status);
+}
+
+int32_t orobi_interop_max_packet_size(void) {
+    return OROBI_NETPACKET_MAXSIZE;
+}
+
+int32_t orobi_interop_max_message_size(void) {
+    return OROBI_MAXMESSAGESIZE;
+}
@@ -0,0 +1,196 @@
+#include "orobi_motor.h"
+#include <string.h>
+
+static inline uint8_t __orobi_motor_pack_buttons(const orobi_motordata_t* frame) {
+    uint8_t bits = 0;
+    for (int i = 0; i < 4; i++) {
+        if (frame->buttons[i]) {
+            bits |= (uint8_t)(1u << i);
+        }
+    }
+    return bits;
+}
+
+static inline void __orobi_motor_unpack_buttons(orobi_motordata_t* frame, uint8_t bits) {
+    for (int i = 0; i < 4; i++) {
+        frame->buttons[i] = (bits >> i) & 1;
+    }
+}
+
+// Modulare 16-Bit Differenz als zigzag-varint (1-3 Bytes)
+static uint8_t* __orobi_motor_put_delta(uint8_t* p, uint16_t value, uint16_t reference) {
+    const int16_t delta = (int16_t)(uint16_t)(value - reference);
+    uint32_t zigzag = (uint16_t)(((uint16_t)delta << 1) ^ (delta < 0 ? 0xFFFF : 0));
+    while (zigzag >= 0x80) {
+        *p++ = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    *p++ = (uint8_t)zigzag;
+    return p;
+}
+
+static const uint8_t* __orobi_motor_get_delta(const uint8_t* p, const uint8_t* end, uint16_t reference, uint16_t* value) {
+    uint32_t zigzag = 0;
+    for (int shift = 0; shift < 21; shift += 7) {
+        if (p >= end) {
+            return NULL;
+        }
+        const uint8_t b = *p++;
+        zigzag |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            if (zigzag > 0xFFFF) {
+                return NULL;
+            }
+            const uint16_t delta = (uint16_t)((zigzag >> 1) ^ ((zigzag & 1) ? 0xFFFF : 0));
+            *value = (uint16_t)(reference + delta);
+            return p;
+        }
+    }
+    return NULL;
+}
+
+void orobi_motor_encoder_init(orobi_motor_encoder_t* enc) {
+    memset(enc, 0, sizeof(orobi_motor_encoder_t));
+}
+
+orobi_error_t orobi_motor_encode(orobi_motor_encoder_t* enc, const orobi_motordata_t* frame,
+                                 uint8_t* out, size_t out_size, size_t* written) {
+    if (!enc || !frame || !out || !written) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (out_size < OROBI_MOTOR_MAXFRAME) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    const uint8_t seq = enc->seq;
+    uint8_t* p = out + 2;
+    uint8_t flags = __orobi_motor_pack_buttons(frame);
+
+    // Aus der Historie des Empfängers gefallene Referenz verwerfen: sonst verglichen orobi_motor_ack und
+    // diese Prüfung nach 128 bzw. 256 Frames ohne Bestätigung über den Umlauf von seq hinweg
+    if (enc->has_reference && (uint8_t)(seq - enc->reference_seq) >= OROBI_MOTOR_HISTORY) {
+        enc->has_reference = false;
+    }
+
+    // Keyframe ohne gültige Referenz oder periodisch
+    bool keyframe = !enc->has_reference || enc->since_keyframe >= OROBI_MOTOR_KEYFRAME_INTERVAL;
+
+    if (keyframe) {
+        flags |= OROBI_MOTOR_FLAG_KEYFRAME;
+        orobi_write_le16(p, frame->speed);
+        orobi_write_le16(p + 2, frame->rotation);
+        p += 4;
+        enc->since_keyframe = 0;
+    } else {
+        *p++ = enc->reference_seq;
+        if (frame->speed != enc->reference.speed) {
+            flags |= OROBI_MOTOR_FLAG_SPEED;
+            p = __orobi_motor_put_delta(p, frame->speed, enc->reference.speed);
+        }
+        if (frame->rotation != enc->reference.rotation) {
+            flags |= OROBI_MOTOR_FLAG_ROTATION;
+            p = __orobi_motor_put_delta(p, frame->rotation, enc->reference.rotation);
+        }
+        enc->since_keyframe++;
+    }
+
+    out[0] = flags;
+    out[1] = seq;
+    enc->history[seq % OROBI_MOTOR_HISTORY] = *frame;
+    enc->seq++;
+
+    *written = (size_t)(p - out);
+    return OROBI_OK;
+}
+
+void orobi_motor_ack(orobi_motor_encoder_t* enc, uint8_t seq) {
+    if (!enc) {
+        return;
+    }
+
+    // Nur Frames aus der Historie, und nur vorwärts
+    uint8_t age = (uint8_t)(enc->seq - seq);
+    if (age == 0 || age > OROBI_MOTOR_HISTORY) {
+        return;
+    }
+    if (enc->has_reference && (int8_t)(seq - enc->reference_seq) <= 0) {
+        return;
+    }
+
+    enc->reference = enc->history[seq % OROBI_MOTOR_HISTORY];
+    enc->reference_seq = seq;
+    enc->has_reference = true;
+}
+
+void orobi_motor_loss(orobi_motor_encoder_t* enc) {
+    if (enc) {
+        enc->has_reference = false;
+    }
+}
+
+void orobi_motor_decoder_init(orobi_motor_decoder_t* dec) {
+    memset(dec, 0, sizeof(orobi_motor_decoder_t));
+}
+
+orobi_error_t orobi_motor_decode(orobi_motor_decoder_t* dec, const uint8_t* data, size_t size,
+                                 orobi_motordata_t* frame, uint8_t* seq) {
+    if (!dec || !data || !frame) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (size < 3) {
+        return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+    }
+
+    const uint8_t* end = data + size;
+    const uint8_t flags = data[0];
+    const uint8_t frame_seq = data[1];
+    const uint8_t* p = data + 2;
+    orobi_motordata_t decoded;
+
+    // Ein Keyframe setzt immer neu auf: nach mehr als 127 verlorenen Frames läge er sonst scheinbar
+    // in der Vergangenheit, und bis zum Umlauf von seq würde alles verworfen
+    if (!(flags & OROBI_MOTOR_FLAG_KEYFRAME) && dec->has_last && (int8_t)(frame_seq - dec->last_seq) <= 0) {
+        return OROBI_ERROR_PACKET_TOO_OLD;
+    }
+
+    if (flags & OROBI_MOTOR_FLAG_KEYFRAME) {
+        if ((flags & (OROBI_MOTOR_FLAG_SPEED | OROBI_MOTOR_FLAG_ROTATION)) || size != 6) {
+            return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+        }
+        decoded.speed = orobi_read_le16(p);
+        decoded.rotation = orobi_read_le16(p + 2);
+    } else {
+        const uint8_t ref_seq = *p++;
+        const uint8_t slot = ref_seq % OROBI_MOTOR_HISTORY;
+        if (!dec->history_valid[slot] || dec->history_seq[slot] != ref_seq) {
+            return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+        }
+
+        decoded = dec->history[slot];
+        if ((flags & OROBI_MOTOR_FLAG_SPEED) &&
+            !(p = __orobi_motor_get_delta(p, end, decoded.speed, &decoded.speed))) {
+            return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+        }
+        if ((flags & OROBI_MOTOR_FLAG_ROTATION) &&
+            !(p = __orobi_motor_get_delta(p, end, decoded.rotation, &decoded.rotation))) {
+            return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+        }
+        if (p != end) {
+            return OROBI_ERROR_PACKET_VALIDATION_FAILED;
+        }
+    }
+    __orobi_motor_unpack_buttons(&decoded, flags & OROBI_MOTOR_BUTTON_MASK);
+
+    const uint8_t slot = frame_seq % OROBI_MOTOR_HISTORY;
+    dec->history[slot] = decoded;
+    dec->history_seq[slot] = frame_seq;
+    dec->history_valid[slot] = true;
+    dec->last_seq = frame_seq;
+    dec->has_last = true;
+
+    *frame = decoded;
+    if (seq) {
+        *seq = frame_seq;
+    }
+    return OROBI_OK;
+}
@@ -1,106 +1,467 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "orobi_packet.h"
+#include "orobi_crypto.h"
 #include "tweetnacl.h"
 
 
+// Überschreibbar, z.B. für Allokations-Zähler oder eigene Heaps
+#ifndef OROBI_MALLOC
+#define OROBI_MALLOC(size) malloc(size)
+#define OROBI_FREE(ptr)    free(ptr)
+#endif
+
+// Monotone Uhr der Metriken in ns, überschreibbar
+#ifndef OROBI_METRICS_CLOCK_NS
 #ifdef ESP32
-#include "esp_system.h"
-#define OROBI_RANDOM() esp_random()
-#elif defined(LINUX)
-#include <stdlib.h>
-#define OROBI_RANDOM() rand()
+#include "esp_timer.h"
+#define OROBI_METRICS_CLOCK_NS() ((uint64_t)esp_timer_get_time() * 1000u)
 #else
-#define OROBI_RANDOM() rand()
+static inline uint64_t __orobi_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#define OROBI_METRICS_CLOCK_NS() __orobi_clock_ns()
+#endif
 #endif
 
+// Ein Schreiber (Besitzer des Kontexts), Leser in orobi_secure_get_metrics: ohne Read-Modify-Write-Atomics.
+// Auf dem ESP32 wären 64-Bit-Atomics Funktionsaufrufe, dort reicht die einfache Addition.
+#ifdef ESP32
+#define __OROBI_METRIC_ADD(field, n)    ((field) += (n))
+#define __OROBI_METRIC_LOAD(field)      (field)
+#else
+#define __OROBI_METRIC_ADD(field, n)    __atomic_store_n(&(field), (field) + (n), __ATOMIC_RELAXED)
+#define __OROBI_METRIC_LOAD(field)      __atomic_load_n(&(field), __ATOMIC_RELAXED)
+#endif
 
-static void __orobi_generate_nonce(orobi_secure_nonce_t* nonce) {
-    // Erhöhe Counter
-    nonce->counter++;
-    
-    // Reset Counter wenn Schwelle erreicht
-    if (nonce->counter >= OROBI_NONCE_COUNTER_THRESHOLD) {
-        nonce->counter = 0;
+// Fehler merken ohne Formatierung; der Text entsteht erst in orobi_secure_last_error
+static orobi_error_t __orobi_fail(orobi_secure_t* ctx, orobi_error_t status, const char* detail) {
+    if (ctx) {
+        ctx->last_status = status;
+        ctx->last_detail = detail;
+        ctx->last_detail_args[0] = 0;
+        ctx->last_detail_args[1] = 0;
+        if ((unsigned)-status < OROBI_ERROR_COUNT) {
+            __OROBI_METRIC_ADD(ctx->metrics.failures[-status], 1);
+        }
     }
-    
-    // Aktualisiere Zeitstempel
-    nonce->timestamp = time(NULL);
-    
-    // Generiere zufällige Bytes
-    for (int i = 0; i < crypto_box_NONCEBYTES - 8; i++) {
-        nonce->bytes[i] = (unsigned char)OROBI_RANDOM(); // esp_random();
+    return status;
+}
+
+// Startzeit für das Histogramm (0: aus)
+static inline uint64_t __orobi_metrics_begin(const orobi_secure_t* ctx) {
+    return (ctx->metrics_flags & OROBI_METRICS_HISTOGRAM) ? OROBI_METRICS_CLOCK_NS() : 0;
+}
+
+static orobi_error_t __orobi_metrics_done(orobi_secure_t* ctx, orobi_metric_op_t op, uint64_t start) {
+    __OROBI_METRIC_ADD(ctx->metrics.ops[op], 1);
+    if (start) {
+        const uint64_t us = (OROBI_METRICS_CLOCK_NS() - start) / 1000u;
+        unsigned bucket = 0;
+        while (bucket + 1 < OROBI_METRICS_HISTOGRAM_BUCKETS && (us >> (bucket + 1)) != 0) {
+            bucket++;
+        }
+        __OROBI_METRIC_ADD(ctx->metrics.histogram[op][bucket], 1);
     }
-    
-    // Füge Counter in die letzten 8 Bytes ein
+    ctx->last_status = OROBI_OK;
+    return OROBI_OK;
+}
+
+// Zeitmessung einzelner Abschnitte (crypto_box, Hash); 0: Zeitmessung aus
+static inline uint64_t __orobi_metrics_clock(const orobi_secure_t* ctx) {
+    return (ctx->metrics_flags & OROBI_METRICS_TIMING) ? OROBI_METRICS_CLOCK_NS() : 0;
+}
+
+static inline void __orobi_metrics_elapsed(uint64_t* field, uint64_t start) {
+    if (start) {
+        __OROBI_METRIC_ADD(*field, OROBI_METRICS_CLOCK_NS() - start);
+    }
+}
+
+static uint64_t __orobi_timed_hash(orobi_secure_t* ctx, orobi_hash_algo_t algo, const void* data, size_t len) {
+    const uint64_t start = __orobi_metrics_clock(ctx);
+    const uint64_t hash = orobi_hash_64(algo, data, len, OROBI_MURMUR_SEED);
+    __orobi_metrics_elapsed(&ctx->metrics.hash_ns, start);
+    return hash;
+}
+
+
+// Nonce = Sitzungspräfix (16 Zufallsbytes) | Counter u32 | Zeitstempel u32.
+// Der Präfix wird beim ersten Paket (auch nach orobi_secure_session_resume) und nach Überlauf des Counters
+// neu gezogen; damit bleiben Nonces auch über Neustarts und Counter-Überläufe hinweg eindeutig.
+// Der CSPRNG wird erst hier geseedet: auf dem ESP32 liefert esp_fill_random erst mit aktivem Funk echte Entropie.
+static orobi_error_t __orobi_generate_nonce(orobi_secure_t* ctx, orobi_secure_nonce_t* nonce, uint32_t now_ms) {
+    // 0 ist für "noch nichts empfangen" reserviert
+    const bool wrap = ctx->tx_counter >= OROBI_NONCE_COUNTER_THRESHOLD - 1;
+    if (!ctx->nonce_prefix_valid || wrap) {
+        if ((!ctx->random.seeded && orobi_random_init(&ctx->random) != OROBI_OK) ||
+            orobi_random_bytes(&ctx->random, ctx->nonce_prefix, OROBI_NONCE_PREFIX_SIZE) != OROBI_OK) {
+            return OROBI_ERROR_INITIALIZATION_FAILED;
+        }
+        ctx->nonce_prefix_valid = true;
+        if (wrap) {
+            ctx->tx_counter = 0;
+        }
+    }
+
+    nonce->counter = ++ctx->tx_counter;
+    nonce->timestamp_ms = now_ms;
+    memcpy(nonce->bytes, ctx->nonce_prefix, OROBI_NONCE_PREFIX_SIZE);
     memcpy(&nonce->bytes[crypto_box_NONCEBYTES - 8], &nonce->counter, sizeof(uint32_t));
-    memcpy(&nonce->bytes[crypto_box_NONCEBYTES - 4], &nonce->timestamp, sizeof(uint32_t));
+    memcpy(&nonce->bytes[crypto_box_NONCEBYTES - 4], &nonce->timestamp_ms, sizeof(uint32_t));
+    return OROBI_OK;
+}
+
+// Counter und Zeitstempel aus den Nonce-Bytes (durch den MAC geschützt), nicht aus den Klartext-Feldern
+static void __orobi_nonce_from_bytes(orobi_secure_nonce_t* nonce, const unsigned char* bytes) {
+    memcpy(nonce->bytes, bytes, crypto_box_NONCEBYTES);
+    memcpy(&nonce->counter, &nonce->bytes[crypto_box_NONCEBYTES - 8], sizeof(uint32_t));
+    memcpy(&nonce->timestamp_ms, &nonce->bytes[crypto_box_NONCEBYTES - 4], sizeof(uint32_t));
+}
+
+// Zeitstempel gesendeter Pakete: Sitzungszeit, solange die Uhr synchron ist, sonst 0 (keine Altersprüfung)
+static uint32_t __orobi_packet_time(const orobi_secure_t* ctx) {
+    const uint32_t local = OROBI_CLOCK_LOCAL_MS();
+    if (!ctx->clock || !orobi_clock_synced(ctx->clock, local)) {
+        return 0;
+    }
+    const uint32_t now = orobi_clock_session_ms(ctx->clock, local);
+    return now != 0 ? now : 1;
 }
 
-// Überprüft, ob eine Nonce bereits verwendet wurde
-static bool __orobi_is_nonce_valid(const orobi_secure_t* ctx, const orobi_secure_nonce_t* nonce) {
-    // Prüfe Zeitstempel
-    time_t current_time = time(NULL);
-    if (current_time - nonce->timestamp > OROBI_MAX_PACKET_AGE_SEC) {
+static bool __orobi_clock_is_synced(const orobi_secure_t* ctx) {
+    return ctx->clock && orobi_clock_synced(ctx->clock, OROBI_CLOCK_LOCAL_MS());
+}
+
+// Prüft das Alter des Zeitstempels gegen die eigene Sitzungszeit (in beide Richtungen, deviation in ms).
+// Ohne Zeitstempel nur Counter oberhalb des letzten synchronen Pakets unter demselben Präfix: sonst gälte ein
+// mitgeschnittenes Paket aus der Zeit vor dem Uhrabgleich nach einem Zurücksetzen des Fensters erneut.
+static bool __orobi_is_packet_fresh(const orobi_secure_t* ctx, const orobi_secure_peer_t* peer,
+                                    const orobi_secure_nonce_t* nonce, uint32_t* deviation) {
+    const uint32_t local = OROBI_CLOCK_LOCAL_MS();
+    *deviation = 0;
+    if (nonce->timestamp_ms == 0) {
+        return peer->synced_counter == 0 || nonce->counter > peer->synced_counter ||
+               memcmp(peer->session_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE) != 0;
+    }
+    if (!__orobi_clock_is_synced(ctx)) {
+        return true;
+    }
+
+    const int32_t age = (int32_t)(orobi_clock_session_ms(ctx->clock, local) - nonce->timestamp_ms);
+    *deviation = age < 0 ? (uint32_t)0 - (uint32_t)age : (uint32_t)age;
+    return *deviation <= (uint64_t)ctx->max_packet_age + orobi_clock_error_ms(ctx->clock, local);
+}
+
+static bool __orobi_is_prefix_retired(const orobi_secure_peer_t* peer, const unsigned char* prefix) {
+    for (int i = 0; i < OROBI_PEER_RETIRED_PREFIXES; i++) {
+        if (memcmp(peer->retired_prefix[i], prefix, OROBI_NONCE_PREFIX_SIZE) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static orobi_error_t __orobi_fail_too_old(orobi_secure_t* ctx, const orobi_secure_nonce_t* nonce, uint32_t deviation) {
+    if (nonce->timestamp_ms == 0) {
+        return __orobi_fail(ctx, OROBI_ERROR_PACKET_TOO_OLD, "Packet without timestamp after clock sync");
+    }
+    __orobi_fail(ctx, OROBI_ERROR_PACKET_TOO_OLD, "Packet timestamp off by %u ms");
+    ctx->last_detail_args[0] = deviation;
+    return OROBI_ERROR_PACKET_TOO_OLD;
+}
+
+// Überprüft das Replay-Fenster der Gegenstelle in O(1), ohne den Zustand zu ändern
+static bool __orobi_is_nonce_valid(const orobi_secure_t* ctx, const orobi_secure_peer_t* peer,
+                                   const orobi_secure_nonce_t* nonce) {
+    const orobi_replay_window_t* window = &peer->replay;
+    if (nonce->counter == 0) {
         return false;
     }
-    
+    // Anderer Präfix: neu gestartete Gegenstelle bzw. Kandidat (streng steigend) oder abgelöste Sitzung (gesperrt)
+    if (peer->prefix_known && memcmp(peer->session_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE) != 0) {
+        if (peer->candidate_top != 0 && memcmp(peer->candidate_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE) == 0) {
+            return nonce->counter > peer->candidate_top;
+        }
+        return !__orobi_is_prefix_retired(peer, nonce->bytes);
+    }
+
     // Prüfe Counter
-    if (nonce->counter <= ctx->last_seen_nonce.counter &&
-        nonce->timestamp <= ctx->last_seen_nonce.timestamp) {
+    if (nonce->counter > window->top) {
+        return true;
+    }
+    if (window->top - nonce->counter >= ctx->replay_window) {
         return false;
     }
-    
-    return true;
+
+    const uint32_t words = ctx->replay_window / 64 + 1;
+    const uint64_t bit = 1ULL << (nonce->counter & 63);
+    return (window->bitmap[(nonce->counter >> 6) % words] & bit) == 0;
+}
+
+// Setzt das Fenster so, dass alle Counter bis einschließlich top als gesehen gelten
+static void __orobi_replay_fill(const orobi_secure_t* ctx, orobi_replay_window_t* window, uint32_t top) {
+    if (top == 0) {
+        memset(window, 0, sizeof(orobi_replay_window_t));
+        return;
+    }
+    window->top = top;
+    memset(window->bitmap, 0xFF, sizeof(window->bitmap));
+    const uint32_t bit = top & 63;
+    window->bitmap[(top >> 6) % (ctx->replay_window / 64 + 1)] = bit == 63 ? ~0ULL : (1ULL << (bit + 1)) - 1;
+}
+
+// Markiert den Counter als gesehen; nur nach erfolgreicher Authentifizierung aufrufen
+static void __orobi_accept_nonce(orobi_secure_t* ctx, orobi_secure_peer_t* peer,
+                                 const orobi_secure_nonce_t* nonce) {
+    orobi_replay_window_t* window = &peer->replay;
+    const uint32_t words = ctx->replay_window / 64 + 1;
+
+    // Erster Präfix (neuer Cache-Eintrag, fortgesetzte Sitzung): übernehmen, das Fenster gilt für ihn
+    if (!peer->prefix_known) {
+        if (memcmp(peer->session_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE) != 0) {
+            memcpy(peer->session_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE);
+            peer->synced_counter = 0;
+        }
+        peer->prefix_known = true;
+    } else if (memcmp(peer->session_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE) != 0) {
+        // Neuer Präfix einer bekannten Gegenstelle: neu gestartet oder Sitzung fortgesetzt. Beim ersten Paket
+        // eigene Counter um ihren Empfangsvorrat überspringen, damit sie unsere Antworten annimmt; beim
+        // Überlauf beginnt ein neuer Präfix (frisches Fenster).
+        const bool candidate = peer->candidate_top != 0 &&
+                               memcmp(peer->candidate_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE) == 0;
+        if (!candidate) {
+            ctx->tx_counter = (ctx->tx_counter < OROBI_NONCE_COUNTER_THRESHOLD - 1 - OROBI_SESSION_RX_LEASE)
+                            ? ctx->tx_counter + OROBI_SESSION_RX_LEASE : OROBI_NONCE_COUNTER_THRESHOLD - 1;
+        }
+        // Ohne frischen Zeitstempel kann es auch ein mitgeschnittenes Paket einer alten Sitzung sein:
+        // nur als Kandidat führen, das Fenster des laufenden Präfixes bleibt unverändert
+        if (nonce->timestamp_ms == 0 || !__orobi_clock_is_synced(ctx)) {
+            memcpy(peer->candidate_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE);
+            peer->candidate_top = nonce->counter;
+            ctx->last_seen_nonce = *nonce;
+            return;
+        }
+
+        // Frischer Zeitstempel: der alte Präfix wird gesperrt, alle Counter des Kandidaten gelten als gesehen
+        memcpy(peer->retired_prefix[peer->retired_next], peer->session_prefix, OROBI_NONCE_PREFIX_SIZE);
+        peer->retired_next = (uint8_t)((peer->retired_next + 1) % OROBI_PEER_RETIRED_PREFIXES);
+        memcpy(peer->session_prefix, nonce->bytes, OROBI_NONCE_PREFIX_SIZE);
+        __orobi_replay_fill(ctx, window, candidate ? peer->candidate_top : 0);
+        peer->candidate_top = 0;
+        peer->synced_counter = 0;
+    }
+
+    if (nonce->counter > window->top) {
+        // Übersprungene Bitmap-Worte leeren (höchstens einmal das ganze Fenster)
+        uint32_t skipped = (nonce->counter >> 6) - (window->top >> 6);
+        if (skipped > words) {
+            skipped = words;
+        }
+        for (uint32_t i = 1; i <= skipped; i++) {
+            window->bitmap[((window->top >> 6) + i) % words] = 0;
+        }
+        window->top = nonce->counter;
+    }
+    window->bitmap[(nonce->counter >> 6) % words] |= 1ULL << (nonce->counter & 63);
+    if (nonce->timestamp_ms != 0 && nonce->counter > peer->synced_counter) {
+        peer->synced_counter = nonce->counter;
+    }
+    ctx->last_seen_nonce = *nonce;
 }
 
 // Murmur3 Hash Implementation
+#define OROBI_MURMUR_M 0xc6a4a7935bd1e995ULL
+#define OROBI_MURMUR_R 47
+
+// Liest einen 64-Bit Block ohne Alignment-Annahme (wird zu einem einzelnen Load kompiliert)
+static inline uint64_t __orobi_murmur_load(const uint8_t* p) {
+    uint64_t k;
+    memcpy(&k, p, sizeof(uint64_t));
+    return k;
+}
+
+static inline uint64_t __orobi_murmur_block(uint64_t h, uint64_t k) {
+    k *= OROBI_MURMUR_M;
+    k ^= k >> OROBI_MURMUR_R;
+    k *= OROBI_MURMUR_M;
+    
+    h ^= k;
+    h *= OROBI_MURMUR_M;
+    h ^= h >> OROBI_MURMUR_R;
+    return h;
+}
+
+static inline uint64_t __orobi_murmur_tail(uint64_t h, const uint8_t* tail, size_t len) {
+    uint64_t k = 0;
+    
+    switch(len & 7) {
+        case 7: k ^= ((uint64_t)tail[6]) << 48; // fall through
+        case 6: k ^= ((uint64_t)tail[5]) << 40; // fall through
+        case 5: k ^= ((uint64_t)tail[4]) << 32; // fall through
+        case 4: k ^= ((uint64_t)tail[3]) << 24; // fall through
+        case 3: k ^= ((uint64_t)tail[2]) << 16; // fall through
+        case 2: k ^= ((uint64_t)tail[1]) << 8;  // fall through
+        case 1: k ^= ((uint64_t)tail[0]);
+                k *= OROBI_MURMUR_M;
+    };
+    
+    h ^= k;
+    h *= OROBI_MURMUR_M;
+    h ^= h >> OROBI_MURMUR_R;
+    h *= OROBI_MURMUR_M;
+    h ^= h >> OROBI_MURMUR_R;
+    return h;
+}
+
 // Verbesserte Murmur3 Hash Implementation mit Seed-Mixing
 uint64_t orobi_murmur3_64(const void* data, size_t len, uint64_t seed) {
-    const uint64_t m = 0xc6a4a7935bd1e995ULL;
-    const int r = 47;
-    
+    orobi_murmur3_state_t state;
+    orobi_murmur3_64_init(&state, len, seed);
+    orobi_murmur3_64_update(&state, data, len);
+    return orobi_murmur3_64_final(&state);
+}
+
+void orobi_murmur3_64_init(orobi_murmur3_state_t* state, size_t len, uint64_t seed) {
     // Zusätzliches Seed-Mixing für bessere Verteilung
     seed ^= len;
     seed *= 0x94d049bb133111ebULL;
     
-    uint64_t h = seed;
-    
-    const uint64_t* blocks = (const uint64_t*)(data);
-    const size_t nblocks = len / 8;
+    state->h = seed;
+    state->tail_size = 0;
+}
+
+void orobi_murmur3_64_update(orobi_murmur3_state_t* state, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t h = state->h;
+
+    // Angefangenen Block aus vorherigem update auffüllen
+    if (state->tail_size > 0) {
+        size_t fill = 8 - state->tail_size;
+        if (fill > size) {
+            fill = size;
+        }
+        memcpy(state->tail + state->tail_size, p, fill);
+        state->tail_size += fill;
+        p += fill;
+        size -= fill;
+
+        if (state->tail_size < 8) {
+            return;
+        }
+        h = __orobi_murmur_block(h, __orobi_murmur_load(state->tail));
+        state->tail_size = 0;
+    }
     
+    const size_t nblocks = size / 8;
     for(size_t i = 0; i < nblocks; i++) {
-        uint64_t k = blocks[i];
-        
-        k *= m;
-        k ^= k >> r;
-        k *= m;
-        
-        h ^= k;
-        h *= m;
-        h ^= h >> r;
+        h = __orobi_murmur_block(h, __orobi_murmur_load(p + i * 8));
     }
     
-    const uint8_t* tail = (const uint8_t*)(data + nblocks*8);
-    uint64_t k = 0;
-    
-    switch(len & 7) {
-        case 7: k ^= ((uint64_t)tail[6]) << 48;
-        case 6: k ^= ((uint64_t)tail[5]) << 40;
-        case 5: k ^= ((uint64_t)tail[4]) << 32;
-        case 4: k ^= ((uint64_t)tail[3]) << 24;
-        case 3: k ^= ((uint64_t)tail[2]) << 16;
-        case 2: k ^= ((uint64_t)tail[1]) << 8;
-        case 1: k ^= ((uint64_t)tail[0]);
-                k *= m;
+    state->tail_size = size & 7;
+    memcpy(state->tail, p + nblocks * 8, state->tail_size);
+    state->h = h;
+}
+
+uint64_t orobi_murmur3_64_final(const orobi_murmur3_state_t* state) {
+    return __orobi_murmur_tail(state->h, state->tail, state->tail_size);
+}
+
+// Mehrspuriger Murmur3: 4 unabhängige Akkumulatoren über 32-Byte Streifen, am Ende zusammengefaltet.
+// Die Spuren haben keine Datenabhängigkeit untereinander (ILP bzw. Vektorisierung).
+static inline __attribute__((always_inline))
+uint64_t __orobi_murmur3_64x4_kernel(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = (const uint8_t*)data;
+
+    seed ^= len;
+    seed *= 0x94d049bb133111ebULL;
+
+    uint64_t lane[4] = {
+        seed,
+        seed ^ 0x9e3779b97f4a7c15ULL,
+        seed ^ 0xbf58476d1ce4e5b9ULL,
+        seed ^ 0x94d049bb133111ebULL
     };
-    
-    h ^= k;
-    h *= m;
-    h ^= h >> r;
-    h *= m;
-    h ^= h >> r;
-    
-    return h;
+
+    const size_t nstripes = len / 32;
+    for (size_t i = 0; i < nstripes; i++) {
+        for (int l = 0; l < 4; l++) {
+            lane[l] = __orobi_murmur_block(lane[l], __orobi_murmur_load(p + i * 32 + l * 8));
+        }
+    }
+
+    uint64_t h = lane[0];
+    for (int l = 1; l < 4; l++) {
+        h = __orobi_murmur_block(h, lane[l]);
+    }
+
+    p += nstripes * 32;
+    len -= nstripes * 32;
+    for (size_t i = 0; i < len / 8; i++) {
+        h = __orobi_murmur_block(h, __orobi_murmur_load(p + i * 8));
+    }
+    return __orobi_murmur_tail(h, p + (len & ~(size_t)7), len);
+}
+
+static uint64_t __orobi_murmur3_64x4_scalar(const void* data, size_t len, uint64_t seed) {
+    return __orobi_murmur3_64x4_kernel(data, len, seed);
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(ESP32)
+#define OROBI_HASH_DISPATCH 1
+__attribute__((target("avx2")))
+static uint64_t __orobi_murmur3_64x4_avx2(const void* data, size_t len, uint64_t seed) {
+    return __orobi_murmur3_64x4_kernel(data, len, seed);
 }
+#endif
+
+typedef uint64_t (*orobi_hash_fn_t)(const void* data, size_t len, uint64_t seed);
+static orobi_hash_fn_t __orobi_murmur3_64x4_impl = NULL;
+
+// Wählt beim ersten Aufruf die Implementierung passend zur CPU (ESP32: immer skalar)
+static orobi_hash_fn_t __orobi_murmur3_64x4_resolve(void) {
+    orobi_hash_fn_t fn = __orobi_murmur3_64x4_scalar;
+#ifdef OROBI_HASH_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        fn = __orobi_murmur3_64x4_avx2;
+    }
+#endif
+    __orobi_murmur3_64x4_impl = fn;
+    return fn;
+}
+
+uint64_t orobi_murmur3_64x4(const void* data, size_t len, uint64_t seed) {
+    orobi_hash_fn_t fn = __orobi_murmur3_64x4_impl;
+    if (!fn) {
+        fn = __orobi_murmur3_64x4_resolve();
+    }
+    return fn(data, len, seed);
+}
+
+bool orobi_hash_supported(orobi_hash_algo_t algo) {
+    return algo == OROBI_HASH_MURMUR3_64 || algo == OROBI_HASH_MURMUR3_64X4;
+}
+
+uint64_t orobi_hash_64(orobi_hash_algo_t algo, const void* data, size_t len, uint64_t seed) {
+    if (algo == OROBI_HASH_MURMUR3_64X4) {
+        return orobi_murmur3_64x4(data, len, seed);
+    }
+    return orobi_murmur3_64(data, len, seed);
+}
+
+orobi_error_t orobi_secure_set_hash_algo(orobi_secure_t* ctx, orobi_hash_algo_t algo) {
+    if (!ctx || !orobi_hash_supported(algo)) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+    ctx->hash_algo = algo;
+    return OROBI_OK;
+}
+
 void orobi_secure_init(orobi_secure_t* ctx, uint128_t id, const unsigned char* public_key, const unsigned char* secret_key) {
     memset(ctx, 0, sizeof(orobi_secure_t));
     ctx->id.high = id.high;
@@ -108,18 +469,344 @@ void orobi_secure_init(orobi_secure_t* ctx, uint128_t id, const unsigned char* p
     
     memcpy(ctx->public_key, public_key, crypto_box_PUBLICKEYBYTES);
     memcpy(ctx->secret_key, secret_key, crypto_box_SECRETKEYBYTES);
+    ctx->replay_window = OROBI_REPLAY_WINDOW_DEFAULT;
     ctx->last_status = OROBI_OK;
+    ctx->metrics_flags = OROBI_METRICS_DEFAULT;
+    ctx->max_packet_age = OROBI_MAX_PACKET_AGE_MS;
+}
+
+const char* orobi_error_string(orobi_error_t status) {
+    switch (status) {
+        case OROBI_OK:                              return "OK";
+        case OROBI_ERROR_INVALID_INPUT:             return "Invalid input";
+        case OROBI_ERROR_PACKET_TOO_OLD:            return "Packet too old";
+        case OROBI_ERROR_NONCE_REPLAY:              return "Nonce replay";
+        case OROBI_ERROR_ENCRYPTION_FAILED:         return "Encryption failed";
+        case OROBI_ERROR_DECRYPTION_FAILED:         return "Decryption failed";
+        case OROBI_ERROR_HASH_MISMATCH:             return "Hash mismatch";
+        case OROBI_ERROR_PACKET_VALIDATION_FAILED:  return "Packet validation failed";
+        case OROBI_ERROR_MEMORY:                    return "Out of memory";
+        case OROBI_ERROR_INITIALIZATION_FAILED:     return "Initialization failed";
+        case OROBI_ERROR_TIME_SYNC:                 return "Time sync failed";
+        case OROBI_ERROR_DEPENDENCY_MISSING:        return "Dependency missing";
+        case OROBI_ERROR_BUFFER_OVERFLOW:           return "Buffer overflow";
+        case OROBI_ERROR_INVALID_CONFIGURATION:     return "Invalid configuration";
+        case OROBI_ERROR_CRYPTOGRAPHIC_FAILURE:     return "Cryptographic failure";
+        case OROBI_ERROR_INVALID_COMMAND:           return "Invalid command";
+        case OROBI_ERROR_COMMAND_OVERFLOW:          return "Command overflow";
+        case OROBI_ERROR_UNSUPPORTED_COMMAND:       return "Unsupported command";
+    }
+    return "Unknown error";
+}
+
+const char* orobi_secure_last_error(orobi_secure_t* ctx) {
+    if (!ctx) {
+        return orobi_error_string(OROBI_ERROR_INVALID_INPUT);
+    }
+    if (ctx->last_status == OROBI_OK || !ctx->last_detail) {
+        return orobi_error_string(ctx->last_status);
+    }
+    snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, ctx->last_detail,
+             (unsigned)ctx->last_detail_args[0], (unsigned)ctx->last_detail_args[1]);
+    return ctx->last_error;
+}
+
+orobi_error_t orobi_secure_set_metrics(orobi_secure_t* ctx, uint8_t flags) {
+    if (!ctx || (flags & ~(OROBI_METRICS_TIMING | OROBI_METRICS_HISTOGRAM)) != 0) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+    ctx->metrics_flags = flags;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_secure_get_metrics(const orobi_secure_t* ctx, orobi_secure_metrics_t* metrics) {
+    if (!ctx || !metrics) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    for (int op = 0; op < OROBI_METRIC_OPS; op++) {
+        metrics->ops[op] = __OROBI_METRIC_LOAD(ctx->metrics.ops[op]);
+        for (int i = 0; i < OROBI_METRICS_HISTOGRAM_BUCKETS; i++) {
+            metrics->histogram[op][i] = __OROBI_METRIC_LOAD(ctx->metrics.histogram[op][i]);
+        }
+    }
+    for (int i = 0; i < OROBI_ERROR_COUNT; i++) {
+        metrics->failures[i] = __OROBI_METRIC_LOAD(ctx->metrics.failures[i]);
+    }
+    metrics->crypto_ns = __OROBI_METRIC_LOAD(ctx->metrics.crypto_ns);
+    metrics->hash_ns = __OROBI_METRIC_LOAD(ctx->metrics.hash_ns);
+    return OROBI_OK;
+}
+
+void orobi_secure_reset_metrics(orobi_secure_t* ctx) {
+    if (ctx) {
+        memset(&ctx->metrics, 0, sizeof(ctx->metrics));
+    }
+}
+
+orobi_error_t orobi_secure_set_replay_window(orobi_secure_t* ctx, uint16_t window) {
+    if (!ctx || window < OROBI_REPLAY_WINDOW_MIN || window > OROBI_REPLAY_WINDOW_MAX || (window % 64) != 0) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+
+    ctx->replay_window = window;
+    for (int i = 0; i < OROBI_PEER_CACHE_SIZE; i++) {
+        memset(&ctx->peers[i].replay, 0, sizeof(orobi_replay_window_t));
+        ctx->peers[i].prefix_known = false;
+        ctx->peers[i].candidate_top = 0;
+    }
+    return OROBI_OK;
+}
+
+void orobi_secure_invalidate_peers(orobi_secure_t* ctx) {
+    if (!ctx) {
+        return;
+    }
+    memset(ctx->peers, 0, sizeof(ctx->peers));
+    ctx->peer_clock = 0;
+}
+
+orobi_error_t orobi_secure_invalidate_peer(orobi_secure_t* ctx, const unsigned char* their_public_key) {
+    if (!ctx || !their_public_key) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    for (int i = 0; i < OROBI_PEER_CACHE_SIZE; i++) {
+        orobi_secure_peer_t* peer = &ctx->peers[i];
+        if (peer->valid && memcmp(peer->public_key, their_public_key, crypto_box_PUBLICKEYBYTES) == 0) {
+            memset(peer, 0, sizeof(orobi_secure_peer_t));
+        }
+    }
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_secure_set_keys(orobi_secure_t* ctx, const unsigned char* public_key, const unsigned char* secret_key) {
+    if (!ctx || !public_key || !secret_key) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    memcpy(ctx->public_key, public_key, crypto_box_PUBLICKEYBYTES);
+    memcpy(ctx->secret_key, secret_key, crypto_box_SECRETKEYBYTES);
+    orobi_secure_invalidate_peers(ctx);
+    return OROBI_OK;
+}
+
+static void __orobi_scratch_drop(orobi_secure_t* ctx) {
+    if (ctx->scratch_owned) {
+        OROBI_FREE(ctx->scratch);
+    }
+    ctx->scratch = NULL;
+    ctx->scratch_size = 0;
+    ctx->scratch_owned = false;
+}
+
+orobi_error_t orobi_secure_set_clock(orobi_secure_t* ctx, const orobi_clock_t* clock, uint32_t max_age_ms) {
+    if (!ctx) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    ctx->clock = clock;
+    ctx->max_packet_age = max_age_ms != 0 ? max_age_ms : OROBI_MAX_PACKET_AGE_MS;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_secure_set_scratch(orobi_secure_t* ctx, void* buffer, size_t size) {
+    if (!ctx || (buffer && size == 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    __orobi_scratch_drop(ctx);
+    if (buffer) {
+        ctx->scratch = (unsigned char*)buffer;
+        ctx->scratch_size = size;
+    }
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_secure_alloc_scratch(orobi_secure_t* ctx) {
+    if (!ctx) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    unsigned char* buffer = OROBI_MALLOC(OROBI_SECURE_SCRATCH_SIZE);
+    if (!buffer) {
+        return OROBI_ERROR_MEMORY;
+    }
+
+    __orobi_scratch_drop(ctx);
+    ctx->scratch = buffer;
+    ctx->scratch_size = OROBI_SECURE_SCRATCH_SIZE;
+    ctx->scratch_owned = true;
+    return OROBI_OK;
+}
+
+// Temporärer Speicher: Arbeitspuffer des Kontexts, sonst Heap. Es ist immer nur ein Block gleichzeitig in Benutzung.
+static unsigned char* __orobi_scratch_acquire(orobi_secure_t* ctx, size_t size) {
+    if (ctx->scratch && size <= ctx->scratch_size) {
+        return ctx->scratch;
+    }
+    return OROBI_MALLOC(size);
+}
+
+static void __orobi_scratch_release(orobi_secure_t* ctx, void* ptr) {
+    if (ptr && ptr != ctx->scratch) {
+        OROBI_FREE(ptr);
+    }
+}
+
+// Eintrag der Gegenstelle (*found) oder der freie bzw. am längsten unbenutzte Slot (LRU)
+static orobi_secure_peer_t* __orobi_peer_slot(const orobi_secure_t* ctx, const unsigned char* their_public_key,
+                                              bool* found) {
+    const orobi_secure_peer_t* slot = NULL;
+
+    for (int i = 0; i < OROBI_PEER_CACHE_SIZE; i++) {
+        const orobi_secure_peer_t* peer = &ctx->peers[i];
+        if (!peer->valid) {
+            if (!slot || slot->valid) {
+                slot = peer;
+            }
+            continue;
+        }
+        if (memcmp(peer->public_key, their_public_key, crypto_box_PUBLICKEYBYTES) == 0) {
+            *found = true;
+            return (orobi_secure_peer_t*)peer;
+        }
+        if (!slot || (slot->valid && peer->last_used < slot->last_used)) {
+            slot = peer;
+        }
+    }
+    *found = false;
+    return (orobi_secure_peer_t*)slot;
+}
+
+// Liefert den Eintrag der Gegenstelle; Curve25519 läuft nur beim ersten Paket bzw. nach Verdrängung (LRU).
+// Mit der Verdrängung gehen Replay-Fenster und synced_counter verloren; danach begrenzt nur noch die
+// Altersprüfung Pakete mit Zeitstempel, Pakete ohne Zeitstempel gar nicht.
+static orobi_secure_peer_t* __orobi_peer_lookup(orobi_secure_t* ctx, const unsigned char* their_public_key) {
+    bool found;
+    orobi_secure_peer_t* slot = __orobi_peer_slot(ctx, their_public_key, &found);
+    if (found) {
+        slot->last_used = ++ctx->peer_clock;
+        return slot;
+    }
+
+    const uint64_t start = __orobi_metrics_clock(ctx);
+    const int rc = crypto_box_beforenm(slot->shared_key, their_public_key, ctx->secret_key);
+    __orobi_metrics_elapsed(&ctx->metrics.crypto_ns, start);
+    if (rc != 0) {
+        memset(slot, 0, sizeof(orobi_secure_peer_t));
+        return NULL;
+    }
+    memcpy(slot->public_key, their_public_key, crypto_box_PUBLICKEYBYTES);
+    memset(&slot->replay, 0, sizeof(orobi_replay_window_t));
+    memset(slot->session_prefix, 0, OROBI_NONCE_PREFIX_SIZE);
+    memset(slot->retired_prefix, 0, sizeof(slot->retired_prefix));
+    slot->prefix_known = false;
+    slot->retired_next = 0;
+    slot->candidate_top = 0;
+    slot->synced_counter = 0;
+    slot->last_used = ++ctx->peer_clock;
+    slot->valid = true;
+    return slot;
+}
+
+// Höchster empfangene Counter, auch unter einem noch nicht bestätigten Präfix
+static uint32_t __orobi_peer_rx_top(const orobi_secure_peer_t* peer) {
+    return peer->candidate_top > peer->replay.top ? peer->candidate_top : peer->replay.top;
+}
+
+static uint64_t __orobi_session_check(const orobi_secure_t* ctx, const orobi_session_ticket_t* ticket) {
+    return orobi_murmur3_64(ticket, offsetof(orobi_session_ticket_t, check), ctx->id.high);
+}
+
+static uint32_t __orobi_session_limit(uint32_t counter, uint32_t lease) {
+    return counter < OROBI_NONCE_COUNTER_THRESHOLD - 1 - lease ? counter + lease : OROBI_NONCE_COUNTER_THRESHOLD - 1;
+}
+
+orobi_error_t orobi_secure_session_export(orobi_secure_t* ctx, const unsigned char* their_public_key,
+                                          orobi_session_ticket_t* ticket) {
+    if (!ctx || !their_public_key || !ticket) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_secure_peer_t* peer = __orobi_peer_lookup(ctx, their_public_key);
+    if (!peer) {
+        return __orobi_fail(ctx, OROBI_ERROR_CRYPTOGRAPHIC_FAILURE, "Shared key computation failed");
+    }
+
+    // Transportfelder sichern, Rest (inkl. Padding) deterministisch für die Prüfsumme
+    const uint32_t peer_ip = ticket->peer_ip;
+    const uint16_t peer_port = ticket->peer_port;
+    const uint16_t api_key = ticket->api_key;
+    memset(ticket, 0, sizeof(orobi_session_ticket_t));
+    ticket->version = OROBI_SESSION_VERSION;
+    ticket->tx_limit = __orobi_session_limit(ctx->tx_counter, OROBI_SESSION_TX_LEASE);
+    ticket->rx_limit = __orobi_session_limit(__orobi_peer_rx_top(peer), OROBI_SESSION_RX_LEASE);
+    ticket->peer_ip = peer_ip;
+    ticket->peer_port = peer_port;
+    ticket->api_key = api_key;
+    memcpy(ticket->peer_public_key, their_public_key, crypto_box_PUBLICKEYBYTES);
+    memcpy(ticket->shared_key, peer->shared_key, crypto_box_BEFORENMBYTES);
+    ticket->check = __orobi_session_check(ctx, ticket);
+
+    ctx->session_tx_limit = ticket->tx_limit;
+    ctx->session_rx_limit = ticket->rx_limit;
+    return OROBI_OK;
+}
+
+bool orobi_secure_session_due(const orobi_secure_t* ctx, const unsigned char* their_public_key) {
+    if (!ctx || !their_public_key) {
+        return false;
+    }
+    if (ctx->session_tx_limit == 0) {
+        return true;
+    }
+
+    bool found;
+    const orobi_secure_peer_t* peer = __orobi_peer_slot(ctx, their_public_key, &found);
+    const uint32_t rx_top = found ? __orobi_peer_rx_top(peer) : 0;
+    return ctx->tx_counter + OROBI_SESSION_TX_LEASE / 2 >= ctx->session_tx_limit ||
+           rx_top + OROBI_SESSION_RX_LEASE / 2 >= ctx->session_rx_limit;
+}
+
+orobi_error_t orobi_secure_session_resume(orobi_secure_t* ctx, const orobi_session_ticket_t* ticket) {
+    if (!ctx || !ticket) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (ticket->version != OROBI_SESSION_VERSION || ticket->tx_limit == 0 ||
+        ticket->check != __orobi_session_check(ctx, ticket)) {
+        return __orobi_fail(ctx, OROBI_ERROR_HASH_MISMATCH, "Invalid session ticket");
+    }
+
+    bool found;
+    orobi_secure_peer_t* peer = __orobi_peer_slot(ctx, ticket->peer_public_key, &found);
+    memset(peer, 0, sizeof(orobi_secure_peer_t));
+    memcpy(peer->public_key, ticket->peer_public_key, crypto_box_PUBLICKEYBYTES);
+    memcpy(peer->shared_key, ticket->shared_key, crypto_box_BEFORENMBYTES);
+    // Alles bis rx_limit gilt als gesehen: kein Replay aus der Zeit vor dem Neustart
+    __orobi_replay_fill(ctx, &peer->replay, ticket->rx_limit);
+    peer->last_used = ++ctx->peer_clock;
+    peer->valid = true;
+
+    // Nächster gesendeter Counter liegt über allem, was die Gegenstelle schon gesehen haben kann;
+    // der Präfix wird beim ersten Paket neu gezogen
+    ctx->tx_counter = ticket->tx_limit;
+    ctx->nonce_prefix_valid = false;
+    ctx->session_tx_limit = ticket->tx_limit;
+    ctx->session_rx_limit = ticket->rx_limit;
+    return OROBI_OK;
 }
 
 orobi_error_t orobi_secure_close(orobi_secure_t* ctx) {
-    if (!ctx ) {
-        ctx->last_status = OROBI_ERROR_INVALID_INPUT ;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Invalid input parameters");
-        return ctx->last_status;
+    if (!ctx) {
+        return OROBI_ERROR_INVALID_INPUT;
     }
 
     ctx->id.high = 0;
     ctx->id.low = 0;
+    orobi_secure_invalidate_peers(ctx);
+    orobi_random_wipe(&ctx->random);
+    __orobi_scratch_drop(ctx);
 
     free(ctx);
     ctx = NULL;
@@ -127,51 +814,54 @@ orobi_error_t orobi_secure_close(orobi_secure_t* ctx) {
     return OROBI_OK;
 }
 
+// Hash aus message + size + api_key + timestamp + bound + nonce, direkt über die Felder des Pakets
+static uint64_t __orobi_packet_hash(orobi_secure_t* ctx, const orobi_packet_t* packet) {
+    const uint64_t start = __orobi_metrics_clock(ctx);
+    const uint16_t size = packet->message_size;
+    orobi_murmur3_state_t state;
+
+    orobi_murmur3_64_init(&state, size + sizeof(uint16_t) + sizeof(uint64_t) +
+                                  sizeof(uint32_t) + sizeof(uint64_t) + crypto_box_NONCEBYTES, ctx->id.high);
+    orobi_murmur3_64_update(&state, packet->message, size);
+    orobi_murmur3_64_update(&state, &size, sizeof(uint16_t));
+    orobi_murmur3_64_update(&state, &packet->api_key, sizeof(uint64_t));
+    orobi_murmur3_64_update(&state, &packet->timestamp_ms, sizeof(uint32_t));
+    orobi_murmur3_64_update(&state, &packet->bound, sizeof(uint64_t));
+    orobi_murmur3_64_update(&state, packet->nonce.bytes, crypto_box_NONCEBYTES);
+    const uint64_t hash = orobi_murmur3_64_final(&state);
+    __orobi_metrics_elapsed(&ctx->metrics.hash_ns, start);
+    return hash;
+}
+
 // Erstellt ein Paket mit erweiterten Sicherheitsfeatures
 orobi_error_t orobi_create_packet(orobi_secure_t* ctx, orobi_packet_t* packet, 
                             const char* message, uint16_t size) {
+    return orobi_create_packet_bound(ctx, packet, message, size, 0);
+}
+
+orobi_error_t orobi_create_packet_bound(orobi_secure_t* ctx, orobi_packet_t* packet, const char* message,
+                                        uint16_t size, uint64_t bound) {
     if (!ctx || !packet || !message || size > OROBI_MAXMESSAGESIZE ) {
-        ctx->last_status = OROBI_ERROR_INVALID_INPUT ;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Invalid input parameters");
-        return ctx->last_status;
+        return __orobi_fail(ctx, OROBI_ERROR_INVALID_INPUT, "Invalid input parameters");
     }
 
+    const uint64_t start = __orobi_metrics_begin(ctx);
     memset(packet, 0, sizeof(orobi_packet_t));
     memcpy(packet->message, message, size);
     packet->message_size = size;
     packet->api_key = ctx->id.low;
-    packet->timestamp = time(NULL);
+    packet->timestamp_ms = __orobi_packet_time(ctx);
+    packet->bound = bound;
     
-    // Generiere neue Nonce
-    __orobi_generate_nonce(&packet->nonce);
-    
-    // Erstelle Hash aus allen relevanten Feldern
-    uint8_t* hash_data = malloc(size + sizeof(uint16_t) + sizeof(uint64_t) + 
-                               sizeof(time_t) + crypto_box_NONCEBYTES);
-    if (!hash_data) {
-        ctx->last_status = OROBI_ERROR_OUTOFMEM;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Memory allocation failed");
-        return ctx->last_status;
+    // Generiere neue Nonce (gleicher Zeitstempel wie das Paket)
+    if (__orobi_generate_nonce(ctx, &packet->nonce, packet->timestamp_ms) != OROBI_OK) {
+        return __orobi_fail(ctx, OROBI_ERROR_INITIALIZATION_FAILED, "Random source unavailable");
     }
     
-    size_t hash_size = 0;
-    memcpy(hash_data + hash_size, message, size);
-    hash_size += size;
-    memcpy(hash_data + hash_size, &size, sizeof(uint16_t));
-    hash_size += sizeof(uint16_t);
-    memcpy(hash_data + hash_size, &ctx->id.low, sizeof(uint64_t));
-    hash_size += sizeof(uint64_t);
-    memcpy(hash_data + hash_size, &packet->timestamp, sizeof(time_t));
-    hash_size += sizeof(time_t);
-    memcpy(hash_data + hash_size, packet->nonce.bytes, crypto_box_NONCEBYTES);
-    hash_size += crypto_box_NONCEBYTES;
-    
-    packet->packet_hash = orobi_murmur3_64(hash_data, hash_size, ctx->id.high);
-    free(hash_data);
-    hash_data = NULL;
+    // Erstelle Hash aus allen relevanten Feldern
+    packet->packet_hash = __orobi_packet_hash(ctx, packet);
     
-    ctx->last_status = OROBI_OK;
-    return OROBI_OK;
+    return __orobi_metrics_done(ctx, OROBI_METRIC_CREATE, start);
 }
 
 // Verschlüsselt ein Paket mit erweiterten Sicherheitsfeatures
@@ -179,45 +869,46 @@ orobi_error_t orobi_encrypt_packet(orobi_secure_t* ctx, const orobi_packet_t* pa
                              orobi_crypt_packet_t* crypt_packet,
                              const unsigned char* their_public_key) {
     if (!ctx || !packet || !crypt_packet || !their_public_key) {
-        ctx->last_status = OROBI_ERROR_INVALID_INPUT;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Invalid input parameters");
-        return ctx->last_status;
+        return __orobi_fail(ctx, OROBI_ERROR_INVALID_INPUT, "Invalid input parameters");
+    }
+
+    const uint64_t start = __orobi_metrics_begin(ctx);
+    orobi_secure_peer_t* peer = __orobi_peer_lookup(ctx, their_public_key);
+    if (!peer) {
+        return __orobi_fail(ctx, OROBI_ERROR_CRYPTOGRAPHIC_FAILURE, "Shared key computation failed");
     }
 
     // Kopiere Nonce
-    memcpy(&crypt_packet->nonce, &packet->nonce, sizeof(secure_nonce_t));
+    memcpy(&crypt_packet->nonce, &packet->nonce, sizeof(orobi_secure_nonce_t));
     
     // Vorbereitung der Verschlüsselung
-    unsigned char* temp = malloc(sizeof(orobi_packet_t) + crypto_box_ZEROBYTES);
+    unsigned char* temp = __orobi_scratch_acquire(ctx, sizeof(orobi_packet_t) + crypto_box_ZEROBYTES);
     if (!temp) {
-        ctx->last_status = OROBI_ERROR_OUTOFMEM;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Memory allocation failed");
-        return ctx->last_status;
+        return __orobi_fail(ctx, OROBI_ERROR_MEMORY, "Memory allocation failed");
     }
     
     memset(temp, 0, crypto_box_ZEROBYTES);
     memcpy(temp + crypto_box_ZEROBYTES, packet, sizeof(orobi_packet_t));
     
     // Verschlüsseln
-    if (crypto_box(crypt_packet->encrypted_data, temp, 
-                  sizeof(packet_t) + crypto_box_ZEROBYTES,
-                  packet->nonce.bytes, their_public_key, ctx->secret_key) != 0) {
-        free(temp); temp = NULL;
-        ctx->last_status = OROBI_ERROR_ENCRYPTION_FAILED ;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Encryption failed");
-        return ctx->last_status;
+    const uint64_t crypto_start = __orobi_metrics_clock(ctx);
+    const int rc = orobi_crypto_box_afternm(crypt_packet->encrypted_data, temp,
+                                            sizeof(orobi_packet_t) + crypto_box_ZEROBYTES,
+                                            packet->nonce.bytes, peer->shared_key);
+    __orobi_metrics_elapsed(&ctx->metrics.crypto_ns, crypto_start);
+    if (rc != 0) {
+        __orobi_scratch_release(ctx, temp); temp = NULL;
+        return __orobi_fail(ctx, OROBI_ERROR_ENCRYPTION_FAILED, "Encryption failed");
     }
     
-    free(temp);
+    __orobi_scratch_release(ctx, temp);
     temp = NULL;
     
     // Erstelle Hash der verschlüsselten Daten
-    crypt_packet->crypt_hash = orobi_murmur3_64(crypt_packet->encrypted_data,
-                                         sizeof(crypt_packet->encrypted_data),
-                                         OROBI_MURMUR_SEED);
+    crypt_packet->crypt_hash = __orobi_timed_hash(ctx, OROBI_HASH_MURMUR3_64, crypt_packet->encrypted_data,
+                                                  sizeof(crypt_packet->encrypted_data));
     
-    ctx->last_status = SECURE_OK;
-    return OROBI_OK;
+    return __orobi_metrics_done(ctx, OROBI_METRIC_ENCRYPT, start);
 }
 
 // Entschlüsselt und validiert ein Paket
@@ -226,76 +917,222 @@ orobi_error_t orobi_decrypt_packet(orobi_secure_t* ctx,
                                           orobi_packet_t* packet,
                                           const unsigned char* their_public_key) {
     if (!ctx || !packet || !crypt_packet || !their_public_key) {
-        ctx->last_status = OROBI_ERROR_INVALID_INPUT;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Invalid input parameters");
-        return ctx->last_status;
+        return __orobi_fail(ctx, OROBI_ERROR_INVALID_INPUT, "Invalid input parameters");
     }
 
+    const uint64_t start = __orobi_metrics_begin(ctx);
+
     // Überprüfe Hash der verschlüsselten Daten
-    uint64_t calculated_crypt_hash = orobi_murmur3_64(crypt_packet->encrypted_data,
-                                               sizeof(crypt_packet->encrypted_data),
-                                               MURMUR_SEED);
+    uint64_t calculated_crypt_hash = __orobi_timed_hash(ctx, OROBI_HASH_MURMUR3_64, crypt_packet->encrypted_data,
+                                                        sizeof(crypt_packet->encrypted_data));
     if (calculated_crypt_hash != crypt_packet->crypt_hash) {
-        ctx->last_status = OROBI_ERROR_HASH_MISMATCH ;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Encrypted data hash mismatch");
-        return ctx->last_status;
+        return __orobi_fail(ctx, OROBI_ERROR_HASH_MISMATCH, "Encrypted data hash mismatch");
     }
     
+    orobi_secure_peer_t* peer = __orobi_peer_lookup(ctx, their_public_key);
+    if (!peer) {
+        return __orobi_fail(ctx, OROBI_ERROR_CRYPTOGRAPHIC_FAILURE, "Shared key computation failed");
+    }
+
+    // Alter und Replay nach den Nonce-Bytes: die Klartext-Kopie von Counter und Zeitstempel ist nicht geschützt
+    orobi_secure_nonce_t nonce;
+    __orobi_nonce_from_bytes(&nonce, crypt_packet->nonce.bytes);
+
+    uint32_t deviation;
+    if (!__orobi_is_packet_fresh(ctx, peer, &nonce, &deviation)) {
+        return __orobi_fail_too_old(ctx, &nonce, deviation);
+    }
+
     // Prüfe Nonce auf Replay
-    if (!__orobi_is_nonce_valid(ctx, &crypt_packet->nonce)) {
-        ctx->last_status = ERROR_NONCE_REPLAY;
-        snprintf(ctx->last_error, ERROR_BUFFER_SIZE, "Invalid nonce (possible replay attack)");
-        return ctx->last_status;
+    if (!__orobi_is_nonce_valid(ctx, peer, &nonce)) {
+        return __orobi_fail(ctx, OROBI_ERROR_NONCE_REPLAY, "Invalid nonce (possible replay attack)");
     }
-    
+
     // Entschlüsselung vorbereiten
-    unsigned char* temp = malloc(sizeof(packet_t) + crypto_box_ZEROBYTES);
+    unsigned char* temp = __orobi_scratch_acquire(ctx, sizeof(orobi_packet_t) + crypto_box_ZEROBYTES);
     if (!temp) {
-        ctx->last_status = OROBI_ERROR_OUTOFMEM;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Memory allocation failed");
-        return ctx->last_status;
+        return __orobi_fail(ctx, OROBI_ERROR_MEMORY, "Memory allocation failed");
     }
     
     // Entschlüsseln
-    if (crypto_box_open(temp, crypt_packet->encrypted_data,
-                       sizeof(crypt_packet->encrypted_data),
-                       crypt_packet->nonce.bytes,
-                       their_public_key, ctx->secret_key) != 0) {
-        free(temp);
-        ctx->last_status = OROBI_ERROR_ENCRYPTION_FAILED ;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Decryption failed");
-        return ctx->last_status;
+    const uint64_t crypto_start = __orobi_metrics_clock(ctx);
+    const int rc = orobi_crypto_box_open_afternm(temp, crypt_packet->encrypted_data,
+                                                 sizeof(crypt_packet->encrypted_data),
+                                                 nonce.bytes, peer->shared_key);
+    __orobi_metrics_elapsed(&ctx->metrics.crypto_ns, crypto_start);
+    if (rc != 0) {
+        __orobi_scratch_release(ctx, temp);
+        return __orobi_fail(ctx, OROBI_ERROR_DECRYPTION_FAILED, "Decryption failed");
     }
     
     // Kopiere entschlüsselte Daten
-    memcpy(packet, temp + crypto_box_ZEROBYTES, sizeof(packet_t));
-    free(temp);
+    memcpy(packet, temp + crypto_box_ZEROBYTES, sizeof(orobi_packet_t));
+    __orobi_scratch_release(ctx, temp);
     temp = NULL;
     
     // Validiere Paket
-    uint8_t* hash_data = malloc(packet->message_size + sizeof(uint16_t) + 
-                               sizeof(uint64_t) + sizeof(time_t) + 
-                               crypto_box_NONCEBYTES);
-    if (!hash_data) {
-        ctx->last_status = OROBI_ERROR_OUTOFMEM;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Memory allocation failed");
-        return ctx->last_status;
+    if (packet->message_size > OROBI_MAXMESSAGESIZE ||
+        packet->nonce.counter != nonce.counter ||
+        __orobi_packet_hash(ctx, packet) != packet->packet_hash ) {
+        return __orobi_fail(ctx, OROBI_ERROR_HASH_MISMATCH, "Packet data hash mismatch");
     }
-    
-    size_t hash_size = 0;
-    memcpy(hash_data + hash_size, packet->message, packet->message_size);
-    hash_size += packet->message_size;
-    memcpy(hash_data + hash_size, &packet->message_size, sizeof(uint16_t));
-    hash_size += sizeof(uint16_t);
-    memcpy(hash_data + hash_size, &packet->api_key, sizeof(uint64_t));
-    hash_size += sizeof(uint64_t);
-
-    uint64_t calculated_hash = orobi_murmur3_64(hash_data, hash_size, ctx->id.high);
-    if(calculated_hash != packet->packet_hash ) {
-        ctx->last_status = OROBI_ERROR_HASH_MISMATCH ;
-        snprintf(ctx->last_error, OROBI_ERROR_BUFFER_SIZE, "Packet data hash mismatch");
-        return ctx->last_status;
+
+    __orobi_accept_nonce(ctx, peer, &nonce);
+    return __orobi_metrics_done(ctx, OROBI_METRIC_DECRYPT, start);
+}
+
+// Kompaktes Wire-Format (alle Felder little-endian):
+//   Header:  version u8 | hash_algo u8 | message_size u16 | crypt_hash u64 | nonce[24]
+//   Body:    crypto_box ohne die BOXZEROBYTES, Klartext = api_key u64 | packet_hash u64 | timestamp_ms u64 | message
+// Counter und Zeitstempel der Nonce werden aus den Nonce-Bytes rekonstruiert und sind so durch den MAC geschützt.
+// bound wird nicht übertragen, sondern nur über packet_hash (in der Box) geprüft.
+orobi_error_t orobi_encode_packet(orobi_secure_t* ctx, const orobi_packet_t* packet,
+                             const unsigned char* their_public_key,
+                             uint8_t* buffer, size_t buffer_size, size_t* written) {
+    if (!ctx || !packet || !their_public_key || !buffer || !written ||
+        packet->message_size > OROBI_MAXMESSAGESIZE) {
+        return __orobi_fail(ctx, OROBI_ERROR_INVALID_INPUT, "Invalid input parameters");
     }
-    return OROBI_OK;
+
+    const size_t wire_size = OROBI_WIRE_SIZE(packet->message_size);
+    if (buffer_size < wire_size) {
+        __orobi_fail(ctx, OROBI_ERROR_BUFFER_OVERFLOW, "Wire buffer too small (%u < %u)");
+        ctx->last_detail_args[0] = (uint32_t)buffer_size;
+        ctx->last_detail_args[1] = (uint32_t)wire_size;
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    const uint64_t start = __orobi_metrics_begin(ctx);
+
+    orobi_secure_peer_t* peer = __orobi_peer_lookup(ctx, their_public_key);
+    if (!peer) {
+        return __orobi_fail(ctx, OROBI_ERROR_CRYPTOGRAPHIC_FAILURE, "Shared key computation failed");
+    }
+
+    // Klartext und Chiffrat liegen im selben temporären Puffer
+    const size_t box_size = crypto_box_ZEROBYTES + OROBI_WIRE_INNER_SIZE + packet->message_size;
+    unsigned char* temp = __orobi_scratch_acquire(ctx, 2 * box_size);
+    if (!temp) {
+        return __orobi_fail(ctx, OROBI_ERROR_MEMORY, "Memory allocation failed");
+    }
+    unsigned char* plain = temp;
+    unsigned char* cipher = temp + box_size;
+
+    memset(plain, 0, crypto_box_ZEROBYTES);
+    uint8_t* inner = plain + crypto_box_ZEROBYTES;
+    orobi_write_le64(inner, packet->api_key);
+    orobi_write_le64(inner + 8, packet->packet_hash);
+    orobi_write_le64(inner + 16, packet->timestamp_ms);
+    memcpy(inner + OROBI_WIRE_INNER_SIZE, packet->message, packet->message_size);
+
+    const uint64_t crypto_start = __orobi_metrics_clock(ctx);
+    const int rc = orobi_crypto_box_afternm(cipher, plain, box_size, packet->nonce.bytes, peer->shared_key);
+    __orobi_metrics_elapsed(&ctx->metrics.crypto_ns, crypto_start);
+    if (rc != 0) {
+        __orobi_scratch_release(ctx, temp); temp = NULL;
+        return __orobi_fail(ctx, OROBI_ERROR_ENCRYPTION_FAILED, "Encryption failed");
+    }
+
+    uint8_t* body = buffer + OROBI_WIRE_HEADER_SIZE;
+    const size_t body_size = box_size - crypto_box_BOXZEROBYTES;
+    memcpy(body, cipher + crypto_box_BOXZEROBYTES, body_size);
+    __orobi_scratch_release(ctx, temp);
+    temp = NULL;
+
+    buffer[0] = OROBI_WIRE_VERSION;
+    buffer[1] = (uint8_t)ctx->hash_algo;
+    orobi_write_le16(buffer + 2, packet->message_size);
+    orobi_write_le64(buffer + 4, __orobi_timed_hash(ctx, ctx->hash_algo, body, body_size));
+    memcpy(buffer + 12, packet->nonce.bytes, crypto_box_NONCEBYTES);
+
+    *written = wire_size;
+    return __orobi_metrics_done(ctx, OROBI_METRIC_ENCRYPT, start);
+}
+
+orobi_error_t orobi_decode_packet(orobi_secure_t* ctx, const uint8_t* buffer, size_t size,
+                             orobi_packet_t* packet, const unsigned char* their_public_key) {
+    return orobi_decode_packet_bound(ctx, buffer, size, 0, packet, their_public_key);
+}
+
+orobi_error_t orobi_decode_packet_bound(orobi_secure_t* ctx, const uint8_t* buffer, size_t size, uint64_t bound,
+                                        orobi_packet_t* packet, const unsigned char* their_public_key) {
+    if (!ctx || !buffer || !packet || !their_public_key) {
+        return __orobi_fail(ctx, OROBI_ERROR_INVALID_INPUT, "Invalid input parameters");
+    }
+
+    const uint64_t start = __orobi_metrics_begin(ctx);
+
+    if (size < OROBI_WIRE_SIZE(0) || buffer[0] != OROBI_WIRE_VERSION ||
+        !orobi_hash_supported((orobi_hash_algo_t)buffer[1])) {
+        return __orobi_fail(ctx, OROBI_ERROR_PACKET_VALIDATION_FAILED, "Invalid wire header");
+    }
+
+    const uint16_t message_size = orobi_read_le16(buffer + 2);
+    if (message_size > OROBI_MAXMESSAGESIZE || size != (size_t)OROBI_WIRE_SIZE(message_size)) {
+        return __orobi_fail(ctx, OROBI_ERROR_PACKET_VALIDATION_FAILED, "Invalid wire size");
+    }
+
+    // Überprüfe Hash der verschlüsselten Daten
+    const uint8_t* body = buffer + OROBI_WIRE_HEADER_SIZE;
+    const size_t body_size = size - OROBI_WIRE_HEADER_SIZE;
+    if (__orobi_timed_hash(ctx, (orobi_hash_algo_t)buffer[1], body, body_size) != orobi_read_le64(buffer + 4)) {
+        return __orobi_fail(ctx, OROBI_ERROR_HASH_MISMATCH, "Encrypted data hash mismatch");
+    }
+
+    // Nonce rekonstruieren (Layout wie in __orobi_generate_nonce)
+    orobi_secure_nonce_t nonce;
+    __orobi_nonce_from_bytes(&nonce, buffer + 12);
+
+    orobi_secure_peer_t* peer = __orobi_peer_lookup(ctx, their_public_key);
+    if (!peer) {
+        return __orobi_fail(ctx, OROBI_ERROR_CRYPTOGRAPHIC_FAILURE, "Shared key computation failed");
+    }
+
+    uint32_t deviation;
+    if (!__orobi_is_packet_fresh(ctx, peer, &nonce, &deviation)) {
+        return __orobi_fail_too_old(ctx, &nonce, deviation);
+    }
+
+    // Prüfe Nonce auf Replay
+    if (!__orobi_is_nonce_valid(ctx, peer, &nonce)) {
+        return __orobi_fail(ctx, OROBI_ERROR_NONCE_REPLAY, "Invalid nonce (possible replay attack)");
+    }
+
+    const size_t box_size = crypto_box_BOXZEROBYTES + body_size;
+    unsigned char* temp = __orobi_scratch_acquire(ctx, 2 * box_size);
+    if (!temp) {
+        return __orobi_fail(ctx, OROBI_ERROR_MEMORY, "Memory allocation failed");
+    }
+    unsigned char* cipher = temp;
+    unsigned char* plain = temp + box_size;
+
+    memset(cipher, 0, crypto_box_BOXZEROBYTES);
+    memcpy(cipher + crypto_box_BOXZEROBYTES, body, body_size);
+
+    const uint64_t crypto_start = __orobi_metrics_clock(ctx);
+    const int rc = orobi_crypto_box_open_afternm(plain, cipher, box_size, nonce.bytes, peer->shared_key);
+    __orobi_metrics_elapsed(&ctx->metrics.crypto_ns, crypto_start);
+    if (rc != 0) {
+        __orobi_scratch_release(ctx, temp); temp = NULL;
+        return __orobi_fail(ctx, OROBI_ERROR_DECRYPTION_FAILED, "Decryption failed");
+    }
+
+    const uint8_t* inner = plain + crypto_box_ZEROBYTES;
+    packet->message_size = message_size;
+    packet->api_key = orobi_read_le64(inner);
+    packet->packet_hash = orobi_read_le64(inner + 8);
+    packet->timestamp_ms = (uint32_t)orobi_read_le64(inner + 16);
+    packet->bound = bound;
+    packet->nonce = nonce;
+    memcpy(packet->message, inner + OROBI_WIRE_INNER_SIZE, message_size);
+    __orobi_scratch_release(ctx, temp);
+    temp = NULL;
+
+    // Validiere Paket
+    if (__orobi_packet_hash(ctx, packet) != packet->packet_hash) {
+        return __orobi_fail(ctx, OROBI_ERROR_HASH_MISMATCH, "Packet data hash mismatch");
+    }
+
+    __orobi_accept_nonce(ctx, peer, &nonce);
+    return __orobi_metrics_done(ctx, OROBI_METRIC_DECRYPT, start);
 }
- 
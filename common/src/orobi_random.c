@@ -0,0 +1,97 @@
+#include "orobi_random.h"
+#include "tweetnacl.h"
+#include <string.h>
+
+#ifdef ESP32
+#include "esp_system.h"
+#elif defined(__linux__)
+#include <sys/random.h>
+#endif
+
+// Zufallsbytes aus der Systemquelle, nur zum Seeden
+static bool __orobi_random_system(uint8_t* data, size_t size) {
+#ifdef ESP32
+    // Hardware-RNG; echte Entropie nur mit aktivem WLAN/BT oder bootloader_random_enable
+    esp_fill_random(data, size);
+    return true;
+#elif defined(__linux__)
+    size_t filled = 0;
+    while (filled < size) {
+        ssize_t n = getrandom(data + filled, size - filled, 0);
+        if (n <= 0) {
+            return false;
+        }
+        filled += (size_t)n;
+    }
+    return true;
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+// Neuer Keystream-Abschnitt; die ersten 32 Bytes werden der nächste Schlüssel
+static void __orobi_random_refill(orobi_random_t* random) {
+    uint8_t nonce[crypto_stream_salsa20_NONCEBYTES];
+    orobi_write_le64(nonce, random->block++);
+    crypto_stream_salsa20(random->buffer, OROBI_RANDOM_BUFFER_SIZE, nonce, random->key);
+    memcpy(random->key, random->buffer, OROBI_RANDOM_KEYBYTES);
+    memset(random->buffer, 0, OROBI_RANDOM_KEYBYTES);
+    random->pos = OROBI_RANDOM_KEYBYTES;
+}
+
+orobi_error_t orobi_random_init(orobi_random_t* random) {
+    if (!random) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    uint8_t seed[OROBI_RANDOM_KEYBYTES];
+    if (!__orobi_random_system(seed, sizeof(seed))) {
+        random->seeded = false;
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+    orobi_random_seed(random, seed);
+    memset(seed, 0, sizeof(seed));
+    return OROBI_OK;
+}
+
+void orobi_random_seed(orobi_random_t* random, const uint8_t seed[OROBI_RANDOM_KEYBYTES]) {
+    memcpy(random->key, seed, OROBI_RANDOM_KEYBYTES);
+    random->block = 0;
+    random->pos = OROBI_RANDOM_BUFFER_SIZE;
+    random->seeded = true;
+}
+
+orobi_error_t orobi_random_bytes(orobi_random_t* random, void* data, size_t size) {
+    if (!random || (!data && size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (!random->seeded) {
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+
+    uint8_t* out = (uint8_t*)data;
+    while (size > 0) {
+        if (random->pos == OROBI_RANDOM_BUFFER_SIZE) {
+            __orobi_random_refill(random);
+        }
+        size_t n = OROBI_RANDOM_BUFFER_SIZE - random->pos;
+        if (n > size) {
+            n = size;
+        }
+        // Ausgegebene Bytes sofort löschen
+        memcpy(out, random->buffer + random->pos, n);
+        memset(random->buffer + random->pos, 0, n);
+        random->pos += (uint16_t)n;
+        out += n;
+        size -= n;
+    }
+    return OROBI_OK;
+}
+
+void orobi_random_wipe(orobi_random_t* random) {
+    if (random) {
+        memset(random, 0, sizeof(orobi_random_t));
+    }
+}
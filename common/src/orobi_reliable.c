@@ -0,0 +1,307 @@
+#include "orobi_reliable.h"
+#include <stddef.h>
+#include <string.h>
+
+#define __OROBI_RELIABLE_SLOT(seq)  ((seq) & (OROBI_RELIABLE_WINDOW - 1))
+
+// Erweitert die unteren 16 Bit eines seq auf den 32-Bit-Wert, der ref am nächsten liegt
+static inline uint32_t __orobi_reliable_extend(uint32_t ref, uint16_t seq) {
+    return ref + (uint32_t)(int32_t)(int16_t)(uint16_t)(seq - (uint16_t)ref);
+}
+
+// seq liegt im Sendefenster [base, next)
+static inline bool __orobi_reliable_in_window(const orobi_reliable_tx_t* tx, uint32_t seq) {
+    return (int32_t)(seq - tx->base) >= 0 && (int32_t)(seq - tx->next) < 0;
+}
+
+orobi_error_t orobi_reliable_tx_init(orobi_reliable_tx_t* tx, orobi_ticket_table_t* timers, uint16_t channel,
+                                     uint64_t random) {
+    if (!tx || !timers || channel >= OROBI_RELIABLE_MAX_CHANNELS) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    memset(tx, 0, offsetof(orobi_reliable_tx_t, data));
+    tx->timers = timers;
+    tx->channel = channel;
+    tx->epoch = (uint32_t)(random >> 16);
+    tx->base = (uint16_t)random;
+    tx->next = (uint16_t)random;
+    tx->rto = OROBI_RELIABLE_RTO_INIT_MS;
+    return OROBI_OK;
+}
+
+void orobi_reliable_tx_reset(orobi_reliable_tx_t* tx) {
+    if (!tx) {
+        return;
+    }
+
+    for (uint32_t seq = tx->base; seq != tx->next; seq++) {
+        if (tx->unacked & (1u << __OROBI_RELIABLE_SLOT(seq))) {
+            orobi_ticket_table_remove(tx->timers, OROBI_RELIABLE_TICKET_ID(tx->channel, seq));
+        }
+    }
+    tx->unacked = 0;
+    tx->pending = 0;
+    tx->base = tx->next;
+}
+
+orobi_error_t orobi_reliable_send(orobi_reliable_tx_t* tx, const void* message, size_t size) {
+    if (!tx || (!message && size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (size > OROBI_RELIABLE_MAXPAYLOAD) {
+        return OROBI_ERROR_BUFFER_OVERFLOW;
+    }
+    if (tx->next - tx->base >= OROBI_RELIABLE_WINDOW) {
+        return OROBI_ERROR_COMMAND_OVERFLOW;
+    }
+
+    const uint32_t slot = __OROBI_RELIABLE_SLOT(tx->next);
+    uint8_t* p = tx->data[slot];
+    p[0] = OROBI_RELIABLE_DATA_MARKER;
+    orobi_write_le32(p + 1, tx->epoch);
+    orobi_write_le16(p + 5, (uint16_t)tx->next);
+    if (size > 0) {
+        memcpy(p + OROBI_RELIABLE_HEADER_SIZE, message, size);
+    }
+    tx->size[slot] = (uint16_t)(OROBI_RELIABLE_HEADER_SIZE + size);
+    tx->transmissions[slot] = 0;
+    tx->unacked |= 1u << slot;
+    tx->pending |= 1u << slot;
+    tx->next++;
+    return OROBI_OK;
+}
+
+bool orobi_reliable_poll(orobi_reliable_tx_t* tx, uint32_t now_ms, const uint8_t** message, size_t* size) {
+    if (!tx || !message || !size || !tx->pending) {
+        return false;
+    }
+
+    // Tabellenzeit steht auf dem letzten tick; den Rückstand auf now_ms zur Wartezeit addieren
+    const uint32_t lag = (int32_t)(now_ms - tx->timers->now) > 0 ? now_ms - tx->timers->now : 0;
+    const uint16_t wait = tx->rto + lag < UINT16_MAX ? (uint16_t)(tx->rto + lag) : UINT16_MAX;
+    for (uint32_t seq = tx->base; seq != tx->next; seq++) {
+        const uint32_t slot = __OROBI_RELIABLE_SLOT(seq);
+        if (!(tx->pending & (1u << slot))) {
+            continue;
+        }
+        if (orobi_ticket_table_create(tx->timers, OROBI_RELIABLE_TICKET_ID(tx->channel, seq), seq,
+                                      wait) != OROBI_OK) {
+            return false;
+        }
+
+        tx->pending &= ~(1u << slot);
+        if (tx->transmissions[slot] == 0) {
+            tx->stats.sent++;
+        } else {
+            tx->stats.retransmitted++;
+        }
+        if (tx->transmissions[slot] < UINT8_MAX) {
+            tx->transmissions[slot]++;
+        }
+        tx->sent_ms[slot] = now_ms;
+        tx->order[slot] = ++tx->tx_order;
+        // base erst beim Senden eintragen, damit der Empfänger den aktuellen Stand sieht
+        orobi_write_le16(tx->data[slot] + 7, (uint16_t)tx->base);
+        *message = tx->data[slot];
+        *size = tx->size[slot];
+        return true;
+    }
+    return false;
+}
+
+// RTO aus srtt/rttvar, ohne Backoff
+static void __orobi_reliable_update_rto(orobi_reliable_tx_t* tx) {
+    uint32_t rto = tx->srtt + (tx->rttvar * 4 > 1 ? tx->rttvar * 4 : 1);
+    if (rto < OROBI_RELIABLE_RTO_MIN_MS) {
+        rto = OROBI_RELIABLE_RTO_MIN_MS;
+    } else if (rto > OROBI_RELIABLE_RTO_MAX_MS) {
+        rto = OROBI_RELIABLE_RTO_MAX_MS;
+    }
+    tx->rto = rto;
+}
+
+// RTT-Messung nach RFC 6298 (nur Pakete ohne Wiederholung, Karn)
+static void __orobi_reliable_rtt_sample(orobi_reliable_tx_t* tx, uint32_t rtt) {
+    if (tx->srtt == 0) {
+        tx->srtt = rtt ? rtt : 1;
+        tx->rttvar = rtt / 2;
+    } else {
+        const uint32_t delta = tx->srtt > rtt ? tx->srtt - rtt : rtt - tx->srtt;
+        tx->rttvar = (3 * tx->rttvar + delta) / 4;
+        tx->srtt = (7 * tx->srtt + rtt) / 8;
+    }
+    __orobi_reliable_update_rto(tx);
+}
+
+// Gibt den Platz von seq frei; Erstübertragungen liefern eine RTT-Messung (Karn)
+static void __orobi_reliable_release(orobi_reliable_tx_t* tx, uint32_t seq, uint32_t now_ms) {
+    const uint32_t slot = __OROBI_RELIABLE_SLOT(seq);
+    if (!(tx->unacked & (1u << slot))) {
+        return;
+    }
+
+    if (!(tx->pending & (1u << slot))) {
+        orobi_ticket_table_remove(tx->timers, OROBI_RELIABLE_TICKET_ID(tx->channel, seq));
+    }
+    tx->unacked &= ~(1u << slot);
+    tx->pending &= ~(1u << slot);
+    tx->stats.acked++;
+    if (tx->transmissions[slot] == 0) {
+        return;
+    }
+    if ((int32_t)(tx->order[slot] - tx->acked_order) > 0) {
+        tx->acked_order = tx->order[slot];
+        tx->acked_sent_ms = tx->sent_ms[slot];
+    }
+    if (tx->transmissions[slot] == 1) {
+        __orobi_reliable_rtt_sample(tx, now_ms - tx->sent_ms[slot]);
+    }
+}
+
+orobi_error_t orobi_reliable_ack(orobi_reliable_tx_t* tx, const void* message, size_t size, uint32_t now_ms) {
+    const uint8_t* p = (const uint8_t*)message;
+    if (!tx || !p || size < OROBI_RELIABLE_ACK_SIZE || p[0] != OROBI_RELIABLE_ACK_MARKER) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    const uint32_t cum = __orobi_reliable_extend(tx->base, orobi_read_le16(p + 1));
+    const uint32_t sack = orobi_read_le32(p + 3);
+    if ((int32_t)(cum - tx->next) > 0) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    const uint64_t acked = tx->stats.acked;
+    for (uint32_t seq = tx->base; (int32_t)(seq - cum) < 0; seq++) {
+        __orobi_reliable_release(tx, seq, now_ms);
+    }
+    for (uint32_t bits = sack; bits; bits &= bits - 1) {
+        const uint32_t seq = cum + 1 + (uint32_t)__builtin_ctz(bits);
+        if (__orobi_reliable_in_window(tx, seq)) {
+            __orobi_reliable_release(tx, seq, now_ms);
+        }
+    }
+    // Neue Daten bestätigt: die Verbindung lebt, Backoff verwerfen (wie Linux; Karn allein liefert nach
+    // Wiederholungen lange keine Messung)
+    if (tx->stats.acked != acked && tx->srtt != 0) {
+        __orobi_reliable_update_rto(tx);
+    }
+
+    while (tx->base != tx->next && !(tx->unacked & (1u << __OROBI_RELIABLE_SLOT(tx->base)))) {
+        tx->base++;
+    }
+
+    // Verlust: mindestens DUPTHRESH höhere seq beim Empfänger und eine um mehr als srtt/4 später gesendete
+    // Übertragung bestätigt (Toleranz für umsortierte Pakete, vgl. RACK)
+    const uint32_t reorder_ms = tx->srtt / 4 > 1 ? tx->srtt / 4 : 1;
+    for (uint32_t seq = tx->base; seq != tx->next; seq++) {
+        const uint32_t slot = __OROBI_RELIABLE_SLOT(seq);
+        if (!(tx->unacked & (1u << slot)) || (tx->pending & (1u << slot)) || (int32_t)(seq - cum) < 0) {
+            continue;
+        }
+        const uint32_t shift = seq - cum;
+        const uint32_t above = shift < 32 ? (uint32_t)__builtin_popcount(sack >> shift) : 0;
+        if (above >= OROBI_RELIABLE_DUPTHRESH && (int32_t)(tx->order[slot] - tx->acked_order) < 0 &&
+            (int32_t)(tx->acked_sent_ms - tx->sent_ms[slot]) > (int32_t)reorder_ms) {
+            orobi_ticket_table_remove(tx->timers, OROBI_RELIABLE_TICKET_ID(tx->channel, seq));
+            tx->pending |= 1u << slot;
+            tx->stats.fast_retransmits++;
+        }
+    }
+    return OROBI_OK;
+}
+
+void orobi_reliable_timeout(orobi_reliable_tx_t* tx, const orobi_ticket_t* ticket) {
+    if (!tx || !ticket) {
+        return;
+    }
+
+    const uint32_t seq = ticket->ip;
+    const uint32_t slot = __OROBI_RELIABLE_SLOT(seq);
+    if (!__orobi_reliable_in_window(tx, seq) || !(tx->unacked & (1u << slot)) || (tx->pending & (1u << slot))) {
+        return;
+    }
+
+    tx->pending |= 1u << slot;
+    tx->stats.timeouts++;
+    // Einmal verdoppeln pro Timeout-Ereignis: gleichzeitig abgelaufene Pakete liefen noch mit dem alten RTO
+    if (ticket->wait >= tx->rto) {
+        tx->rto = tx->rto * 2 < OROBI_RELIABLE_RTO_MAX_MS ? tx->rto * 2 : OROBI_RELIABLE_RTO_MAX_MS;
+    }
+}
+
+uint32_t orobi_reliable_in_flight(const orobi_reliable_tx_t* tx) {
+    return tx ? (uint32_t)__builtin_popcount(tx->unacked) : 0;
+}
+
+void orobi_reliable_rx_init(orobi_reliable_rx_t* rx) {
+    if (rx) {
+        memset(rx, 0, sizeof(*rx));
+    }
+}
+
+// Rückt next um count vor und danach über alle bereits empfangenen seq
+static void __orobi_reliable_advance(orobi_reliable_rx_t* rx, uint32_t count) {
+    rx->window = count < 64 ? rx->window >> count : 0;
+    rx->next += count;
+    while (rx->window & 1) {
+        rx->window >>= 1;
+        rx->next++;
+    }
+}
+
+orobi_error_t orobi_reliable_receive(orobi_reliable_rx_t* rx, const void* message, size_t size,
+                                     const uint8_t** payload, size_t* payload_size) {
+    const uint8_t* p = (const uint8_t*)message;
+    if (!rx || !p || !payload || !payload_size || size < OROBI_RELIABLE_HEADER_SIZE ||
+        p[0] != OROBI_RELIABLE_DATA_MARKER) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    const uint32_t epoch = orobi_read_le32(p + 1);
+    const uint32_t base = __orobi_reliable_extend(rx->next, orobi_read_le16(p + 7));
+    if (!rx->synced || rx->epoch != epoch) {
+        // Erstes Paket oder neu gestarteter Sender: dessen Stand übernehmen
+        rx->epoch = epoch;
+        rx->next = base;
+        rx->window = 0;
+        rx->synced = true;
+    } else if ((int32_t)(base - rx->next) > 0) {
+        // Sender hat die seq unterhalb von base aufgegeben (orobi_reliable_tx_reset). Ein verspätetes Paket
+        // trägt ein älteres base und liegt damit nie vor next.
+        __orobi_reliable_advance(rx, base - rx->next);
+    }
+
+    const uint32_t seq = __orobi_reliable_extend(rx->next, orobi_read_le16(p + 5));
+    const int32_t offset = (int32_t)(seq - rx->next);
+    if (offset >= (int32_t)OROBI_RELIABLE_WINDOW) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    rx->ack_due = true;
+    if (offset < 0 || (rx->window & (1ull << offset))) {
+        rx->duplicates++;
+        return OROBI_ERROR_NONCE_REPLAY;
+    }
+
+    rx->window |= 1ull << offset;
+    __orobi_reliable_advance(rx, 0);
+    rx->received++;
+    *payload = p + OROBI_RELIABLE_HEADER_SIZE;
+    *payload_size = size - OROBI_RELIABLE_HEADER_SIZE;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_reliable_ack_write(orobi_reliable_rx_t* rx, void* buffer, size_t capacity, size_t* written) {
+    uint8_t* p = (uint8_t*)buffer;
+    if (!rx || !p || !written || capacity < OROBI_RELIABLE_ACK_SIZE) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    p[0] = OROBI_RELIABLE_ACK_MARKER;
+    orobi_write_le16(p + 1, (uint16_t)rx->next);
+    orobi_write_le32(p + 3, (uint32_t)(rx->window >> 1));
+    *written = OROBI_RELIABLE_ACK_SIZE;
+    rx->ack_due = false;
+    return OROBI_OK;
+}
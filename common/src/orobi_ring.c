@@ -0,0 +1,64 @@
+#include "orobi_ring.h"
+
+orobi_error_t orobi_ring_init(orobi_ring_t* ring, void* storage, size_t slot_size, uint32_t capacity) {
+    if (!ring || !storage || slot_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+    ring->high_water = 0;
+    ring->slots = (uint8_t*)storage;
+    ring->slot_size = slot_size;
+    ring->mask = capacity - 1;
+    return OROBI_OK;
+}
+
+void* orobi_ring_acquire_write(orobi_ring_t* ring) {
+    const uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail > ring->mask) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return NULL;
+    }
+    return ring->slots + (size_t)(head & ring->mask) * ring->slot_size;
+}
+
+void orobi_ring_commit_write(orobi_ring_t* ring) {
+    const uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_relaxed) + 1;
+    const uint32_t depth = head - (uint32_t)atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (depth > ring->high_water) {
+        ring->high_water = depth;
+    }
+    // release: der Slot-Inhalt ist sichtbar, bevor der Consumer den neuen head sieht
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+}
+
+void* orobi_ring_acquire_read(orobi_ring_t* ring) {
+    const uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    const uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (head == tail) {
+        return NULL;
+    }
+    return ring->slots + (size_t)(tail & ring->mask) * ring->slot_size;
+}
+
+void orobi_ring_release_read(orobi_ring_t* ring) {
+    const uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    // release: der Slot ist fertig gelesen, bevor der Producer ihn wieder beschreiben darf
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+uint32_t orobi_ring_depth(const orobi_ring_t* ring) {
+    const uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_acquire);
+    const uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_acquire);
+    return head - tail;
+}
+
+uint32_t orobi_ring_capacity(const orobi_ring_t* ring) {
+    return ring->mask + 1;
+}
@@ -0,0 +1,148 @@
+#include "orobi_telemetry.h"
+#include <string.h>
+
+size_t orobi_telemetry_frame_size(uint8_t flags) {
+    size_t size = OROBI_TELEMETRY_HEADER_SIZE;
+    size += (flags & OROBI_TELEMETRY_HAS_BATTERY) ? 2 : 0;
+    size += (flags & OROBI_TELEMETRY_HAS_MOTOR) ? 4 : 0;
+    size += (flags & OROBI_TELEMETRY_HAS_HEADING) ? 2 : 0;
+    size += (flags & OROBI_TELEMETRY_HAS_DISTANCE) ? 2 : 0;
+    size += (flags & OROBI_TELEMETRY_HAS_IMU) ? 6 : 0;
+    size += (flags & OROBI_TELEMETRY_HAS_TEMPERATURE) ? 2 : 0;
+    size += (flags & OROBI_TELEMETRY_HAS_RSSI) ? 1 : 0;
+    return size;
+}
+
+bool orobi_telemetry_is_message(const void* message, size_t size) {
+    return message && size >= 1 && ((const uint8_t*)message)[0] == OROBI_TELEMETRY_MARKER;
+}
+
+orobi_error_t orobi_telemetry_writer_init(orobi_telemetry_writer_t* writer, void* buffer, size_t capacity) {
+    if (!writer || !buffer || capacity < 1 + OROBI_TELEMETRY_HEADER_SIZE) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    writer->buffer[0] = OROBI_TELEMETRY_MARKER;
+    writer->size = 1;
+    writer->count = 0;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_telemetry_append(orobi_telemetry_writer_t* writer, const orobi_telemetry_t* frame) {
+    if (!writer || !frame || (frame->flags & ~OROBI_TELEMETRY_FLAGS_MASK)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (writer->size + orobi_telemetry_frame_size(frame->flags) > writer->capacity) {
+        return OROBI_ERROR_COMMAND_OVERFLOW;
+    }
+
+    uint8_t* p = writer->buffer + writer->size;
+    p[0] = frame->flags;
+    p[1] = frame->seq_nr;
+    p[2] = (uint8_t)frame->status;
+    orobi_write_le32(p + 3, frame->timestamp_ms);
+    p += OROBI_TELEMETRY_HEADER_SIZE;
+
+    if (frame->flags & OROBI_TELEMETRY_HAS_BATTERY) {
+        orobi_write_le16(p, frame->battery_mv);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_MOTOR) {
+        orobi_write_le16(p, frame->speed);
+        orobi_write_le16(p + 2, frame->rotation);
+        p += 4;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_HEADING) {
+        orobi_write_le16(p, frame->heading);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_DISTANCE) {
+        orobi_write_le16(p, frame->distance_mm);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_IMU) {
+        for (int i = 0; i < 3; i++) {
+            orobi_write_le16(p + 2 * i, (uint16_t)frame->accel[i]);
+        }
+        p += 6;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_TEMPERATURE) {
+        orobi_write_le16(p, (uint16_t)frame->temperature);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_RSSI) {
+        *p++ = (uint8_t)frame->rssi;
+    }
+
+    writer->size = (size_t)(p - writer->buffer);
+    writer->count++;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_telemetry_reader_init(orobi_telemetry_reader_t* reader, const void* message, size_t size) {
+    if (!reader || !orobi_telemetry_is_message(message, size)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    reader->data = message;
+    reader->size = size;
+    reader->pos = 1;
+    return OROBI_OK;
+}
+
+orobi_command_status_t orobi_telemetry_next(orobi_telemetry_reader_t* reader, orobi_telemetry_t* frame) {
+    if (!reader || !frame) {
+        return OROBI_COMMAND_STATUS_ERROR;
+    }
+    if (reader->pos == reader->size) {
+        return OROBI_COMMAND_STATUS_NODATA;
+    }
+
+    const uint8_t* p = reader->data + reader->pos;
+    const size_t left = reader->size - reader->pos;
+    if (left < OROBI_TELEMETRY_HEADER_SIZE || (p[0] & ~OROBI_TELEMETRY_FLAGS_MASK) ||
+        left < orobi_telemetry_frame_size(p[0]) || p[2] > OROBI_COMMAND_STATUS_INVALID_COMMAND) {
+        reader->pos = reader->size;
+        return OROBI_COMMAND_STATUS_ERROR;
+    }
+
+    memset(frame, 0, sizeof(orobi_telemetry_t));
+    frame->flags = p[0];
+    frame->seq_nr = p[1];
+    frame->status = (orobi_command_status_t)p[2];
+    frame->timestamp_ms = orobi_read_le32(p + 3);
+    reader->pos += orobi_telemetry_frame_size(frame->flags);
+    p += OROBI_TELEMETRY_HEADER_SIZE;
+
+    if (frame->flags & OROBI_TELEMETRY_HAS_BATTERY) {
+        frame->battery_mv = orobi_read_le16(p);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_MOTOR) {
+        frame->speed = orobi_read_le16(p);
+        frame->rotation = orobi_read_le16(p + 2);
+        p += 4;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_HEADING) {
+        frame->heading = orobi_read_le16(p);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_DISTANCE) {
+        frame->distance_mm = orobi_read_le16(p);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_IMU) {
+        for (int i = 0; i < 3; i++) {
+            frame->accel[i] = (int16_t)orobi_read_le16(p + 2 * i);
+        }
+        p += 6;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_TEMPERATURE) {
+        frame->temperature = (int16_t)orobi_read_le16(p);
+        p += 2;
+    }
+    if (frame->flags & OROBI_TELEMETRY_HAS_RSSI) {
+        frame->rssi = (int8_t)*p;
+    }
+    return OROBI_COMMAND_STATUS_OK;
+}
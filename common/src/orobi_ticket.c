@@ -2,6 +2,301 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Multiplikatives Hashing der 16-Bit id auf OROBI_TICKET_INDEX_BITS
+static inline uint32_t __orobi_ticket_hash(uint16_t id) {
+    return ((uint32_t)id * 2654435761u) >> (32 - OROBI_TICKET_INDEX_BITS);
+}
+
+// Position von id im Index, bzw. der freie Platz, an dem die Suche endet
+static uint32_t __orobi_ticket_probe(const orobi_ticket_table_t* table, uint16_t id) {
+    uint32_t pos = __orobi_ticket_hash(id);
+    while (table->index[pos] != OROBI_TICKET_NONE && table->ids[table->index[pos]] != id) {
+        pos = (pos + 1) & (OROBI_TICKET_INDEX_SIZE - 1);
+    }
+    return pos;
+}
+
+void orobi_ticket_table_init(orobi_ticket_table_t* table, uint32_t now_ms) {
+    if (!table) {
+        return;
+    }
+    orobi_ticket_table_clear(table);
+    table->now = now_ms;
+}
+
+static void __orobi_wheel_link(orobi_ticket_table_t* table, uint16_t slot, uint16_t list) {
+    uint16_t head = table->wheel_head[list];
+    table->wheel_list[slot] = list;
+    table->wheel_prev[slot] = OROBI_TICKET_NONE;
+    table->wheel_next[slot] = head;
+    if (head != OROBI_TICKET_NONE) {
+        table->wheel_prev[head] = slot;
+    }
+    table->wheel_head[list] = slot;
+    if (list < OROBI_TICKET_WHEEL_SIZE) {
+        table->wheel_used[list >> 5] |= 1u << (list & 31);
+    } else if (list < OROBI_TICKET_WHEEL_DUE) {
+        const uint16_t l1 = list - OROBI_TICKET_WHEEL_SIZE;
+        table->wheel_used1[l1 >> 5] |= 1u << (l1 & 31);
+    }
+}
+
+static void __orobi_wheel_unlink(orobi_ticket_table_t* table, uint16_t slot) {
+    uint16_t list = table->wheel_list[slot];
+    uint16_t prev = table->wheel_prev[slot];
+    uint16_t next = table->wheel_next[slot];
+    if (prev != OROBI_TICKET_NONE) {
+        table->wheel_next[prev] = next;
+    } else {
+        table->wheel_head[list] = next;
+    }
+    if (next != OROBI_TICKET_NONE) {
+        table->wheel_prev[next] = prev;
+    }
+    if (table->wheel_head[list] != OROBI_TICKET_NONE) {
+        return;
+    }
+    if (list < OROBI_TICKET_WHEEL_SIZE) {
+        table->wheel_used[list >> 5] &= ~(1u << (list & 31));
+    } else if (list < OROBI_TICKET_WHEEL_DUE) {
+        const uint16_t l1 = list - OROBI_TICKET_WHEEL_SIZE;
+        table->wheel_used1[l1 >> 5] &= ~(1u << (l1 & 31));
+    }
+}
+
+// Ordnet den Slot relativ zu table->now in Stufe 0, Stufe 1 oder die Fällig-Liste ein
+static void __orobi_wheel_schedule(orobi_ticket_table_t* table, uint16_t slot) {
+    uint32_t deadline = table->deadlines[slot];
+    int32_t delta = (int32_t)(deadline - table->now);
+    uint16_t list;
+
+    if (delta <= 0) {
+        list = OROBI_TICKET_WHEEL_DUE;
+    } else if (delta < (int32_t)OROBI_TICKET_WHEEL_SIZE) {
+        list = deadline & (OROBI_TICKET_WHEEL_SIZE - 1);
+    } else {
+        list = OROBI_TICKET_WHEEL_SIZE + ((deadline >> OROBI_TICKET_WHEEL_BITS) & (OROBI_TICKET_WHEEL_SIZE - 1));
+    }
+    __orobi_wheel_link(table, slot, list);
+}
+
+void orobi_ticket_table_clear(orobi_ticket_table_t* table) {
+    if (!table) {
+        return;
+    }
+
+    memset(table->index, 0xFF, sizeof(table->index));
+    memset(table->wheel_head, 0xFF, sizeof(table->wheel_head));
+    memset(table->wheel_used, 0, sizeof(table->wheel_used));
+    memset(table->wheel_used1, 0, sizeof(table->wheel_used1));
+    for (uint16_t i = 0; i < OROBI_TICKET_CAPACITY; i++) {
+        table->next_free[i] = (i + 1 < OROBI_TICKET_CAPACITY) ? (uint16_t)(i + 1) : OROBI_TICKET_NONE;
+    }
+    table->free_head = 0;
+    table->count = 0;
+}
+
+orobi_error_t orobi_ticket_table_create(orobi_ticket_table_t* table, uint16_t id, uint32_t ip, uint16_t wait) {
+    if (!table) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    uint32_t pos = __orobi_ticket_probe(table, id);
+    uint16_t slot = table->index[pos];
+    if (slot == OROBI_TICKET_NONE) {
+        if (table->free_head == OROBI_TICKET_NONE) {
+            return OROBI_ERROR_MEMORY;
+        }
+        slot = table->free_head;
+        table->free_head = table->next_free[slot];
+        table->index[pos] = slot;
+        table->ids[slot] = id;
+        table->count++;
+    } else {
+        __orobi_wheel_unlink(table, slot);
+    }
+
+    table->ips[slot] = ip;
+    table->waits[slot] = wait;
+    table->deadlines[slot] = table->now + wait;
+    __orobi_wheel_schedule(table, slot);
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_ticket_table_find(const orobi_ticket_table_t* table, uint16_t id, orobi_ticket_t* ticket) {
+    if (!table || !ticket) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    uint16_t slot = table->index[__orobi_ticket_probe(table, id)];
+    if (slot == OROBI_TICKET_NONE) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    ticket->id = id;
+    ticket->ip = table->ips[slot];
+    ticket->wait = table->waits[slot];
+    ticket->next = NULL;
+    return OROBI_OK;
+}
+
+// Entfernt den Slot an Indexposition pos aus Wheel, Index und Slab
+static void __orobi_ticket_release(orobi_ticket_table_t* table, uint32_t pos) {
+    uint16_t slot = table->index[pos];
+
+    __orobi_wheel_unlink(table, slot);
+    table->next_free[slot] = table->free_head;
+    table->free_head = slot;
+    table->count--;
+
+    // Backward-Shift-Deletion: Nachfolger der Probe-Kette nachrücken lassen, keine Tombstones
+    uint32_t hole = pos;
+    uint32_t next = (pos + 1) & (OROBI_TICKET_INDEX_SIZE - 1);
+    while (table->index[next] != OROBI_TICKET_NONE) {
+        uint32_t home = __orobi_ticket_hash(table->ids[table->index[next]]);
+        // Eintrag darf nur nach vorne rücken, wenn hole zwischen home und next liegt (zyklisch)
+        if (((next - home) & (OROBI_TICKET_INDEX_SIZE - 1)) >= ((next - hole) & (OROBI_TICKET_INDEX_SIZE - 1))) {
+            table->index[hole] = table->index[next];
+            hole = next;
+        }
+        next = (next + 1) & (OROBI_TICKET_INDEX_SIZE - 1);
+    }
+    table->index[hole] = OROBI_TICKET_NONE;
+}
+
+orobi_error_t orobi_ticket_table_remove(orobi_ticket_table_t* table, uint16_t id) {
+    if (!table) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    uint32_t pos = __orobi_ticket_probe(table, id);
+    if (table->index[pos] == OROBI_TICKET_NONE) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    __orobi_ticket_release(table, pos);
+    return OROBI_OK;
+}
+
+// Entnimmt alle Tickets der Liste; false, wenn expired vorher voll wurde
+static bool __orobi_wheel_expire(orobi_ticket_table_t* table, uint16_t list,
+                                 orobi_ticket_t* expired, size_t max_expired, size_t* count) {
+    while (table->wheel_head[list] != OROBI_TICKET_NONE) {
+        if (*count >= max_expired) {
+            return false;
+        }
+        uint16_t slot = table->wheel_head[list];
+        orobi_ticket_t* ticket = &expired[(*count)++];
+        ticket->id = table->ids[slot];
+        ticket->ip = table->ips[slot];
+        ticket->wait = table->waits[slot];
+        ticket->next = NULL;
+        __orobi_ticket_release(table, __orobi_ticket_probe(table, table->ids[slot]));
+    }
+    return true;
+}
+
+// Erstes gesetztes Bit in [from, to) einer Wheel-Bitmap, sonst to
+static uint32_t __orobi_wheel_scan(const uint32_t* used, uint32_t from, uint32_t to) {
+    if (from >= to) {
+        return to;
+    }
+    uint32_t word = from >> 5;
+    uint32_t bits = used[word] & (~0u << (from & 31));
+    while (!bits) {
+        if (++word == OROBI_TICKET_WHEEL_SIZE / 32) {
+            return to;
+        }
+        bits = used[word];
+    }
+    const uint32_t pos = word * 32 + (uint32_t)__builtin_ctz(bits);
+    return pos < to ? pos : to;
+}
+
+// Belegter Stufe-1-Slot, der zum Kaskadenpunkt t (Vielfaches von 256) verteilt wird
+static bool __orobi_wheel_cascade_used(const orobi_ticket_table_t* table, uint32_t t) {
+    const uint32_t l1 = (t >> OROBI_TICKET_WHEEL_BITS) & (OROBI_TICKET_WHEEL_SIZE - 1);
+    return (table->wheel_used1[l1 >> 5] >> (l1 & 31)) & 1u;
+}
+
+// Nächster Zeitpunkt > t mit Arbeit: belegter Slot der Stufe 0 oder Kaskade eines belegten Stufe-1-Slots.
+// Stufe 0 enthält nur Ablaufzeiten in (t, t + 256), Stufe 1 nur Kaskadenpunkte in (t, t + 65536).
+static uint32_t __orobi_wheel_next(const orobi_ticket_table_t* table, uint32_t t) {
+    const uint32_t first = t + 1;
+    const uint32_t pos = first & (OROBI_TICKET_WHEEL_SIZE - 1);
+    const uint32_t base = first - pos;
+    if (pos == 0 && __orobi_wheel_cascade_used(table, first)) {
+        return first;
+    }
+
+    // Rest des laufenden Umlaufs
+    uint32_t slot = __orobi_wheel_scan(table->wheel_used, pos, OROBI_TICKET_WHEEL_SIZE);
+    if (slot < OROBI_TICKET_WHEEL_SIZE) {
+        return base + slot;
+    }
+
+    // Nächster Umlauf: erst dessen Kaskade, dann die Stufe-0-Slots vor pos
+    const uint32_t next = base + OROBI_TICKET_WHEEL_SIZE;
+    if (__orobi_wheel_cascade_used(table, next)) {
+        return next;
+    }
+    slot = __orobi_wheel_scan(table->wheel_used, 0, pos);
+    if (slot < pos) {
+        return next + slot;
+    }
+
+    // Danach nur noch Kaskaden: nächster belegter Stufe-1-Slot, zyklisch ab dem Umlauf nach next
+    const uint32_t from = ((next >> OROBI_TICKET_WHEEL_BITS) + 1) & (OROBI_TICKET_WHEEL_SIZE - 1);
+    uint32_t l1 = __orobi_wheel_scan(table->wheel_used1, from, OROBI_TICKET_WHEEL_SIZE);
+    if (l1 == OROBI_TICKET_WHEEL_SIZE) {
+        l1 = __orobi_wheel_scan(table->wheel_used1, 0, from);
+        if (l1 == from) {
+            return next + (OROBI_TICKET_WHEEL_SIZE << OROBI_TICKET_WHEEL_BITS);  // leer: ein ganzer Stufe-1-Umlauf
+        }
+    }
+    const uint32_t rows = (l1 - (next >> OROBI_TICKET_WHEEL_BITS)) & (OROBI_TICKET_WHEEL_SIZE - 1);
+    return next + (rows << OROBI_TICKET_WHEEL_BITS);
+}
+
+orobi_error_t orobi_ticket_tick(orobi_ticket_table_t* table, uint32_t now_ms,
+                                orobi_ticket_t* expired, size_t max_expired, size_t* count) {
+    if (!table || !count || (!expired && max_expired > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    *count = 0;
+
+    if (!__orobi_wheel_expire(table, OROBI_TICKET_WHEEL_DUE, expired, max_expired, count)) {
+        return OROBI_OK;
+    }
+
+    while ((int32_t)(now_ms - table->now) > 0) {
+        uint32_t t = __orobi_wheel_next(table, table->now);
+        if ((int32_t)(t - now_ms) > 0) {
+            break;
+        }
+
+        // Stufe-1-Slot in Stufe 0 verteilen, sobald Stufe 0 einmal umgelaufen ist
+        if ((t & (OROBI_TICKET_WHEEL_SIZE - 1)) == 0) {
+            // Alle Einträge liegen in [t, t + 255] und landen direkt in ihrem Stufe-0-Slot
+            uint16_t list = OROBI_TICKET_WHEEL_SIZE + ((t >> OROBI_TICKET_WHEEL_BITS) & (OROBI_TICKET_WHEEL_SIZE - 1));
+            while (table->wheel_head[list] != OROBI_TICKET_NONE) {
+                uint16_t slot = table->wheel_head[list];
+                __orobi_wheel_unlink(table, slot);
+                __orobi_wheel_link(table, slot, table->deadlines[slot] & (OROBI_TICKET_WHEEL_SIZE - 1));
+            }
+        }
+
+        if (!__orobi_wheel_expire(table, t & (OROBI_TICKET_WHEEL_SIZE - 1), expired, max_expired, count)) {
+            table->now = t - 1;
+            return OROBI_OK;
+        }
+        table->now = t;
+    }
+
+    table->now = now_ms;
+    return OROBI_OK;
+}
+
 orobi_error_t orobi_ticket_create(uint16_t id, uint32_t ip, uint16_t wait, orobi_ticket_t** ticket_buffer) {
     if (!ticket_buffer) {
         return OROBI_ERROR_INVALID_INPUT;
@@ -0,0 +1,209 @@
+#include "orobi_txqueue.h"
+#include <string.h>
+
+#if (OROBI_TXQUEUE_CONTROL_SLOTS & (OROBI_TXQUEUE_CONTROL_SLOTS - 1)) != 0 || OROBI_TXQUEUE_CONTROL_SLOTS > 128 || \
+    (OROBI_TXQUEUE_BULK_SLOTS & (OROBI_TXQUEUE_BULK_SLOTS - 1)) != 0 || OROBI_TXQUEUE_BULK_SLOTS > 128
+#error "OROBI_TXQUEUE_CONTROL_SLOTS und OROBI_TXQUEUE_BULK_SLOTS müssen Zweierpotenzen <= 128 sein"
+#endif
+
+static void __orobi_txqueue_stamp(const orobi_txqueue_t* queue, orobi_txqueue_entry_t* entry, orobi_txqueue_class_t cls,
+                                  uint32_t ttl_ms, uint32_t now_ms) {
+    if (ttl_ms == 0) {
+        ttl_ms = queue->ttl[cls];
+    }
+    entry->expires = ttl_ms != 0 && ttl_ms != OROBI_TXQUEUE_NO_DEADLINE;
+    entry->deadline = now_ms + ttl_ms;
+}
+
+// Frist abgelaufen: now_ms liegt hinter deadline (über den Umlauf von uint32_t hinweg)
+static bool __orobi_txqueue_expired(const orobi_txqueue_entry_t* entry, uint32_t now_ms) {
+    return entry->expires && (int32_t)(now_ms - entry->deadline) > 0;
+}
+
+static void __orobi_txqueue_pop_control(orobi_txqueue_t* queue) {
+    queue->control_head = (uint8_t)((queue->control_head + 1) & (OROBI_TXQUEUE_CONTROL_SLOTS - 1));
+    queue->control_count--;
+}
+
+static void __orobi_txqueue_pop_bulk(orobi_txqueue_t* queue) {
+    queue->bulk_head = (uint8_t)((queue->bulk_head + 1) & (OROBI_TXQUEUE_BULK_SLOTS - 1));
+    queue->bulk_count--;
+}
+
+void orobi_txqueue_init(orobi_txqueue_t* queue) {
+    if (!queue) {
+        return;
+    }
+
+    memset(queue, 0, sizeof(*queue));
+    queue->ttl[OROBI_TXQUEUE_MOTOR] = OROBI_TXQUEUE_MOTOR_TTL_MS;
+}
+
+void orobi_txqueue_reset(orobi_txqueue_t* queue) {
+    if (queue) {
+        queue->control_head = 0;
+        queue->control_count = 0;
+        queue->motor_pending = false;
+        queue->bulk_head = 0;
+        queue->bulk_count = 0;
+    }
+}
+
+void orobi_txqueue_set_ttl(orobi_txqueue_t* queue, orobi_txqueue_class_t cls, uint32_t ttl_ms) {
+    if (queue && cls < OROBI_TXQUEUE_CLASSES) {
+        queue->ttl[cls] = ttl_ms;
+    }
+}
+
+orobi_txqueue_class_t orobi_txqueue_classify(const orobi_command_t* command) {
+    switch (command->type) {
+        case OROBI_COMMAND_MOTORDATA:
+            return command->motor.buttons[0] ? OROBI_TXQUEUE_CONTROL : OROBI_TXQUEUE_MOTOR;
+        case OROBI_COMMAND_STRING:
+        case OROBI_COMMAND_USER:
+            return OROBI_TXQUEUE_BULK;
+        default:
+            return OROBI_TXQUEUE_CONTROL;
+    }
+}
+
+orobi_error_t orobi_txqueue_push(orobi_txqueue_t* queue, const orobi_command_t* command,
+                                 uint32_t ttl_ms, uint32_t now_ms) {
+    if (!queue || !command) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (command->type == OROBI_COMMAND_USER) {
+        return OROBI_ERROR_UNSUPPORTED_COMMAND;
+    }
+
+    orobi_error_t status = orobi_command_validate(command);
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    const orobi_txqueue_class_t cls = orobi_txqueue_classify(command);
+    orobi_txqueue_entry_t* entry;
+    switch (cls) {
+        case OROBI_TXQUEUE_CONTROL:
+            if (queue->control_count == OROBI_TXQUEUE_CONTROL_SLOTS) {
+                queue->stats[cls].rejected++;
+                return OROBI_ERROR_COMMAND_OVERFLOW;
+            }
+            entry = &queue->control[(queue->control_head + queue->control_count) & (OROBI_TXQUEUE_CONTROL_SLOTS - 1)];
+            queue->control_count++;
+            // Bremse überholt den wartenden Sollwert; der wäre sonst danach gesendet und wieder übernommen
+            if (command->type == OROBI_COMMAND_MOTORDATA && queue->motor_pending) {
+                queue->motor_pending = false;
+                queue->stats[OROBI_TXQUEUE_MOTOR].coalesced++;
+            }
+            break;
+        case OROBI_TXQUEUE_MOTOR:
+            if (queue->motor_pending) {
+                queue->stats[cls].coalesced++;
+            }
+            entry = &queue->motor;
+            queue->motor_pending = true;
+            break;
+        default: {
+            if (queue->bulk_count == OROBI_TXQUEUE_BULK_SLOTS) {
+                queue->stats[cls].rejected++;
+                return OROBI_ERROR_COMMAND_OVERFLOW;
+            }
+            orobi_txqueue_bulk_entry_t* bulk =
+                &queue->bulk[(queue->bulk_head + queue->bulk_count) & (OROBI_TXQUEUE_BULK_SLOTS - 1)];
+            queue->bulk_count++;
+            bulk->user_size = 0;
+            entry = &bulk->entry;
+            break;
+        }
+    }
+
+    entry->command = *command;
+    __orobi_txqueue_stamp(queue, entry, cls, ttl_ms, now_ms);
+    queue->stats[cls].queued++;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_txqueue_push_user(orobi_txqueue_t* queue, const void* data, uint8_t size,
+                                      uint32_t ttl_ms, uint32_t now_ms) {
+    if (!queue || (!data && size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (queue->bulk_count == OROBI_TXQUEUE_BULK_SLOTS) {
+        queue->stats[OROBI_TXQUEUE_BULK].rejected++;
+        return OROBI_ERROR_COMMAND_OVERFLOW;
+    }
+
+    orobi_txqueue_bulk_entry_t* bulk =
+        &queue->bulk[(queue->bulk_head + queue->bulk_count) & (OROBI_TXQUEUE_BULK_SLOTS - 1)];
+    queue->bulk_count++;
+    memset(&bulk->entry.command, 0, sizeof(bulk->entry.command));
+    bulk->entry.command.type = OROBI_COMMAND_USER;
+    bulk->user_size = size;
+    if (size > 0) {
+        memcpy(bulk->user, data, size);
+    }
+    __orobi_txqueue_stamp(queue, &bulk->entry, OROBI_TXQUEUE_BULK, ttl_ms, now_ms);
+    queue->stats[OROBI_TXQUEUE_BULK].queued++;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_txqueue_fill(orobi_txqueue_t* queue, orobi_batch_t* batch, uint32_t now_ms) {
+    if (!queue || !batch) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    // CONTROL vollständig vor allem anderen
+    while (queue->control_count > 0) {
+        const orobi_txqueue_entry_t* entry = &queue->control[queue->control_head];
+        if (__orobi_txqueue_expired(entry, now_ms)) {
+            queue->stats[OROBI_TXQUEUE_CONTROL].expired++;
+        } else if (orobi_batch_add(batch, &entry->command, now_ms) == OROBI_ERROR_COMMAND_OVERFLOW) {
+            return OROBI_ERROR_COMMAND_OVERFLOW;
+        } else {
+            queue->stats[OROBI_TXQUEUE_CONTROL].sent++;
+        }
+        __orobi_txqueue_pop_control(queue);
+    }
+
+    if (queue->motor_pending) {
+        if (__orobi_txqueue_expired(&queue->motor, now_ms)) {
+            queue->stats[OROBI_TXQUEUE_MOTOR].expired++;
+        } else if (orobi_batch_add(batch, &queue->motor.command, now_ms) == OROBI_ERROR_COMMAND_OVERFLOW) {
+            return OROBI_ERROR_COMMAND_OVERFLOW;
+        } else {
+            queue->stats[OROBI_TXQUEUE_MOTOR].sent++;
+        }
+        queue->motor_pending = false;
+    }
+
+    // BULK in Reihenfolge; ein Eintrag, der nicht mehr passt, wartet auf den nächsten Batch
+    while (queue->bulk_count > 0) {
+        const orobi_txqueue_bulk_entry_t* bulk = &queue->bulk[queue->bulk_head];
+        orobi_error_t status = OROBI_OK;
+        if (__orobi_txqueue_expired(&bulk->entry, now_ms)) {
+            queue->stats[OROBI_TXQUEUE_BULK].expired++;
+        } else {
+            status = bulk->entry.command.type == OROBI_COMMAND_USER
+                   ? orobi_batch_add_user(batch, bulk->user, bulk->user_size, now_ms)
+                   : orobi_batch_add(batch, &bulk->entry.command, now_ms);
+            if (status == OROBI_ERROR_COMMAND_OVERFLOW) {
+                return OROBI_ERROR_COMMAND_OVERFLOW;
+            }
+            queue->stats[OROBI_TXQUEUE_BULK].sent++;
+        }
+        __orobi_txqueue_pop_bulk(queue);
+    }
+    return OROBI_OK;
+}
+
+uint32_t orobi_txqueue_pending(const orobi_txqueue_t* queue) {
+    if (!queue) {
+        return 0;
+    }
+    return (uint32_t)queue->control_count + (queue->motor_pending ? 1u : 0u) + queue->bulk_count;
+}
+
+bool orobi_txqueue_urgent(const orobi_txqueue_t* queue) {
+    return queue && queue->control_count > 0;
+}
@@ -0,0 +1,92 @@
+// pipeline.h
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "orobi_command.h"
+#include "orobi_ring.h"
+#include "orobi_telemetry.h"
+#include "setup.h"
+
+// Laufzeit-Pipeline im Normalbetrieb:
+//   RX-Task (Core 0)     UDP-Datagramme -> rx_ring (rohe Netzwerkpakete)
+//   Crypto-Task (Core 0) rx_ring -> orobi_netpacket_open + orobi_batch_next -> cmd_ring (orobi_command_t)
+//   Motor-Task (Core 1)  cmd_ring -> Handler, fester Takt
+//   Session-Task (Core 0, niedrige Priorität) schreibt erneuerte Sitzungstickets ins NVS, wenn die Motoren ruhen
+// Rückweg: der Crypto-Task sammelt einen Status-Frame pro empfangenem Paket und die Frames aus
+// pipeline_post_telemetry (tlm_ring) und sendet sie gebündelt an die Bodenstation (orobi_telemetry.h).
+// Status-Frames (Bestätigungen, status != OK, keine Felder) haben Vorrang und werden sofort eingereiht;
+// Sensor-Frames mit denselben Feldern ersetzen sich bis zum Senden (nur der neueste Wert zählt) und werden
+// verworfen statt verspätet gesendet, wenn sie älter als PIPELINE_TELEMETRY_MAX_AGE_MS sind.
+// DATA-Pakete des zuverlässigen Kanals (orobi_reliable.h) werden dedupliziert; bestätigt wird einmal
+// pro Durchlauf des Crypto-Tasks mit einem ACK über alle empfangenen seq.
+// Der Crypto-Task gleicht die Sitzungsuhr mit der Bodenstation ab (orobi_clock.h, Client). Danach tragen
+// Pakete und Telemetrie Sitzungszeit, zu alte Pakete werden abgewiesen, und MOTORDATA ohne Bremse wird
+// verworfen statt ausgeführt, wenn es seit dem Absenden älter als PIPELINE_MOTOR_MAX_AGE_MS ist
+// (ohne Synchronisation: seit dem Empfang).
+// Die Ringe sind lock-freie SPSC-Ringe mit vorallokierten Slots; ein 4 KB Paket blockiert den Regelkreis nicht.
+#define PIPELINE_UDP_PORT               4210
+#define PIPELINE_RX_SLOTS               4       // Zweierpotenz, je OROBI_NETPACKET_MAXSIZE Bytes
+#define PIPELINE_CMD_SLOTS              32      // Zweierpotenz, je ca. 320 Bytes
+#define PIPELINE_TELEMETRY_SLOTS        64      // Zweierpotenz, je sizeof(orobi_telemetry_t)
+#define PIPELINE_TELEMETRY_SIZE         512     // Bytes pro Telemetrie-Nachricht
+#define PIPELINE_TELEMETRY_PERIOD_MS    20      // spätestens so lange werden Frames gesammelt
+#define PIPELINE_TELEMETRY_LATEST       8       // verschiedene Feld-Kombinationen, die zusammengefasst werden
+#define PIPELINE_TELEMETRY_MAX_AGE_MS   100     // ältere Sensor-Frames werden nicht mehr gesendet
+#define PIPELINE_MOTOR_PERIOD_MS        10
+#define PIPELINE_MOTOR_MAX_AGE_MS       100     // ältere Fahrbefehle werden nicht mehr ausgeführt
+#define PIPELINE_NET_CORE               0
+#define PIPELINE_MOTOR_CORE             1
+#define PIPELINE_RX_PRIORITY            5
+#define PIPELINE_CRYPTO_PRIORITY        4
+#define PIPELINE_MOTOR_PRIORITY         10
+#define PIPELINE_SESSION_PRIORITY       1
+#define PIPELINE_SESSION_IDLE_MS        500     // so lange ohne Kommando, bevor ein Ticket in den Flash geht
+#define PIPELINE_SESSION_MAX_DEFER_MS   10000   // danach wird auch während der Fahrt geschrieben
+#define PIPELINE_STACK_SIZE             4096
+
+// Wird im Motor-Task für jedes gültige Kommando aufgerufen (Reihenfolge wie empfangen)
+typedef void (*pipeline_command_handler_t)(const orobi_command_t* command, void* user);
+
+typedef struct {
+    uint32_t    depth;          // aktuelle Füllung
+    uint32_t    high_water;     // maximale Füllung
+    uint32_t    dropped;        // verworfen, weil voll
+} pipeline_queue_stats_t;
+
+typedef struct {
+    uint32_t    count;
+    uint32_t    last_us;
+    uint32_t    max_us;
+    uint64_t    total_us;       // Mittelwert = total_us / count
+} pipeline_latency_stats_t;
+
+typedef struct {
+    pipeline_queue_stats_t      rx;
+    pipeline_queue_stats_t      cmd;
+    pipeline_queue_stats_t      telemetry;
+    pipeline_latency_stats_t    crypto;     // Empfang -> Kommando im cmd_ring
+    pipeline_latency_stats_t    motor;      // Empfang -> Handler aufgerufen
+    uint32_t                    rx_packets;
+    uint32_t                    rejected_packets;   // Netzwerkpaket/Krypto ungültig
+    uint32_t                    rejected_commands;  // Einzelkommando ungültig
+    uint32_t                    expired_commands;   // MOTORDATA älter als PIPELINE_MOTOR_MAX_AGE_MS
+    uint32_t                    tx_packets;         // gesendete Telemetrie-Nachrichten
+    uint32_t                    tx_dropped_frames;  // Frames ohne bekannte Bodenstation bzw. Sendefehler
+    uint32_t                    tx_coalesced_frames;    // durch einen neueren Frame mit denselben Feldern ersetzt
+    uint32_t                    tx_expired_frames;      // älter als PIPELINE_TELEMETRY_MAX_AGE_MS, nicht gesendet
+    orobi_secure_metrics_t      secure;             // Zähler und Krypto-/Hashzeit des Crypto-Tasks
+    orobi_clock_quality_t       clock;              // Synchronisation der Sitzungsuhr
+} pipeline_stats_t;
+
+// Startet die Tasks; setup muss gültig sein (setup_check)
+bool pipeline_start(const setup_data_t* setup, pipeline_command_handler_t handler, void* user);
+// Reiht einen Telemetrie-Frame ein (status/seq_nr nach Bedarf). timestamp_ms ist lokale Zeit
+// (esp_timer in ms, 0: Zeit beim Einreihen) und wird beim Senden in Sitzungszeit umgerechnet.
+// Nur aus dem Motor-Task, also aus dem Kommando-Handler, aufrufen. false: Warteschlange voll.
+bool pipeline_post_telemetry(const orobi_telemetry_t* frame);
+// Momentaufnahme der Zähler, aus beliebigem Task aufrufbar
+void pipeline_get_stats(pipeline_stats_t* stats);
+
+#endif // PIPELINE_H
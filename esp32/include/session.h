@@ -0,0 +1,20 @@
+// session.h
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdbool.h>
+#include "orobi_packet.h"
+
+// Sitzungsticket im NVS (Namespace wie setup.c, eigener Schlüssel). Damit setzt der Roboter nach einem
+// Neustart die Sitzung mit der Bodenstation in einem Round-Trip fort (orobi_secure_session_resume).
+// Geschrieben wird nur, wenn sich das Ticket geändert hat; der Counter-Vorrat (OROBI_SESSION_*_LEASE)
+// bestimmt, wie oft das im Betrieb passiert.
+
+// Lädt das zuletzt gespeicherte Ticket; false, wenn keins vorhanden ist
+bool session_load(orobi_session_ticket_t* ticket);
+// Speichert das Ticket, sofern es vom zuletzt geschriebenen abweicht
+bool session_store(const orobi_session_ticket_t* ticket);
+// Löscht das Ticket (z.B. nach neuem Setup)
+void session_erase(void);
+
+#endif // SESSION_H
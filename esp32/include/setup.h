@@ -22,5 +22,7 @@ typedef struct {
 // Funktionsprototypen
 bool setup_check(void);
 void setup_run(void);
+// Gültig nach erfolgreichem setup_check
+const setup_data_t* setup_get_data(void);
 
 #endif // SETUP_H
@@ -1,10 +1,36 @@
 #include "setup.h"
+#include "pipeline.h"
+#include "esp_log.h"
+
+static const char *TAG = "MAIN";
+
+// Läuft im Motor-Task (Core 1) mit festem Takt
+static void motor_command_handler(const orobi_command_t* command, void* user) {
+    (void)user;
+    switch (command->type) {
+        case OROBI_COMMAND_MOTORDATA:
+            // ... Motoren ansteuern ...
+            ESP_LOGD(TAG, "motor speed=%u rotation=%u", command->motor.speed, command->motor.rotation);
+            // Übernommene Sollwerte zurückmelden; weitere Sensorwerte über zusätzliche Flags
+            pipeline_post_telemetry(&(orobi_telemetry_t){
+                .flags = OROBI_TELEMETRY_HAS_MOTOR,
+                .speed = command->motor.speed,
+                .rotation = command->motor.rotation
+            });
+            break;
+        default:
+            ESP_LOGD(TAG, "command type %d", command->type);
+            break;
+    }
+}
 
 void app_main(void) {
     if (!setup_check()) {
         setup_run();  // Startet Setup-Modus mit Loop
     } else {
         // Normaler Betriebsmodus
-        // ... dein Code ...
+        if (!pipeline_start(setup_get_data(), motor_command_handler, NULL)) {
+            ESP_LOGE(TAG, "Pipeline start failed");
+        }
     }
 }
@@ -0,0 +1,635 @@
+// pipeline.c
+#include "pipeline.h"
+#include "orobi_batch.h"
+#include "orobi_crypto.h"
+#include "orobi_reliable.h"
+#include "orobi_txqueue.h"
+#include "session.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include <string.h>
+
+static const char *TAG = "PIPELINE";
+
+// Nach orobi_secure_session_resume: so viele als Replay abgewiesene Pakete der Bodenstation werden
+// mit einem erneuten Hello beantwortet
+#define PIPELINE_RESUME_ATTEMPTS        8
+#define PIPELINE_REPLAY_RECOVER_REJECTS 8       // aufeinanderfolgende NONCE_REPLAY bis zum erneuten Handshake
+#define PIPELINE_REPLAY_RECOVER_MS      30000   // höchstens so oft, auch mitgeschnittene Pakete lösen ihn aus
+
+typedef struct {
+    int64_t             rx_time_us;
+    struct sockaddr_in  from;
+    uint16_t            size;
+    uint8_t             data[OROBI_NETPACKET_MAXSIZE];
+} pipeline_rx_slot_t;
+
+typedef struct {
+    int64_t         rx_time_us;
+    int64_t         deadline_us;    // esp_timer; danach wird MOTORDATA ohne Bremse verworfen
+    orobi_command_t command;
+    uint8_t         user_size;
+    uint8_t         user[OROBI_BATCH_MAX_ENTRY];    // Kopie der USER-Daten, command.packet zeigt hierher
+} pipeline_cmd_slot_t;
+
+typedef struct {
+    const setup_data_t*         setup;
+    pipeline_command_handler_t  handler;
+    void*                       user;
+    int                         sock;
+    TaskHandle_t                crypto_task;
+    QueueHandle_t               session_queue;      // neuestes zu schreibendes Ticket (Länge 1, überschrieben)
+    atomic_uint                 motor_active_ms;    // lokale Zeit des zuletzt ausgeführten Kommandos
+
+    orobi_ring_t                rx_ring;
+    orobi_ring_t                cmd_ring;
+    orobi_ring_t                tlm_ring;
+
+    // Nur vom Crypto-Task benutzt
+    orobi_secure_t              secure;
+    orobi_packet_t              packet;
+    orobi_session_ticket_t      session;
+    uint8_t                     resume_attempts;    // > 0: Sitzung fortgesetzt, Bodenstation noch nicht bestätigt
+    uint8_t                     replay_rejects;     // aufeinanderfolgende NONCE_REPLAY der Bodenstation
+    int64_t                     replay_recover_us;  // letzter Handshake wegen anhaltender NONCE_REPLAY
+    orobi_telemetry_writer_t    telemetry;
+    int64_t                     telemetry_opened_us;    // erster Frame der Nachricht oder in latest
+    orobi_telemetry_t           latest[PIPELINE_TELEMETRY_LATEST];  // neuester Sensor-Frame je Feld-Kombination
+    uint8_t                     latest_count;
+    orobi_reliable_rx_t         reliable;           // zuverlässiger Kanal der Bodenstation (DATA -> ACK)
+    orobi_clock_t               clock;              // Sitzungsuhr, Client der Bodenstation
+    uint8_t                     tx_seq;
+
+    // Zähler: je Feld genau ein schreibender Task, gelesen wird nur als Momentaufnahme
+    pipeline_latency_stats_t    crypto_latency;
+    pipeline_latency_stats_t    motor_latency;
+    atomic_uint                 rx_packets;
+    atomic_uint                 rejected_packets;
+    atomic_uint                 rejected_commands;
+    atomic_uint                 expired_commands;
+    atomic_uint                 tx_packets;
+    atomic_uint                 tx_dropped_frames;
+    atomic_uint                 tx_coalesced_frames;
+    atomic_uint                 tx_expired_frames;
+} pipeline_t;
+
+// Statisch vorallokiert: im Betrieb keine Heap-Allokation
+static pipeline_t pipeline;
+static pipeline_rx_slot_t rx_slots[PIPELINE_RX_SLOTS];
+static pipeline_cmd_slot_t cmd_slots[PIPELINE_CMD_SLOTS];
+static orobi_telemetry_t tlm_slots[PIPELINE_TELEMETRY_SLOTS];
+static uint8_t telemetry_buffer[PIPELINE_TELEMETRY_SIZE];
+static uint8_t secure_scratch[OROBI_SECURE_SCRATCH_SIZE];
+static uint8_t inflate_buffer[OROBI_MAXMESSAGESIZE];
+static StaticQueue_t session_queue_state;
+static uint8_t session_queue_storage[sizeof(orobi_session_ticket_t)];
+
+static void pipeline_record_latency(pipeline_latency_stats_t* stats, int64_t since_us) {
+    const int64_t elapsed = esp_timer_get_time() - since_us;
+    const uint32_t us = elapsed < 0 ? 0 : (elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed);
+
+    stats->last_us = us;
+    if (us > stats->max_us) {
+        stats->max_us = us;
+    }
+    stats->total_us += us;
+    stats->count++;
+}
+
+static void pipeline_queue_stats(const orobi_ring_t* ring, pipeline_queue_stats_t* stats) {
+    stats->depth = orobi_ring_depth(ring);
+    stats->high_water = ring->high_water;
+    stats->dropped = (uint32_t)atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
+
+// Empfängt Datagramme direkt in die Slots des rx_ring
+static void pipeline_rx_task(void* arg) {
+    (void)arg;
+    static uint8_t discard[OROBI_NETPACKET_MAXSIZE];
+
+    while (1) {
+        pipeline_rx_slot_t* slot = orobi_ring_acquire_write(&pipeline.rx_ring);
+        if (!slot) {
+            // Ring voll (im dropped-Zähler erfasst): Datagramm verwerfen, damit der Socket-Puffer nicht überläuft
+            recv(pipeline.sock, discard, sizeof(discard), 0);
+            continue;
+        }
+
+        socklen_t from_len = sizeof(slot->from);
+        const int len = recvfrom(pipeline.sock, slot->data, sizeof(slot->data), 0,
+                                 (struct sockaddr*)&slot->from, &from_len);
+        if (len <= 0) {
+            ESP_LOGW(TAG, "recv failed: %d", errno);
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+
+        slot->rx_time_us = esp_timer_get_time();
+        slot->size = (uint16_t)len;
+        orobi_ring_commit_write(&pipeline.rx_ring);
+        atomic_fetch_add_explicit(&pipeline.rx_packets, 1, memory_order_relaxed);
+        xTaskNotifyGive(pipeline.crypto_task);
+    }
+}
+
+// Frist der Kommandos eines Pakets: PIPELINE_MOTOR_MAX_AGE_MS ab dem Absenden laut Sitzungsuhr,
+// ohne Zeitstempel bzw. Synchronisation ab dem Empfang
+static int64_t pipeline_command_deadline(const orobi_netpacket_view_t* view, int64_t rx_time_us) {
+    int64_t deadline_us = rx_time_us + PIPELINE_MOTOR_MAX_AGE_MS * 1000LL;
+    const uint32_t rx_ms = (uint32_t)(rx_time_us / 1000);
+    if (view->timestamp_ms != 0 && orobi_clock_synced(&pipeline.clock, rx_ms)) {
+        const int32_t transit_ms = (int32_t)(orobi_clock_session_ms(&pipeline.clock, rx_ms) - view->timestamp_ms);
+        if (transit_ms > 0) {
+            deadline_us -= transit_ms * 1000LL;
+        }
+    }
+    return deadline_us;
+}
+
+// true, wenn alle gültigen Kommandos des Batches einen freien Slot im cmd_ring haben. Der Motor-Task gibt
+// nebenläufig nur Slots frei, die Prüfung bleibt bis zum Schreiben gültig. Sonst im dropped-Zähler erfasst.
+static bool pipeline_cmd_ring_fits(const uint8_t* message, size_t message_size) {
+    orobi_batch_reader_t reader;
+    if (orobi_batch_reader_init(&reader, message, message_size) != OROBI_OK) {
+        return true;    // Fehler meldet pipeline_forward_batch
+    }
+
+    orobi_command_t command;
+    const uint8_t* user_data;
+    uint8_t user_size;
+    orobi_command_status_t status;
+    uint32_t commands = 0;
+    while ((status = orobi_batch_next(&reader, &command, &user_data, &user_size)) != OROBI_COMMAND_STATUS_NODATA &&
+           status != OROBI_COMMAND_STATUS_ERROR) {
+        commands += status == OROBI_COMMAND_STATUS_OK;
+    }
+
+    if (orobi_ring_capacity(&pipeline.cmd_ring) - orobi_ring_depth(&pipeline.cmd_ring) >= commands) {
+        return true;
+    }
+    atomic_fetch_add_explicit(&pipeline.cmd_ring.dropped, commands, memory_order_relaxed);
+    return false;
+}
+
+// Status des Pakets für die Telemetrie: OK, INVALID_COMMAND (einzelne Kommandos verworfen) oder ERROR.
+// Ein Batch wird ganz oder gar nicht übergeben: ERROR, wenn der Regelkreis nicht hinterherkommt.
+static orobi_command_status_t pipeline_forward_batch(const uint8_t* message, size_t message_size, int64_t rx_time_us,
+                                                     int64_t deadline_us) {
+    orobi_batch_reader_t reader;
+    if (orobi_batch_reader_init(&reader, message, message_size) != OROBI_OK) {
+        atomic_fetch_add_explicit(&pipeline.rejected_packets, 1, memory_order_relaxed);
+        return OROBI_COMMAND_STATUS_ERROR;
+    }
+    if (!pipeline_cmd_ring_fits(message, message_size)) {
+        return OROBI_COMMAND_STATUS_ERROR;
+    }
+
+    orobi_command_t command;
+    const uint8_t* user_data = NULL;
+    uint8_t user_size = 0;
+    orobi_command_status_t status;
+    orobi_command_status_t result = OROBI_COMMAND_STATUS_OK;
+    while ((status = orobi_batch_next(&reader, &command, &user_data, &user_size)) != OROBI_COMMAND_STATUS_NODATA) {
+        if (status != OROBI_COMMAND_STATUS_OK) {
+            atomic_fetch_add_explicit(&pipeline.rejected_commands, 1, memory_order_relaxed);
+            if (status == OROBI_COMMAND_STATUS_ERROR) {
+                return OROBI_COMMAND_STATUS_ERROR;
+            }
+            result = OROBI_COMMAND_STATUS_INVALID_COMMAND;
+            continue;
+        }
+
+        pipeline_cmd_slot_t* slot = orobi_ring_acquire_write(&pipeline.cmd_ring);
+        if (!slot) {
+            return OROBI_COMMAND_STATUS_ERROR;  // nach pipeline_cmd_ring_fits nicht erwartet
+        }
+        slot->rx_time_us = rx_time_us;
+        slot->deadline_us = deadline_us;
+        slot->command = command;
+        if (command.type == OROBI_COMMAND_USER) {
+            memcpy(slot->user, user_data, user_size);
+            slot->user_size = user_size;
+            slot->command.packet = slot->user;
+        }
+        orobi_ring_commit_write(&pipeline.cmd_ring);
+        pipeline_record_latency(&pipeline.crypto_latency, rx_time_us);
+    }
+    return result;
+}
+
+// Versiegelt message an die zuletzt bekannte Adresse der Bodenstation
+static bool pipeline_send_message(const void* message, size_t size) {
+    static uint8_t buffer[OROBI_NETPACKET_MAXSIZE];
+    size_t written;
+    if (orobi_netpacket_seal(&pipeline.secure, NULL, &pipeline.packet, pipeline.tx_seq++, pipeline.session.api_key,
+                             message, size, pipeline.setup->pc_public_key, buffer, sizeof(buffer),
+                             &written) != OROBI_OK) {
+        ESP_LOGD(TAG, "seal: %s", orobi_secure_last_error(&pipeline.secure));
+        return false;
+    }
+
+    const struct sockaddr_in to = {
+        .sin_family = AF_INET,
+        .sin_port = pipeline.session.peer_port,
+        .sin_addr.s_addr = pipeline.session.peer_ip
+    };
+    return sendto(pipeline.sock, buffer, written, 0, (const struct sockaddr*)&to, sizeof(to)) == (ssize_t)written;
+}
+
+// Leeres Paket an die Bodenstation aus dem Ticket: mit dem neuen Nonce-Präfix überspringt sie ihre
+// Counter um OROBI_SESSION_RX_LEASE, ihre nächste Antwort liegt damit oberhalb von rx_limit
+static void pipeline_send_hello(void) {
+    if (!pipeline_send_message("", 0)) {
+        ESP_LOGW(TAG, "hello failed");
+    }
+}
+
+// Anhaltende NONCE_REPLAY: die Bodenstation sendet unterhalb unseres Fensters und kennt unseren Präfix schon
+// (z.B. ihr Peer-Eintrag wurde zurückgesetzt), ein Hello allein hilft dann nicht. Handshake wie nach einem
+// Neustart: Ticket mit dem aktuellen Stand exportieren und daraus fortsetzen (neuer Präfix, alles bis rx_limit
+// gilt als gesehen), dann Hello; die Bodenstation überspringt daraufhin OROBI_SESSION_RX_LEASE Counter.
+// Der Replay-Zustand wird dabei nicht verworfen, mitgeschnittene Pakete erzwingen nur einen weiteren Handshake.
+static void pipeline_recover_session(void) {
+    const int64_t now_us = esp_timer_get_time();
+    if (pipeline.session.peer_ip == 0 ||
+        (pipeline.replay_recover_us != 0 && now_us - pipeline.replay_recover_us < PIPELINE_REPLAY_RECOVER_MS * 1000LL)) {
+        return;
+    }
+    pipeline.replay_recover_us = now_us;
+
+    if (orobi_secure_session_export(&pipeline.secure, pipeline.setup->pc_public_key, &pipeline.session) != OROBI_OK ||
+        orobi_secure_session_resume(&pipeline.secure, &pipeline.session) != OROBI_OK) {
+        ESP_LOGW(TAG, "session recovery failed: %s", orobi_secure_last_error(&pipeline.secure));
+        return;
+    }
+    ESP_LOGW(TAG, "Persistent nonce replay, new session handshake");
+    xQueueOverwrite(pipeline.session_queue, &pipeline.session);
+    pipeline.resume_attempts = PIPELINE_RESUME_ATTEMPTS;
+    pipeline_send_hello();
+}
+
+// Nach jedem gültigen Paket: Transport der Bodenstation merken und das Ticket erneuern, wenn sich dieser
+// geändert hat oder der Counter-Vorrat zur Hälfte verbraucht ist. Geschrieben wird im Session-Task.
+static void pipeline_update_session(const orobi_netpacket_view_t* view, const struct sockaddr_in* from) {
+    const bool moved = pipeline.session.peer_ip != from->sin_addr.s_addr ||
+                       pipeline.session.peer_port != from->sin_port ||
+                       pipeline.session.api_key != view->api_key;
+    if (!moved && !orobi_secure_session_due(&pipeline.secure, pipeline.setup->pc_public_key)) {
+        return;
+    }
+
+    pipeline.session.peer_ip = from->sin_addr.s_addr;
+    pipeline.session.peer_port = from->sin_port;
+    pipeline.session.api_key = view->api_key;
+    if (orobi_secure_session_export(&pipeline.secure, pipeline.setup->pc_public_key, &pipeline.session) == OROBI_OK) {
+        xQueueOverwrite(pipeline.session_queue, &pipeline.session);
+    }
+}
+
+// Sendet die Telemetrie-Nachricht und beginnt eine neue
+static void pipeline_send_telemetry(void) {
+    if (pipeline.telemetry.count == 0) {
+        return;
+    }
+    // Ohne bekannte Bodenstation verwerfen
+    if (pipeline.session.peer_ip != 0 && pipeline_send_message(pipeline.telemetry.buffer, pipeline.telemetry.size)) {
+        atomic_fetch_add_explicit(&pipeline.tx_packets, 1, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(&pipeline.tx_dropped_frames, pipeline.telemetry.count, memory_order_relaxed);
+    }
+    orobi_telemetry_writer_init(&pipeline.telemetry, telemetry_buffer, sizeof(telemetry_buffer));
+}
+
+static void pipeline_open_telemetry(void) {
+    if (pipeline.telemetry.count == 0 && pipeline.latest_count == 0) {
+        pipeline.telemetry_opened_us = esp_timer_get_time();
+    }
+}
+
+// frame->timestamp_ms ist lokale Zeit, gesendet wird Sitzungszeit
+static void pipeline_append_telemetry(const orobi_telemetry_t* frame) {
+    orobi_telemetry_t out = *frame;
+    out.timestamp_ms = orobi_clock_session_ms(&pipeline.clock, frame->timestamp_ms);
+    pipeline_open_telemetry();
+    if (orobi_telemetry_append(&pipeline.telemetry, &out) == OROBI_ERROR_COMMAND_OVERFLOW) {
+        pipeline_send_telemetry();
+        orobi_telemetry_append(&pipeline.telemetry, &out);
+    }
+}
+
+// Sensor-Frame aus dem Motor-Task: ersetzt einen wartenden Frame mit denselben Feldern.
+// Status-Frames und Frames ohne freien Platz in latest werden direkt angehängt.
+static void pipeline_stage_telemetry(const orobi_telemetry_t* frame) {
+    if (frame->flags == 0 || frame->status != OROBI_COMMAND_STATUS_OK) {
+        pipeline_append_telemetry(frame);
+        return;
+    }
+
+    for (uint8_t i = 0; i < pipeline.latest_count; i++) {
+        if (pipeline.latest[i].flags == frame->flags) {
+            pipeline.latest[i] = *frame;
+            atomic_fetch_add_explicit(&pipeline.tx_coalesced_frames, 1, memory_order_relaxed);
+            return;
+        }
+    }
+    if (pipeline.latest_count == PIPELINE_TELEMETRY_LATEST) {
+        pipeline_append_telemetry(frame);
+        return;
+    }
+    pipeline_open_telemetry();
+    pipeline.latest[pipeline.latest_count++] = *frame;
+}
+
+// Hängt die noch frischen Sensor-Frames an und sendet
+static void pipeline_flush_telemetry(void) {
+    const uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    const uint8_t count = pipeline.latest_count;
+    pipeline.latest_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (now_ms - pipeline.latest[i].timestamp_ms > PIPELINE_TELEMETRY_MAX_AGE_MS) {
+            atomic_fetch_add_explicit(&pipeline.tx_expired_frames, 1, memory_order_relaxed);
+            continue;
+        }
+        pipeline_append_telemetry(&pipeline.latest[i]);
+    }
+    pipeline_send_telemetry();
+}
+
+// Entschlüsselt und validiert; der einzige Task, der den orobi_secure_t-Kontext benutzt.
+// Sammelt außerdem die Telemetrie und sendet sie spätestens nach PIPELINE_TELEMETRY_PERIOD_MS.
+static void pipeline_crypto_task(void* arg) {
+    (void)arg;
+
+    orobi_telemetry_writer_init(&pipeline.telemetry, telemetry_buffer, sizeof(telemetry_buffer));
+    if (pipeline.resume_attempts > 0) {
+        pipeline_send_hello();
+    }
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PIPELINE_TELEMETRY_PERIOD_MS));
+
+        pipeline_rx_slot_t* slot;
+        while ((slot = orobi_ring_acquire_read(&pipeline.rx_ring)) != NULL) {
+            orobi_netpacket_view_t view;
+            const uint8_t* message = NULL;
+            size_t message_size = 0;
+
+            orobi_error_t status = orobi_netpacket_open(&pipeline.secure, slot->data, slot->size,
+                                                        pipeline.setup->pc_public_key, &pipeline.packet,
+                                                        inflate_buffer, sizeof(inflate_buffer), &view,
+                                                        &message, &message_size);
+            if (status == OROBI_OK && message_size > 0 && message[0] == OROBI_CLOCK_RESPONSE_MARKER) {
+                // Antwort auf den Uhrabgleich, t4 ist die Empfangszeit im RX-Task
+                pipeline.resume_attempts = 0;
+                pipeline.replay_rejects = 0;
+                orobi_clock_response(&pipeline.clock, message, message_size, (uint32_t)(slot->rx_time_us / 1000));
+                pipeline_update_session(&view, &slot->from);
+            } else if (status == OROBI_OK) {
+                pipeline.resume_attempts = 0;
+                pipeline.replay_rejects = 0;
+                const int64_t deadline_us = pipeline_command_deadline(&view, slot->rx_time_us);
+                orobi_command_status_t result = OROBI_COMMAND_STATUS_OK;
+                if (message_size > 0 && message[0] == OROBI_RELIABLE_DATA_MARKER) {
+                    // Duplikate nur erneut bestätigen, nicht noch einmal ausführen. Passt der Batch nicht mehr
+                    // in den cmd_ring, gilt er als nicht empfangen: kein ACK, die Bodenstation wiederholt ihn.
+                    const uint8_t* batch;
+                    size_t batch_size;
+                    orobi_error_t reliable = OROBI_ERROR_BUFFER_OVERFLOW;
+                    if (message_size < OROBI_RELIABLE_HEADER_SIZE ||
+                        pipeline_cmd_ring_fits(message + OROBI_RELIABLE_HEADER_SIZE,
+                                               message_size - OROBI_RELIABLE_HEADER_SIZE)) {
+                        reliable = orobi_reliable_receive(&pipeline.reliable, message, message_size,
+                                                          &batch, &batch_size);
+                    }
+                    if (reliable == OROBI_OK) {
+                        result = pipeline_forward_batch(batch, batch_size, slot->rx_time_us, deadline_us);
+                    } else if (reliable != OROBI_ERROR_NONCE_REPLAY) {
+                        result = OROBI_COMMAND_STATUS_ERROR;
+                    }
+                } else {
+                    result = pipeline_forward_batch(message, message_size, slot->rx_time_us, deadline_us);
+                }
+                const orobi_telemetry_t ack = {
+                    .seq_nr = view.seq_nr,
+                    .status = result,
+                    .timestamp_ms = (uint32_t)(slot->rx_time_us / 1000)
+                };
+                pipeline_update_session(&view, &slot->from);
+                pipeline_append_telemetry(&ack);
+            } else {
+                atomic_fetch_add_explicit(&pipeline.rejected_packets, 1, memory_order_relaxed);
+                ESP_LOGD(TAG, "packet rejected: %d", status);
+
+                // Bodenstation sendet noch unterhalb von rx_limit: Hello verloren. Hält das an, neuer Handshake.
+                if (status == OROBI_ERROR_NONCE_REPLAY) {
+                    if (pipeline.resume_attempts > 0 && --pipeline.resume_attempts > 0) {
+                        pipeline_send_hello();
+                    }
+                    if (++pipeline.replay_rejects >= PIPELINE_REPLAY_RECOVER_REJECTS) {
+                        pipeline.replay_rejects = 0;
+                        pipeline_recover_session();
+                    }
+                }
+            }
+            orobi_ring_release_read(&pipeline.rx_ring);
+        }
+
+        // Ein ACK für alle DATA-Pakete dieses Durchlaufs
+        if (pipeline.reliable.ack_due) {
+            uint8_t ack[OROBI_RELIABLE_ACK_SIZE];
+            size_t ack_size;
+            orobi_reliable_ack_write(&pipeline.reliable, ack, sizeof(ack), &ack_size);
+            pipeline_send_message(ack, ack_size);
+        }
+
+        // Uhrabgleich, sobald die Bodenstation bekannt ist
+        const uint32_t local_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        if (pipeline.session.peer_ip != 0 && orobi_clock_request_due(&pipeline.clock, local_ms)) {
+            uint8_t request[OROBI_CLOCK_REQUEST_SIZE];
+            size_t request_size;
+            orobi_clock_request_write(&pipeline.clock, local_ms, request, sizeof(request), &request_size);
+            pipeline_send_message(request, request_size);
+        }
+
+        orobi_telemetry_t* frame;
+        while ((frame = orobi_ring_acquire_read(&pipeline.tlm_ring)) != NULL) {
+            pipeline_stage_telemetry(frame);
+            orobi_ring_release_read(&pipeline.tlm_ring);
+        }
+        if ((pipeline.telemetry.count > 0 || pipeline.latest_count > 0) &&
+            esp_timer_get_time() - pipeline.telemetry_opened_us >= PIPELINE_TELEMETRY_PERIOD_MS * 1000LL) {
+            pipeline_flush_telemetry();
+        }
+    }
+}
+
+// Fester Takt; arbeitet alle anstehenden Kommandos ab, blockiert nie auf Netzwerk oder Krypto
+static void pipeline_motor_task(void* arg) {
+    (void)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        pipeline_cmd_slot_t* slot;
+        while ((slot = orobi_ring_acquire_read(&pipeline.cmd_ring)) != NULL) {
+            // Veraltete Fahrbefehle verwerfen, eine Bremse wird immer ausgeführt
+            if (orobi_txqueue_classify(&slot->command) == OROBI_TXQUEUE_MOTOR &&
+                esp_timer_get_time() > slot->deadline_us) {
+                atomic_fetch_add_explicit(&pipeline.expired_commands, 1, memory_order_relaxed);
+            } else if (pipeline.handler) {
+                pipeline.handler(&slot->command, pipeline.user);
+                atomic_store_explicit(&pipeline.motor_active_ms, (uint32_t)(esp_timer_get_time() / 1000),
+                                      memory_order_relaxed);
+            }
+            pipeline_record_latency(&pipeline.motor_latency, slot->rx_time_us);
+            orobi_ring_release_read(&pipeline.cmd_ring);
+        }
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(PIPELINE_MOTOR_PERIOD_MS));
+    }
+}
+
+// Schreibt Sitzungstickets ins NVS. Während des Flash-Schreibvorgangs ist der Cache beider Kerne gesperrt,
+// auch der Motor-Task auf Core 1 steht: geschrieben wird erst, wenn seit PIPELINE_SESSION_IDLE_MS kein
+// Kommando mehr ausgeführt wurde, spätestens nach PIPELINE_SESSION_MAX_DEFER_MS. Bis dahin deckt das
+// alte Ticket noch die Hälfte seines Counter-Vorrats ab.
+static void pipeline_session_task(void* arg) {
+    (void)arg;
+    static orobi_session_ticket_t ticket;
+
+    while (1) {
+        xQueueReceive(pipeline.session_queue, &ticket, portMAX_DELAY);
+        const int64_t deadline_us = esp_timer_get_time() + PIPELINE_SESSION_MAX_DEFER_MS * 1000LL;
+        while (esp_timer_get_time() < deadline_us &&
+               (uint32_t)(esp_timer_get_time() / 1000) -
+                   atomic_load_explicit(&pipeline.motor_active_ms, memory_order_relaxed) < PIPELINE_SESSION_IDLE_MS) {
+            vTaskDelay(pdMS_TO_TICKS(PIPELINE_SESSION_IDLE_MS / 4));
+        }
+        // Inzwischen erneuertes Ticket übernehmen
+        xQueueReceive(pipeline.session_queue, &ticket, 0);
+        if (!session_store(&ticket)) {
+            ESP_LOGW(TAG, "session ticket not stored");
+        }
+    }
+}
+
+static bool pipeline_open_socket(void) {
+    pipeline.sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (pipeline.sock < 0) {
+        ESP_LOGE(TAG, "Error creating socket: %d", errno);
+        return false;
+    }
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(PIPELINE_UDP_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY)
+    };
+    if (bind(pipeline.sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        ESP_LOGE(TAG, "Error binding socket: %d", errno);
+        close(pipeline.sock);
+        return false;
+    }
+    return true;
+}
+
+bool pipeline_start(const setup_data_t* setup, pipeline_command_handler_t handler, void* user) {
+    if (!setup) {
+        return false;
+    }
+
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.setup = setup;
+    pipeline.handler = handler;
+    pipeline.user = user;
+
+    if (orobi_ring_init(&pipeline.rx_ring, rx_slots, sizeof(pipeline_rx_slot_t), PIPELINE_RX_SLOTS) != OROBI_OK ||
+        orobi_ring_init(&pipeline.cmd_ring, cmd_slots, sizeof(pipeline_cmd_slot_t), PIPELINE_CMD_SLOTS) != OROBI_OK ||
+        orobi_ring_init(&pipeline.tlm_ring, tlm_slots, sizeof(orobi_telemetry_t), PIPELINE_TELEMETRY_SLOTS) != OROBI_OK) {
+        ESP_LOGE(TAG, "Error initializing rings");
+        return false;
+    }
+    pipeline.session_queue = xQueueCreateStatic(1, sizeof(orobi_session_ticket_t), session_queue_storage,
+                                                &session_queue_state);
+
+    uint128_t id = { .high = setup->random_id_high, .low = setup->random_id_low };
+    orobi_secure_init(&pipeline.secure, id, setup->public_key, setup->private_key);
+    orobi_secure_set_scratch(&pipeline.secure, secure_scratch, sizeof(secure_scratch));
+    orobi_reliable_rx_init(&pipeline.reliable);
+    orobi_clock_init(&pipeline.clock, false);
+    orobi_secure_set_clock(&pipeline.secure, &pipeline.clock, 0);
+
+    // Sitzung aus dem Flash fortsetzen; nur gültig für den aktuellen Schlüssel der Bodenstation
+    if (session_load(&pipeline.session) &&
+        memcmp(pipeline.session.peer_public_key, setup->pc_public_key, crypto_box_PUBLICKEYBYTES) == 0 &&
+        orobi_secure_session_resume(&pipeline.secure, &pipeline.session) == OROBI_OK) {
+        pipeline.resume_attempts = pipeline.session.peer_ip ? PIPELINE_RESUME_ATTEMPTS : 0;
+        ESP_LOGI(TAG, "Session resumed");
+    } else {
+        memset(&pipeline.session, 0, sizeof(pipeline.session));
+    }
+
+    // Krypto-Backend samt Selbsttest vor dem Start des Crypto-Tasks wählen
+    ESP_LOGI(TAG, "Crypto backend: %s", orobi_crypto_backend_name());
+
+    if (!pipeline_open_socket()) {
+        return false;
+    }
+
+    // Crypto-Task zuerst, der RX-Task benachrichtigt ihn
+    if (xTaskCreatePinnedToCore(pipeline_crypto_task, "orobi_crypto", PIPELINE_STACK_SIZE, NULL,
+                                PIPELINE_CRYPTO_PRIORITY, &pipeline.crypto_task, PIPELINE_NET_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(pipeline_motor_task, "orobi_motor", PIPELINE_STACK_SIZE, NULL,
+                                PIPELINE_MOTOR_PRIORITY, NULL, PIPELINE_MOTOR_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(pipeline_rx_task, "orobi_rx", PIPELINE_STACK_SIZE, NULL,
+                                PIPELINE_RX_PRIORITY, NULL, PIPELINE_NET_CORE) != pdPASS ||
+        xTaskCreatePinnedToCore(pipeline_session_task, "orobi_session", PIPELINE_STACK_SIZE, NULL,
+                                PIPELINE_SESSION_PRIORITY, NULL, PIPELINE_NET_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Error creating pipeline tasks");
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Pipeline running on UDP port %d", PIPELINE_UDP_PORT);
+    return true;
+}
+
+bool pipeline_post_telemetry(const orobi_telemetry_t* frame) {
+    if (!frame) {
+        return false;
+    }
+
+    orobi_telemetry_t* slot = orobi_ring_acquire_write(&pipeline.tlm_ring);
+    if (!slot) {
+        return false;
+    }
+    *slot = *frame;
+    if (slot->timestamp_ms == 0) {
+        slot->timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    }
+    orobi_ring_commit_write(&pipeline.tlm_ring);
+    return true;
+}
+
+void pipeline_get_stats(pipeline_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+
+    pipeline_queue_stats(&pipeline.rx_ring, &stats->rx);
+    pipeline_queue_stats(&pipeline.cmd_ring, &stats->cmd);
+    pipeline_queue_stats(&pipeline.tlm_ring, &stats->telemetry);
+    stats->crypto = pipeline.crypto_latency;
+    stats->motor = pipeline.motor_latency;
+    stats->rx_packets = atomic_load_explicit(&pipeline.rx_packets, memory_order_relaxed);
+    stats->rejected_packets = atomic_load_explicit(&pipeline.rejected_packets, memory_order_relaxed);
+    stats->rejected_commands = atomic_load_explicit(&pipeline.rejected_commands, memory_order_relaxed);
+    stats->expired_commands = atomic_load_explicit(&pipeline.expired_commands, memory_order_relaxed);
+    stats->tx_packets = atomic_load_explicit(&pipeline.tx_packets, memory_order_relaxed);
+    stats->tx_dropped_frames = atomic_load_explicit(&pipeline.tx_dropped_frames, memory_order_relaxed);
+    stats->tx_coalesced_frames = atomic_load_explicit(&pipeline.tx_coalesced_frames, memory_order_relaxed);
+    stats->tx_expired_frames = atomic_load_explicit(&pipeline.tx_expired_frames, memory_order_relaxed);
+    orobi_secure_get_metrics(&pipeline.secure, &stats->secure);
+    orobi_clock_get_quality(&pipeline.clock, (uint32_t)(esp_timer_get_time() / 1000), &stats->clock);
+}
@@ -0,0 +1,75 @@
+// session.c
+#include "session.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "SESSION";
+
+#define OPENROBBI_SESSION_NAMESPACE  "OpenROBI"
+#define OPENROBBI_SESSION_KEY        "orob_sess"
+
+// Inhalt des Flash, um identische Schreibvorgänge zu sparen
+static orobi_session_ticket_t stored;
+static bool stored_valid;
+
+bool session_load(orobi_session_ticket_t* ticket) {
+    nvs_handle_t handle;
+    if (!ticket || nvs_open(OPENROBBI_SESSION_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+
+    size_t size = sizeof(orobi_session_ticket_t);
+    esp_err_t err = nvs_get_blob(handle, OPENROBBI_SESSION_KEY, ticket, &size);
+    nvs_close(handle);
+    if (err != ESP_OK || size != sizeof(orobi_session_ticket_t)) {
+        ESP_LOGI(TAG, "No session ticket found");
+        return false;
+    }
+
+    stored = *ticket;
+    stored_valid = true;
+    return true;
+}
+
+bool session_store(const orobi_session_ticket_t* ticket) {
+    if (!ticket) {
+        return false;
+    }
+    if (stored_valid && memcmp(&stored, ticket, sizeof(orobi_session_ticket_t)) == 0) {
+        return true;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(OPENROBBI_SESSION_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle");
+        return false;
+    }
+
+    err = nvs_set_blob(handle, OPENROBBI_SESSION_KEY, ticket, sizeof(orobi_session_ticket_t));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error saving session ticket");
+        return false;
+    }
+
+    stored = *ticket;
+    stored_valid = true;
+    return true;
+}
+
+void session_erase(void) {
+    nvs_handle_t handle;
+    if (nvs_open(OPENROBBI_SESSION_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return;
+    }
+    nvs_erase_key(handle, OPENROBBI_SESSION_KEY);
+    nvs_commit(handle);
+    nvs_close(handle);
+    stored_valid = false;
+}
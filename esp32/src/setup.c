@@ -1,6 +1,7 @@
 
 // setup.c
 #include "setup.h"
+#include "session.h"
 #include "esp_log.h"
 #include "driver/uart.h"
 #include <string.h>
@@ -53,6 +54,7 @@ static bool parse_pc_public_key(const char* json_str) {
     cJSON_Delete(root);
     setup_data.pc_key_received = true;
     save_setup_data();
+    session_erase();    // Ticket gehört zur alten Bodenstation
     return true;
 }
 
@@ -87,6 +89,10 @@ bool setup_check(void) {
     return (err == ESP_OK && setup_data.pc_key_received);
 }
 
+const setup_data_t* setup_get_data(void) {
+    return &setup_data;
+}
+
 static void setup_loop(void) {
     static uint64_t last_print = 0;
     uint64_t current_time = esp_timer_get_time() / 1000000;
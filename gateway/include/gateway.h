@@ -0,0 +1,127 @@
+#ifndef __LIBOPENROBI_GATEWAY_H__
+#define __LIBOPENROBI_GATEWAY_H__
+
+#include "orobi_command.h"
+#include "orobi_reliable.h"
+#include <netinet/in.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bodenstation für viele Roboter (Linux): ein nicht-blockierender UDP-Socket, epoll,
+// recvmmsg/sendmmsg in Blöcken von OROBI_GATEWAY_BATCH Datagrammen.
+// Jeder Roboter hat einen eigenen orobi_secure_t (id, Replay-Fenster, Nonce-Counter),
+// gefunden über eine Direkttabelle api_key -> Roboter (O(1)).
+// orobi_gateway_poll und die Verwaltung laufen in genau einem Thread, Entschlüsseln optional in Workern.
+// Alle Puffer werden beim Anlegen reserviert, der Paketpfad allokiert nicht.
+// Das Gateway ist Master der Sitzungsuhr (orobi_clock.h): Uhrabgleich-Anfragen der Roboter beantwortet es
+// selbst, Pakete mit Zeitstempel älter als OROBI_MAX_PACKET_AGE_MS werden abgewiesen.
+#ifndef OROBI_GATEWAY_MAX_ROBOTS
+#define OROBI_GATEWAY_MAX_ROBOTS        1024
+#endif
+#define OROBI_GATEWAY_BATCH             64      // Datagramme pro recvmmsg/sendmmsg
+#define OROBI_GATEWAY_NONE              0xFFFF
+// Worker-Pool (orobi_gateway_start_workers)
+#define OROBI_GATEWAY_MAX_WORKERS       64
+#define OROBI_GATEWAY_MAILBOX           32      // Zweierpotenz, wartende Datagramme pro Roboter
+#ifndef OROBI_GATEWAY_POOL_BUFFERS
+#define OROBI_GATEWAY_POOL_BUFFERS      2048    // Empfangspuffer im Umlauf (je OROBI_NETPACKET_MAXSIZE)
+#endif
+// Zuverlässiger Kanal: orobi_gateway_poll wartet höchstens so lange, solange Pakete unbestätigt sind
+#define OROBI_GATEWAY_RELIABLE_TICK_MS  10
+#if OROBI_GATEWAY_MAX_ROBOTS > OROBI_RELIABLE_MAX_CHANNELS
+#error "OROBI_GATEWAY_MAX_ROBOTS > OROBI_RELIABLE_MAX_CHANNELS (Slot ist der Kanal in der Ticket-Tabelle)"
+#endif
+
+typedef struct {
+    uint16_t            api_key;
+    uint128_t           id;
+    unsigned char       public_key[crypto_box_PUBLICKEYBYTES];
+    orobi_secure_t      secure;             // Empfang und Versand dieses Roboters
+    struct sockaddr_in  addr;               // Absender des letzten gültigen Pakets
+    bool                addr_known;
+    uint8_t             tx_seq;
+    uint8_t             rx_seq;             // seq_nr des letzten gültigen Pakets
+    uint64_t            rx_packets;
+    uint64_t            tx_packets;
+    uint64_t            rejected;           // Krypto/Hash/Replay/Alter abgelehnt
+    orobi_reliable_tx_t* reliable;          // NULL bis zum ersten orobi_gateway_send_reliable
+    void*               user;
+} orobi_gateway_robot_t;
+
+typedef struct {
+    uint64_t            rx_datagrams;
+    uint64_t            rx_syscalls;        // recvmmsg-Aufrufe mit Daten
+    uint64_t            tx_datagrams;
+    uint64_t            tx_syscalls;
+    uint64_t            tx_dropped;         // Socket-Puffer voll oder Fehler
+    uint64_t            unknown_robot;      // api_key nicht registriert
+    uint64_t            malformed;          // Netzwerkpaket ungültig
+    uint64_t            rejected;           // Summe der rejected-Zähler aller Roboter
+    uint64_t            rx_dropped;         // Worker-Pool: Postfach des Roboters voll
+    uint64_t            rx_paused;          // Worker-Pool: Empfang ausgesetzt, alle Puffer bei den Workern
+    uint64_t            robots_stolen;      // Worker-Pool: von einem fremden Worker abgearbeitet
+} orobi_gateway_stats_t;
+
+typedef struct orobi_gateway orobi_gateway_t;
+
+// Wird für jede gültige, entschlüsselte (und ggf. dekomprimierte) Nachricht aufgerufen.
+// message ist nur bis zur Rückkehr gültig. Antworten mit orobi_gateway_send sind hier erlaubt.
+// Mit Workern läuft der Handler parallel für verschiedene Roboter, für denselben Roboter nie
+// gleichzeitig und immer in Empfangsreihenfolge.
+typedef void (*orobi_gateway_handler_t)(orobi_gateway_t* gateway, orobi_gateway_robot_t* robot,
+                                        const uint8_t* message, size_t size, void* user);
+
+// bind_addr NULL: alle Interfaces. port 0: beliebiger Port (siehe orobi_gateway_port).
+orobi_error_t          orobi_gateway_create(orobi_gateway_t** gateway, const char* bind_addr, uint16_t port,
+                                            const unsigned char* public_key, const unsigned char* secret_key,
+                                            orobi_gateway_handler_t handler, void* user);
+void                   orobi_gateway_destroy(orobi_gateway_t* gateway);
+uint16_t               orobi_gateway_port(const orobi_gateway_t* gateway);
+// Sitzungszeit in ms, gemeinsam mit synchronisierten Robotern (Zeitstempel der Telemetrie, Fristen)
+uint32_t               orobi_gateway_now_ms(const orobi_gateway_t* gateway);
+// epoll-Deskriptor, kann in eine übergeordnete Event-Loop eingehängt werden
+int                    orobi_gateway_fd(const orobi_gateway_t* gateway);
+
+// Registriert einen Roboter (id und public_key aus dem Setup des Roboters)
+orobi_error_t          orobi_gateway_add_robot(orobi_gateway_t* gateway, uint16_t api_key, uint128_t id,
+                                               const unsigned char* public_key, void* user);
+orobi_error_t          orobi_gateway_remove_robot(orobi_gateway_t* gateway, uint16_t api_key);
+orobi_gateway_robot_t* orobi_gateway_find(orobi_gateway_t* gateway, uint16_t api_key);
+
+// Wartet bis zu timeout_ms (-1: unbegrenzt) auf Datagramme, verarbeitet alle anstehenden
+// und sendet danach die Sendewarteschlange. processed: Anzahl empfangener Datagramme (optional).
+orobi_error_t          orobi_gateway_poll(orobi_gateway_t* gateway, int timeout_ms, size_t* processed);
+
+// Verschlüsselt message für den Roboter in die Sendewarteschlange; gesendet wird mit
+// orobi_gateway_flush, spätestens am Ende von orobi_gateway_poll oder wenn die Warteschlange voll ist.
+// OROBI_ERROR_INVALID_CONFIGURATION: Adresse des Roboters noch unbekannt (noch kein Paket empfangen).
+orobi_error_t          orobi_gateway_send(orobi_gateway_t* gateway, orobi_gateway_robot_t* robot,
+                                          const void* message, uint16_t size);
+orobi_error_t          orobi_gateway_flush(orobi_gateway_t* gateway);
+
+// Zuverlässig senden (orobi_reliable.h): bis zu OROBI_RELIABLE_WINDOW Nachrichten je Roboter unterwegs,
+// Verluste wiederholt orobi_gateway_poll. Die ACKs des Roboters erreichen den Handler nicht.
+// size <= OROBI_RELIABLE_MAXPAYLOAD. OROBI_ERROR_COMMAND_OVERFLOW: Fenster voll, nach dem nächsten poll erneut.
+// Mit Workern wie orobi_gateway_send nur aus dem Handler des Roboters; ACKs und Wiederholungen
+// bearbeitet dann der Worker, der den Roboter hält, die Timer tickt weiterhin orobi_gateway_poll.
+orobi_error_t          orobi_gateway_send_reliable(orobi_gateway_t* gateway, orobi_gateway_robot_t* robot,
+                                                   const void* message, uint16_t size);
+
+// Verteilt Entschlüsseln, Prüfen und Handler auf count Threads. Jeder Roboter hat einen Heimat-Worker
+// (api_key % count); freie Worker stehlen wartende Roboter aus fremden Queues. Ein Roboter wird immer
+// nur von einem Worker gleichzeitig bearbeitet, sein orobi_secure_t braucht daher keine Sperre.
+// Solange Worker laufen: orobi_gateway_send und orobi_gateway_send_reliable nur aus dem Handler des
+// jeweiligen Roboters, orobi_gateway_remove_robot ist nicht erlaubt.
+orobi_error_t          orobi_gateway_start_workers(orobi_gateway_t* gateway, unsigned count);
+// Wartet auf die Worker; noch nicht bearbeitete Datagramme werden verworfen
+void                   orobi_gateway_stop_workers(orobi_gateway_t* gateway);
+
+void                   orobi_gateway_get_stats(const orobi_gateway_t* gateway, orobi_gateway_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_GATEWAY_H__
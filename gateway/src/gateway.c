@@ -0,0 +1,533 @@
+#define _GNU_SOURCE
+#include "gateway_internal.h"
+#include "orobi_crypto.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+__thread orobi_gateway_lane_t* __orobi_gateway_thread_lane = NULL;
+
+static uint32_t __orobi_gateway_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+void __orobi_gateway_lane_init(orobi_gateway_lane_t* lane) {
+    for (unsigned i = 0; i < OROBI_GATEWAY_BATCH; i++) {
+        lane->tx_iov[i].iov_base = lane->tx_buf[i];
+        lane->tx_msgs[i].msg_hdr.msg_iov = &lane->tx_iov[i];
+        lane->tx_msgs[i].msg_hdr.msg_iovlen = 1;
+        lane->tx_msgs[i].msg_hdr.msg_name = &lane->tx_addr[i];
+        lane->tx_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+    lane->tx_count = 0;
+}
+
+static orobi_error_t __orobi_gateway_open_socket(orobi_gateway_t* gw, const char* bind_addr, uint16_t port) {
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY)
+    };
+    if (bind_addr && inet_pton(AF_INET, bind_addr, &addr.sin_addr) != 1) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+
+    gw->sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+    if (gw->sock < 0) {
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // Große Socket-Puffer: bei vielen Robotern kommen Bursts zwischen zwei poll-Aufrufen an
+    int size = 4 * 1024 * 1024;
+    setsockopt(gw->sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    setsockopt(gw->sock, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+
+    socklen_t len = sizeof(addr);
+    if (bind(gw->sock, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        getsockname(gw->sock, (struct sockaddr*)&addr, &len) < 0) {
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+    gw->port = ntohs(addr.sin_port);
+
+    gw->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (gw->epoll_fd < 0) {
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = gw->sock };
+    if (epoll_ctl(gw->epoll_fd, EPOLL_CTL_ADD, gw->sock, &event) < 0) {
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+
+    gw->timers_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    event.data.fd = gw->timers_event;
+    if (gw->timers_event < 0 || epoll_ctl(gw->epoll_fd, EPOLL_CTL_ADD, gw->timers_event, &event) < 0) {
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_gateway_create(orobi_gateway_t** gateway, const char* bind_addr, uint16_t port,
+                                   const unsigned char* public_key, const unsigned char* secret_key,
+                                   orobi_gateway_handler_t handler, void* user) {
+    if (!gateway || !public_key || !secret_key || !handler) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_gateway_t* gw = calloc(1, sizeof(orobi_gateway_t));
+    if (!gw) {
+        return OROBI_ERROR_MEMORY;
+    }
+    gw->sock = -1;
+    gw->epoll_fd = -1;
+    gw->timers_event = -1;
+    pthread_mutex_init(&gw->timers_lock, NULL);
+    memcpy(gw->public_key, public_key, crypto_box_PUBLICKEYBYTES);
+    memcpy(gw->secret_key, secret_key, crypto_box_SECRETKEYBYTES);
+    gw->handler = handler;
+    gw->user = user;
+
+    // Krypto-Backend samt Selbsttest jetzt wählen, nicht im ersten Worker
+    orobi_crypto_get_backend();
+
+    memset(gw->slot_by_key, 0xFF, sizeof(gw->slot_by_key));
+    for (uint16_t i = 0; i < OROBI_GATEWAY_MAX_ROBOTS; i++) {
+        gw->free_slots[i] = (uint16_t)(OROBI_GATEWAY_MAX_ROBOTS - 1 - i);
+    }
+    gw->free_count = OROBI_GATEWAY_MAX_ROBOTS;
+
+    for (unsigned i = 0; i < OROBI_GATEWAY_BATCH; i++) {
+        gw->rx_iov[i].iov_base = gw->rx_buf[i];
+        gw->rx_iov[i].iov_len = OROBI_NETPACKET_MAXSIZE;
+        gw->rx_msgs[i].msg_hdr.msg_iov = &gw->rx_iov[i];
+        gw->rx_msgs[i].msg_hdr.msg_iovlen = 1;
+        gw->rx_msgs[i].msg_hdr.msg_name = &gw->rx_addr[i];
+    }
+    __orobi_gateway_lane_init(&gw->lane);
+    orobi_ticket_table_init(&gw->timers, __orobi_gateway_now_ms());
+    orobi_clock_init(&gw->clock, true);
+
+    orobi_error_t status = __orobi_gateway_open_socket(gw, bind_addr, port);
+    if (status != OROBI_OK) {
+        orobi_gateway_destroy(gw);
+        return status;
+    }
+
+    *gateway = gw;
+    return OROBI_OK;
+}
+
+void orobi_gateway_destroy(orobi_gateway_t* gateway) {
+    if (!gateway) {
+        return;
+    }
+
+    orobi_gateway_stop_workers(gateway);
+    for (unsigned i = 0; i < OROBI_GATEWAY_MAX_ROBOTS; i++) {
+        free(gateway->robots[i].reliable);
+    }
+    if (gateway->timers_event >= 0) {
+        close(gateway->timers_event);
+    }
+    if (gateway->epoll_fd >= 0) {
+        close(gateway->epoll_fd);
+    }
+    pthread_mutex_destroy(&gateway->timers_lock);
+    if (gateway->sock >= 0) {
+        close(gateway->sock);
+    }
+    // Schlüsselmaterial nicht im freigegebenen Speicher liegen lassen
+    memset(gateway, 0, sizeof(orobi_gateway_t));
+    free(gateway);
+}
+
+uint16_t orobi_gateway_port(const orobi_gateway_t* gateway) {
+    return gateway ? gateway->port : 0;
+}
+
+uint32_t orobi_gateway_now_ms(const orobi_gateway_t* gateway) {
+    return gateway ? orobi_clock_now(&gateway->clock) : 0;
+}
+
+int orobi_gateway_fd(const orobi_gateway_t* gateway) {
+    return gateway ? gateway->epoll_fd : -1;
+}
+
+orobi_error_t orobi_gateway_add_robot(orobi_gateway_t* gateway, uint16_t api_key, uint128_t id,
+                                      const unsigned char* public_key, void* user) {
+    if (!gateway || !public_key) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (gateway->slot_by_key[api_key] != OROBI_GATEWAY_NONE) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+    if (gateway->free_count == 0) {
+        return OROBI_ERROR_MEMORY;
+    }
+
+    const uint16_t slot = gateway->free_slots[--gateway->free_count];
+    orobi_gateway_robot_t* robot = &gateway->robots[slot];
+    memset(robot, 0, sizeof(orobi_gateway_robot_t));
+    robot->api_key = api_key;
+    robot->id = id;
+    robot->user = user;
+    memcpy(robot->public_key, public_key, crypto_box_PUBLICKEYBYTES);
+
+    // Arbeitspuffer setzt __orobi_gateway_dispatch je nach Thread
+    orobi_secure_init(&robot->secure, id, gateway->public_key, gateway->secret_key);
+    orobi_secure_set_clock(&robot->secure, &gateway->clock, 0);
+
+    gateway->slot_by_key[api_key] = slot;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_gateway_remove_robot(orobi_gateway_t* gateway, uint16_t api_key) {
+    if (!gateway) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (gateway->pool) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+
+    const uint16_t slot = gateway->slot_by_key[api_key];
+    if (slot == OROBI_GATEWAY_NONE) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    orobi_gateway_robot_t* robot = &gateway->robots[slot];
+    if (robot->reliable) {
+        pthread_mutex_lock(&gateway->timers_lock);
+        orobi_reliable_tx_reset(robot->reliable);     // Timer aus der Tabelle nehmen
+        pthread_mutex_unlock(&gateway->timers_lock);
+        free(robot->reliable);
+    }
+    // Kein orobi_secure_close: der Kontext liegt in der Tabelle und wird nicht freigegeben
+    memset(robot, 0, sizeof(orobi_gateway_robot_t));
+    gateway->slot_by_key[api_key] = OROBI_GATEWAY_NONE;
+    gateway->free_slots[gateway->free_count++] = slot;
+    return OROBI_OK;
+}
+
+orobi_gateway_robot_t* orobi_gateway_find(orobi_gateway_t* gateway, uint16_t api_key) {
+    if (!gateway) {
+        return NULL;
+    }
+    const uint16_t slot = gateway->slot_by_key[api_key];
+    return slot == OROBI_GATEWAY_NONE ? NULL : &gateway->robots[slot];
+}
+
+// Sendet alle fälligen Nachrichten des zuverlässigen Kanals (neu, per SACK oder Timeout verloren).
+// Der Kanal gehört dem Thread, der den Roboter hält; nur die Ticket-Tabelle ist geteilt.
+static void __orobi_gateway_reliable_pump(orobi_gateway_t* gw, orobi_gateway_robot_t* robot) {
+    const uint8_t* message;
+    size_t size;
+    const uint32_t now = __orobi_gateway_now_ms();
+    for (;;) {
+        pthread_mutex_lock(&gw->timers_lock);
+        const bool idle = gw->timers.count == 0;
+        const bool due = orobi_reliable_poll(robot->reliable, now, &message, &size);
+        const bool armed = idle && gw->timers.count > 0;
+        pthread_mutex_unlock(&gw->timers_lock);
+
+        // Worker: der Poll-Thread wartet womöglich ohne Timeout, erst ab jetzt muss er ticken
+        if (armed && gw->pool) {
+            eventfd_write(gw->timers_event, 1);
+        }
+        // Bei Fehler läuft der Timer trotzdem, die Nachricht wird dann wiederholt
+        if (!due || orobi_gateway_send(gw, robot, message, (uint16_t)size) != OROBI_OK) {
+            break;
+        }
+    }
+}
+
+void __orobi_gateway_reliable_timeout(orobi_gateway_t* gw, orobi_gateway_robot_t* robot,
+                                      const orobi_ticket_t* ticket) {
+    if (!robot->reliable) {
+        return;
+    }
+    pthread_mutex_lock(&gw->timers_lock);
+    orobi_reliable_timeout(robot->reliable, ticket);
+    pthread_mutex_unlock(&gw->timers_lock);
+    __orobi_gateway_reliable_pump(gw, robot);
+}
+
+static bool __orobi_gateway_timers_active(orobi_gateway_t* gw) {
+    pthread_mutex_lock(&gw->timers_lock);
+    const bool active = gw->timers.count > 0;
+    pthread_mutex_unlock(&gw->timers_lock);
+    return active;
+}
+
+// Abgelaufene Timer an ihre Kanäle verteilen; mit Workern an den Worker, der den Roboter hält
+static void __orobi_gateway_reliable_tick(orobi_gateway_t* gw) {
+    orobi_ticket_t expired[OROBI_GATEWAY_BATCH];
+    size_t count;
+    do {
+        pthread_mutex_lock(&gw->timers_lock);
+        orobi_ticket_tick(&gw->timers, __orobi_gateway_now_ms(), expired, OROBI_GATEWAY_BATCH, &count);
+        pthread_mutex_unlock(&gw->timers_lock);
+        if (gw->pool) {
+            __orobi_gateway_pool_timeouts(gw, expired, count);
+            continue;
+        }
+        for (size_t i = 0; i < count; i++) {
+            __orobi_gateway_reliable_timeout(gw, &gw->robots[expired[i].id >> OROBI_RELIABLE_WINDOW_BITS],
+                                             &expired[i]);
+        }
+    } while (count == OROBI_GATEWAY_BATCH);
+}
+
+void __orobi_gateway_dispatch(orobi_gateway_t* gw, orobi_gateway_lane_t* lane, orobi_gateway_robot_t* robot,
+                              const uint8_t* data, size_t size, const struct sockaddr_in* addr, uint32_t rx_ms) {
+    orobi_netpacket_view_t view;
+    const uint8_t* message = NULL;
+    size_t message_size = 0;
+
+    orobi_secure_set_scratch(&robot->secure, lane->secure_scratch, sizeof(lane->secure_scratch));
+    orobi_error_t status = orobi_netpacket_open(&robot->secure, data, size, robot->public_key, &lane->packet,
+                                                lane->inflate, sizeof(lane->inflate), &view, &message, &message_size);
+    if (status != OROBI_OK) {
+        if (status == OROBI_ERROR_PACKET_VALIDATION_FAILED || status == OROBI_ERROR_HASH_MISMATCH) {
+            OROBI_GATEWAY_COUNT(lane->stats.malformed, 1);
+        } else {
+            robot->rejected++;
+            OROBI_GATEWAY_COUNT(lane->stats.rejected, 1);
+        }
+        return;
+    }
+
+    // Adresse erst nach erfolgreicher Authentifizierung übernehmen (Roboter darf die IP wechseln)
+    robot->addr = *addr;
+    robot->addr_known = true;
+    robot->rx_seq = view.seq_nr;
+    robot->rx_packets++;
+
+    // Bestätigungen des zuverlässigen Kanals verarbeitet das Gateway selbst
+    if (message_size > 0 && message[0] == OROBI_RELIABLE_ACK_MARKER) {
+        if (robot->reliable) {
+            pthread_mutex_lock(&gw->timers_lock);
+            orobi_reliable_ack(robot->reliable, message, message_size, __orobi_gateway_now_ms());
+            pthread_mutex_unlock(&gw->timers_lock);
+            __orobi_gateway_reliable_pump(gw, robot);
+        }
+        return;
+    }
+    // Uhrabgleich des Roboters: sofort beantworten, t2 ist die Empfangszeit des Datagramms
+    if (message_size > 0 && message[0] == OROBI_CLOCK_REQUEST_MARKER) {
+        uint8_t response[OROBI_CLOCK_RESPONSE_SIZE];
+        size_t response_size;
+        if (orobi_clock_respond(&gw->clock, message, message_size, rx_ms, response, sizeof(response),
+                                &response_size) == OROBI_OK) {
+            orobi_gateway_send(gw, robot, response, (uint16_t)response_size);
+        }
+        return;
+    }
+    gw->handler(gw, robot, message, message_size, gw->user);
+}
+
+// Kopfzeile lesen, um den Roboter zu finden; Hash und Krypto prüft orobi_netpacket_open
+orobi_gateway_robot_t* __orobi_gateway_route(orobi_gateway_t* gw, orobi_gateway_lane_t* lane,
+                                             const uint8_t* data, size_t size) {
+    if (size < OROBI_NETPACKET_HEADER_SIZE) {
+        OROBI_GATEWAY_COUNT(lane->stats.malformed, 1);
+        return NULL;
+    }
+    orobi_gateway_robot_t* robot = orobi_gateway_find(gw, orobi_read_le16(data + 2));
+    if (!robot) {
+        OROBI_GATEWAY_COUNT(lane->stats.unknown_robot, 1);
+    }
+    return robot;
+}
+
+static size_t __orobi_gateway_receive(orobi_gateway_t* gw) {
+    size_t total = 0;
+
+    for (;;) {
+        for (unsigned i = 0; i < OROBI_GATEWAY_BATCH; i++) {
+            gw->rx_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        }
+        const int n = recvmmsg(gw->sock, gw->rx_msgs, OROBI_GATEWAY_BATCH, MSG_DONTWAIT, NULL);
+        if (n <= 0) {
+            break;      // EAGAIN: Socket leer
+        }
+
+        gw->rx_syscalls++;
+        gw->rx_datagrams += (uint64_t)n;
+        const uint32_t rx_ms = orobi_clock_local_ms();
+        for (int i = 0; i < n; i++) {
+            const size_t size = gw->rx_msgs[i].msg_len;
+            orobi_gateway_robot_t* robot = __orobi_gateway_route(gw, &gw->lane, gw->rx_buf[i], size);
+            if (robot) {
+                __orobi_gateway_dispatch(gw, &gw->lane, robot, gw->rx_buf[i], size, &gw->rx_addr[i], rx_ms);
+            }
+        }
+        total += (size_t)n;
+
+        if (n < OROBI_GATEWAY_BATCH) {
+            break;
+        }
+    }
+    return total;
+}
+
+orobi_error_t orobi_gateway_poll(orobi_gateway_t* gateway, int timeout_ms, size_t* processed) {
+    if (!gateway) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+
+    size_t total = 0;
+    struct epoll_event events[2];
+    if (__orobi_gateway_timers_active(gateway) && (timeout_ms < 0 || timeout_ms > OROBI_GATEWAY_RELIABLE_TICK_MS)) {
+        timeout_ms = OROBI_GATEWAY_RELIABLE_TICK_MS;
+    }
+    const int ready = epoll_wait(gateway->epoll_fd, events, 2, timeout_ms);
+    if (ready < 0 && errno != EINTR) {
+        return OROBI_ERROR_INITIALIZATION_FAILED;
+    }
+    for (int i = 0; i < ready; i++) {
+        if (events[i].data.fd == gateway->timers_event) {
+            eventfd_t value;
+            eventfd_read(gateway->timers_event, &value);
+        } else {
+            total = gateway->pool ? __orobi_gateway_pool_receive(gateway) : __orobi_gateway_receive(gateway);
+        }
+    }
+    if (__orobi_gateway_timers_active(gateway)) {
+        __orobi_gateway_reliable_tick(gateway);
+    }
+
+    if (processed) {
+        *processed = total;
+    }
+    return __orobi_gateway_flush_lane(gateway, &gateway->lane);
+}
+
+orobi_error_t orobi_gateway_send(orobi_gateway_t* gateway, orobi_gateway_robot_t* robot,
+                                 const void* message, uint16_t size) {
+    if (!gateway || !robot || !message) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (!robot->addr_known) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+
+    orobi_gateway_lane_t* lane = __orobi_gateway_thread_lane ? __orobi_gateway_thread_lane : &gateway->lane;
+    if (lane->tx_count == OROBI_GATEWAY_BATCH) {
+        orobi_error_t status = __orobi_gateway_flush_lane(gateway, lane);
+        if (status != OROBI_OK) {
+            return status;
+        }
+    }
+
+    const unsigned i = lane->tx_count;
+    size_t written = 0;
+    orobi_secure_set_scratch(&robot->secure, lane->secure_scratch, sizeof(lane->secure_scratch));
+    orobi_error_t status = orobi_netpacket_seal(&robot->secure, &lane->lz_work, &lane->packet,
+                                                robot->tx_seq, robot->api_key, message, size, robot->public_key,
+                                                lane->tx_buf[i], OROBI_NETPACKET_MAXSIZE, &written);
+    if (status != OROBI_OK) {
+        return status;
+    }
+
+    robot->tx_seq++;
+    robot->tx_packets++;
+    lane->tx_iov[i].iov_len = written;
+    lane->tx_addr[i] = robot->addr;
+    lane->tx_count++;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_gateway_send_reliable(orobi_gateway_t* gateway, orobi_gateway_robot_t* robot,
+                                          const void* message, uint16_t size) {
+    if (!gateway || !robot || (!message && size > 0)) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (!robot->addr_known) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+
+    if (!robot->reliable) {
+        robot->reliable = malloc(sizeof(orobi_reliable_tx_t));
+        if (!robot->reliable) {
+            return OROBI_ERROR_MEMORY;
+        }
+        // Zufällige Start-seq und Epoche, damit ein neu gestartetes Gateway nicht als Duplikat gilt
+        uint64_t random = 0;
+        if (getrandom(&random, sizeof(random), 0) != sizeof(random)) {
+            random = __orobi_gateway_now_ms();
+        }
+        orobi_reliable_tx_init(robot->reliable, &gateway->timers, (uint16_t)(robot - gateway->robots), random);
+    }
+
+    orobi_error_t status = orobi_reliable_send(robot->reliable, message, size);
+    if (status != OROBI_OK) {
+        return status;
+    }
+    __orobi_gateway_reliable_pump(gateway, robot);
+    return OROBI_OK;
+}
+
+orobi_error_t __orobi_gateway_flush_lane(orobi_gateway_t* gw, orobi_gateway_lane_t* lane) {
+    unsigned sent = 0;
+    while (sent < lane->tx_count) {
+        const int n = sendmmsg(gw->sock, &lane->tx_msgs[sent], lane->tx_count - sent, MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Socket-Puffer voll oder Zieladresse ungültig: dieses Datagramm verwerfen, Rest weiter senden
+            OROBI_GATEWAY_COUNT(lane->stats.tx_dropped, 1);
+            sent++;
+            continue;
+        }
+        OROBI_GATEWAY_COUNT(lane->stats.tx_syscalls, 1);
+        OROBI_GATEWAY_COUNT(lane->stats.tx_datagrams, (uint64_t)n);
+        sent += (unsigned)n;
+    }
+
+    lane->tx_count = 0;
+    return OROBI_OK;
+}
+
+orobi_error_t orobi_gateway_flush(orobi_gateway_t* gateway) {
+    if (!gateway) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    return __orobi_gateway_flush_lane(gateway, __orobi_gateway_thread_lane ? __orobi_gateway_thread_lane : &gateway->lane);
+}
+
+void __orobi_gateway_sum_stats(orobi_gateway_stats_t* total, const orobi_gateway_stats_t* lane) {
+    total->tx_datagrams += __atomic_load_n(&lane->tx_datagrams, __ATOMIC_RELAXED);
+    total->tx_syscalls += __atomic_load_n(&lane->tx_syscalls, __ATOMIC_RELAXED);
+    total->tx_dropped += __atomic_load_n(&lane->tx_dropped, __ATOMIC_RELAXED);
+    total->unknown_robot += __atomic_load_n(&lane->unknown_robot, __ATOMIC_RELAXED);
+    total->malformed += __atomic_load_n(&lane->malformed, __ATOMIC_RELAXED);
+    total->rejected += __atomic_load_n(&lane->rejected, __ATOMIC_RELAXED);
+    total->rx_dropped += __atomic_load_n(&lane->rx_dropped, __ATOMIC_RELAXED);
+    total->rx_paused += __atomic_load_n(&lane->rx_paused, __ATOMIC_RELAXED);
+    total->robots_stolen += __atomic_load_n(&lane->robots_stolen, __ATOMIC_RELAXED);
+}
+
+void orobi_gateway_get_stats(const orobi_gateway_t* gateway, orobi_gateway_stats_t* stats) {
+    if (!gateway || !stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(orobi_gateway_stats_t));
+    stats->rx_datagrams = gateway->rx_datagrams;
+    stats->rx_syscalls = gateway->rx_syscalls;
+    __orobi_gateway_sum_stats(stats, &gateway->lane.stats);
+    if (gateway->pool) {
+        for (unsigned i = 0; i < gateway->pool->count; i++) {
+            __orobi_gateway_sum_stats(stats, &gateway->pool->workers[i].lane.stats);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef __LIBOPENROBI_GATEWAY_INTERNAL_H__
+#define __LIBOPENROBI_GATEWAY_INTERNAL_H__
+
+#include "gateway.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+
+// Zähler, die von Worker-Threads geschrieben und von orobi_gateway_get_stats gelesen werden
+#define OROBI_GATEWAY_COUNT(field, n)   __atomic_fetch_add(&(field), (n), __ATOMIC_RELAXED)
+
+// Arbeitsspeicher eines Threads im Paketpfad: Entschlüsselung, Kompression und Sendewarteschlange.
+// Das Gateway hat eine Spur für den Thread, der orobi_gateway_poll aufruft, jeder Worker eine eigene.
+typedef struct {
+    orobi_packet_t          packet;
+    orobi_lz_work_t         lz_work;
+    uint8_t                 secure_scratch[OROBI_SECURE_SCRATCH_SIZE];
+    uint8_t                 inflate[OROBI_MAXMESSAGESIZE];
+
+    struct mmsghdr          tx_msgs[OROBI_GATEWAY_BATCH];
+    struct iovec            tx_iov[OROBI_GATEWAY_BATCH];
+    struct sockaddr_in      tx_addr[OROBI_GATEWAY_BATCH];
+    uint8_t                 tx_buf[OROBI_GATEWAY_BATCH][OROBI_NETPACKET_MAXSIZE];
+    unsigned                tx_count;
+
+    orobi_gateway_stats_t   stats;      // Paketpfad-Zähler; rx_datagrams/rx_syscalls stehen im Gateway
+} orobi_gateway_lane_t;
+
+typedef enum {
+    OROBI_GATEWAY_JOB_DATAGRAM = 0,         // empfangenes Datagramm in data
+    OROBI_GATEWAY_JOB_TIMEOUT               // abgelaufener Timer des zuverlässigen Kanals in ticket
+} orobi_gateway_job_t;
+
+// Empfangspuffer des Worker-Pools; frei (Freiliste) oder im Postfach genau eines Roboters
+typedef struct {
+    uint32_t                next;
+    uint8_t                 job;            // orobi_gateway_job_t
+    uint16_t                size;
+    uint32_t                rx_ms;          // lokale Empfangszeit (orobi_clock_local_ms)
+    struct sockaddr_in      addr;
+    orobi_ticket_t          ticket;
+    uint8_t                 data[OROBI_NETPACKET_MAXSIZE];
+} orobi_gateway_buffer_t;
+
+// Postfach eines Roboters: SPSC-Ring von Pufferindizes (Produzent: Poll-Thread, Konsument: der Worker,
+// der den Roboter gerade hält). scheduled == 1, solange der Roboter in einer Worker-Queue steht oder läuft.
+typedef struct {
+    atomic_uint             head;
+    atomic_uint             tail;
+    atomic_uint             scheduled;
+    uint32_t                slots[OROBI_GATEWAY_MAILBOX];
+} orobi_gateway_mailbox_t;
+
+typedef struct {
+    pthread_t               thread;
+    struct orobi_gateway*   gateway;
+    unsigned                index;
+    pthread_mutex_t         lock;
+    pthread_cond_t          wake;
+    uint16_t                queue[OROBI_GATEWAY_MAX_ROBOTS];    // Roboter-Slots, jeder höchstens einmal in allen Queues
+    unsigned                queue_head;
+    unsigned                queue_count;
+    bool                    sleeping;
+    orobi_gateway_lane_t    lane;
+} orobi_gateway_worker_t;
+
+typedef struct {
+    orobi_gateway_worker_t* workers;
+    unsigned                count;
+    atomic_bool             stop;
+    atomic_uint             backlog;        // Roboter in allen Worker-Queues
+    orobi_gateway_buffer_t* buffers;
+    atomic_uint             free_head;      // Freiliste (Treiber-Stack, nur der Poll-Thread entnimmt)
+    atomic_bool             rx_paused;      // Socket aus epoll genommen, bis ein Worker einen Puffer zurückgibt
+    orobi_gateway_mailbox_t mailboxes[OROBI_GATEWAY_MAX_ROBOTS];
+    uint32_t                rx_index[OROBI_GATEWAY_BATCH];  // bereitgestellte Puffer des nächsten recvmmsg
+} orobi_gateway_pool_t;
+
+struct orobi_gateway {
+    int                     sock;
+    int                     epoll_fd;
+    uint16_t                port;
+    unsigned char           public_key[crypto_box_PUBLICKEYBYTES];
+    unsigned char           secret_key[crypto_box_SECRETKEYBYTES];
+    orobi_gateway_handler_t handler;
+    void*                   user;
+
+    // Roboter: Slots mit Freiliste, Direkttabelle api_key -> Slot
+    orobi_gateway_robot_t   robots[OROBI_GATEWAY_MAX_ROBOTS];
+    uint16_t                free_slots[OROBI_GATEWAY_MAX_ROBOTS];
+    uint16_t                free_count;
+    uint16_t                slot_by_key[UINT16_MAX + 1];
+
+    // recvmmsg; ohne Worker wird direkt aus rx_buf verarbeitet, mit Workern in Pool-Puffer empfangen
+    struct mmsghdr          rx_msgs[OROBI_GATEWAY_BATCH];
+    struct iovec            rx_iov[OROBI_GATEWAY_BATCH];
+    struct sockaddr_in      rx_addr[OROBI_GATEWAY_BATCH];
+    uint8_t                 rx_buf[OROBI_GATEWAY_BATCH][OROBI_NETPACKET_MAXSIZE];
+    uint64_t                rx_datagrams;
+    uint64_t                rx_syscalls;
+
+    orobi_gateway_lane_t    lane;           // Spur des Poll-Threads
+    orobi_gateway_pool_t*   pool;           // NULL: keine Worker
+
+    // Wiederholungs-Timer aller zuverlässigen Kanäle, Kanal = Roboter-Slot. Mit Workern legen auch sie
+    // Timer an (unter timers_lock); abgelaufene verteilt der Poll-Thread über die Postfächer.
+    orobi_ticket_table_t    timers;
+    pthread_mutex_t         timers_lock;
+    int                     timers_event;   // eventfd: erster Timer angelegt, Poll-Thread soll ticken
+    // Master der Sitzungsuhr aller Roboter; nach create nur gelesen (auch von Workern)
+    orobi_clock_t           clock;
+};
+
+// Spur des aufrufenden Threads für orobi_gateway_send (NULL: Spur des Poll-Threads)
+extern __thread orobi_gateway_lane_t* __orobi_gateway_thread_lane;
+
+void          __orobi_gateway_lane_init(orobi_gateway_lane_t* lane);
+// Roboter zum api_key im Kopf eines Datagramms (NULL: zu kurz oder unbekannt, gezählt)
+orobi_gateway_robot_t* __orobi_gateway_route(orobi_gateway_t* gw, orobi_gateway_lane_t* lane,
+                                             const uint8_t* data, size_t size);
+// Öffnet, prüft und übergibt ein Datagramm an den Handler; rx_ms: lokale Empfangszeit
+void          __orobi_gateway_dispatch(orobi_gateway_t* gw, orobi_gateway_lane_t* lane, orobi_gateway_robot_t* robot,
+                                       const uint8_t* data, size_t size, const struct sockaddr_in* addr,
+                                       uint32_t rx_ms);
+orobi_error_t __orobi_gateway_flush_lane(orobi_gateway_t* gw, orobi_gateway_lane_t* lane);
+// Abgelaufener Timer eines Roboters: Nachricht wiederholen; im Thread, der den Roboter hält
+void          __orobi_gateway_reliable_timeout(orobi_gateway_t* gw, orobi_gateway_robot_t* robot,
+                                               const orobi_ticket_t* ticket);
+void          __orobi_gateway_sum_stats(orobi_gateway_stats_t* total, const orobi_gateway_stats_t* lane);
+
+// Worker-Pool (gateway_pool.c)
+size_t        __orobi_gateway_pool_receive(orobi_gateway_t* gw);
+// Übergibt abgelaufene Timer an die Worker der jeweiligen Roboter (nur Poll-Thread)
+void          __orobi_gateway_pool_timeouts(orobi_gateway_t* gw, const orobi_ticket_t* expired, size_t count);
+
+#endif // __LIBOPENROBI_GATEWAY_INTERNAL_H__
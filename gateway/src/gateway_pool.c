@@ -0,0 +1,422 @@
+#define _GNU_SOURCE
+#include "gateway_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+
+#define OROBI_GATEWAY_NO_BUFFER     UINT32_MAX
+
+// Freiliste der Empfangspuffer: Treiber-Stack. Zurückgeben darf jeder Thread, entnehmen nur der
+// Poll-Thread; mit einem einzigen Entnehmer gibt es kein ABA-Problem.
+static void __orobi_pool_free(orobi_gateway_pool_t* pool, uint32_t index) {
+    unsigned head = atomic_load_explicit(&pool->free_head, memory_order_relaxed);
+    do {
+        pool->buffers[index].next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->free_head, &head, index,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+// Socket wieder in epoll aufnehmen (events 0 -> EPOLLIN)
+static void __orobi_pool_rx_arm(orobi_gateway_t* gw, uint32_t events) {
+    struct epoll_event event = { .events = events, .data.fd = gw->sock };
+    epoll_ctl(gw->epoll_fd, EPOLL_CTL_MOD, gw->sock, &event);
+}
+
+// Puffer zurückgeben und einen ausgesetzten Empfang fortsetzen. Der Fence paart sich mit dem in
+// __orobi_pool_rx_pause: entweder sieht der Poll-Thread den Puffer oder dieser Thread rx_paused.
+static void __orobi_pool_release(orobi_gateway_t* gw, uint32_t index) {
+    orobi_gateway_pool_t* pool = gw->pool;
+    __orobi_pool_free(pool, index);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&pool->rx_paused, memory_order_relaxed) && atomic_exchange(&pool->rx_paused, false)) {
+        __orobi_pool_rx_arm(gw, EPOLLIN);
+    }
+}
+
+// Alle Puffer bei den Workern: epoll ist level-triggered, der Socket bliebe lesbar und poll würde
+// durchdrehen. Die Datagramme bleiben im Socket-Puffer, bis __orobi_pool_release den Empfang fortsetzt.
+static void __orobi_pool_rx_pause(orobi_gateway_t* gw) {
+    orobi_gateway_pool_t* pool = gw->pool;
+    // Erst aus epoll nehmen, dann das Flag setzen: ein Worker, der es sieht, nimmt den Socket danach wieder auf
+    __orobi_pool_rx_arm(gw, 0);
+    atomic_store(&pool->rx_paused, true);
+    gw->lane.stats.rx_paused++;
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&pool->free_head, memory_order_relaxed) != OROBI_GATEWAY_NO_BUFFER &&
+        atomic_exchange(&pool->rx_paused, false)) {
+        __orobi_pool_rx_arm(gw, EPOLLIN);
+    }
+}
+
+static uint32_t __orobi_pool_alloc(orobi_gateway_pool_t* pool) {
+    unsigned head = atomic_load_explicit(&pool->free_head, memory_order_acquire);
+    while (head != OROBI_GATEWAY_NO_BUFFER &&
+           !atomic_compare_exchange_weak_explicit(&pool->free_head, &head, pool->buffers[head].next,
+                                                  memory_order_acquire, memory_order_acquire)) {
+    }
+    return head;
+}
+
+// Postfach: die Operationen sind seq_cst, damit "Postfach leer" und "scheduled" zwischen
+// Poll-Thread und Worker konsistent gesehen werden (kein verlorenes Wecken)
+static bool __orobi_mailbox_push(orobi_gateway_mailbox_t* mailbox, uint32_t index) {
+    const unsigned head = atomic_load(&mailbox->head);
+    if (head - atomic_load(&mailbox->tail) >= OROBI_GATEWAY_MAILBOX) {
+        return false;
+    }
+    mailbox->slots[head & (OROBI_GATEWAY_MAILBOX - 1)] = index;
+    atomic_store(&mailbox->head, head + 1);
+    return true;
+}
+
+static uint32_t __orobi_mailbox_pop(orobi_gateway_mailbox_t* mailbox) {
+    const unsigned tail = atomic_load(&mailbox->tail);
+    if (tail == atomic_load(&mailbox->head)) {
+        return OROBI_GATEWAY_NO_BUFFER;
+    }
+    const uint32_t index = mailbox->slots[tail & (OROBI_GATEWAY_MAILBOX - 1)];
+    atomic_store(&mailbox->tail, tail + 1);
+    return index;
+}
+
+static bool __orobi_mailbox_empty(orobi_gateway_mailbox_t* mailbox) {
+    return atomic_load(&mailbox->tail) == atomic_load(&mailbox->head);
+}
+
+// Worker-Queue (FIFO von Roboter-Slots); Aufrufer hält worker->lock
+static void __orobi_queue_push(orobi_gateway_worker_t* worker, uint16_t slot) {
+    worker->queue[(worker->queue_head + worker->queue_count) % OROBI_GATEWAY_MAX_ROBOTS] = slot;
+    worker->queue_count++;
+}
+
+static uint16_t __orobi_queue_pop(orobi_gateway_worker_t* worker) {
+    if (worker->queue_count == 0) {
+        return OROBI_GATEWAY_NONE;
+    }
+    const uint16_t slot = worker->queue[worker->queue_head];
+    worker->queue_head = (worker->queue_head + 1) % OROBI_GATEWAY_MAX_ROBOTS;
+    worker->queue_count--;
+    return slot;
+}
+
+static uint16_t __orobi_worker_take(orobi_gateway_pool_t* pool, orobi_gateway_worker_t* worker) {
+    pthread_mutex_lock(&worker->lock);
+    uint16_t slot = __orobi_queue_pop(worker);
+    pthread_mutex_unlock(&worker->lock);
+    if (slot != OROBI_GATEWAY_NONE) {
+        atomic_fetch_sub(&pool->backlog, 1);
+        return slot;
+    }
+
+    // Stehlen: reihum ab dem Nachbarn, ältester Roboter zuerst
+    for (unsigned i = 1; i < pool->count && atomic_load(&pool->backlog) > 0; i++) {
+        orobi_gateway_worker_t* victim = &pool->workers[(worker->index + i) % pool->count];
+        pthread_mutex_lock(&victim->lock);
+        slot = __orobi_queue_pop(victim);
+        pthread_mutex_unlock(&victim->lock);
+        if (slot != OROBI_GATEWAY_NONE) {
+            atomic_fetch_sub(&pool->backlog, 1);
+            OROBI_GATEWAY_COUNT(worker->lane.stats.robots_stolen, 1);
+            return slot;
+        }
+    }
+    return OROBI_GATEWAY_NONE;
+}
+
+// Arbeitet das Postfach eines Roboters ab; nur dieser Worker hält den Roboter (scheduled == 1)
+static void __orobi_worker_run(orobi_gateway_t* gw, orobi_gateway_worker_t* worker, uint16_t slot) {
+    orobi_gateway_pool_t* pool = gw->pool;
+    orobi_gateway_mailbox_t* mailbox = &pool->mailboxes[slot];
+    orobi_gateway_robot_t* robot = &gw->robots[slot];
+
+    for (;;) {
+        uint32_t index;
+        while ((index = __orobi_mailbox_pop(mailbox)) != OROBI_GATEWAY_NO_BUFFER) {
+            orobi_gateway_buffer_t* buffer = &pool->buffers[index];
+            if (buffer->job == OROBI_GATEWAY_JOB_TIMEOUT) {
+                __orobi_gateway_reliable_timeout(gw, robot, &buffer->ticket);
+            } else {
+                __orobi_gateway_dispatch(gw, &worker->lane, robot, buffer->data, buffer->size, &buffer->addr,
+                                         buffer->rx_ms);
+            }
+            __orobi_pool_release(gw, index);
+        }
+
+        // Freigeben, dann erneut prüfen: ein inzwischen eingetroffenes Datagramm hat den Roboter
+        // womöglich nicht mehr eingeplant, weil scheduled noch gesetzt war
+        atomic_store(&mailbox->scheduled, 0);
+        if (__orobi_mailbox_empty(mailbox) || atomic_exchange(&mailbox->scheduled, 1) != 0) {
+            break;
+        }
+    }
+}
+
+static void* __orobi_worker_main(void* arg) {
+    orobi_gateway_worker_t* worker = arg;
+    orobi_gateway_t* gw = worker->gateway;
+    orobi_gateway_pool_t* pool = gw->pool;
+
+    __orobi_gateway_thread_lane = &worker->lane;
+    while (!atomic_load(&pool->stop)) {
+        const uint16_t slot = __orobi_worker_take(pool, worker);
+        if (slot != OROBI_GATEWAY_NONE) {
+            __orobi_worker_run(gw, worker, slot);
+            if (worker->lane.tx_count == OROBI_GATEWAY_BATCH) {
+                __orobi_gateway_flush_lane(gw, &worker->lane);
+            }
+            continue;
+        }
+
+        // Nichts zu tun: Antworten senden, dann schlafen bis zum Wecken durch den Poll-Thread
+        __orobi_gateway_flush_lane(gw, &worker->lane);
+        pthread_mutex_lock(&worker->lock);
+        worker->sleeping = true;
+        while (worker->queue_count == 0 && atomic_load(&pool->backlog) == 0 && !atomic_load(&pool->stop)) {
+            pthread_cond_wait(&worker->wake, &worker->lock);
+        }
+        worker->sleeping = false;
+        pthread_mutex_unlock(&worker->lock);
+    }
+
+    __orobi_gateway_flush_lane(gw, &worker->lane);
+    __orobi_gateway_thread_lane = NULL;
+    return NULL;
+}
+
+static void __orobi_worker_wake(orobi_gateway_worker_t* worker, bool only_sleeping) {
+    pthread_mutex_lock(&worker->lock);
+    if (!only_sleeping || worker->sleeping) {
+        pthread_cond_signal(&worker->wake);
+    }
+    pthread_mutex_unlock(&worker->lock);
+}
+
+// Legt den Puffer ins Postfach des Roboters und plant den Roboter beim Heimat-Worker ein.
+// false: Postfach voll, der Puffer gehört weiter dem Aufrufer.
+static bool __orobi_pool_schedule(orobi_gateway_t* gw, orobi_gateway_robot_t* robot, uint32_t index, bool* woken) {
+    orobi_gateway_pool_t* pool = gw->pool;
+    orobi_gateway_mailbox_t* mailbox = &pool->mailboxes[robot - gw->robots];
+    if (!__orobi_mailbox_push(mailbox, index)) {
+        return false;
+    }
+
+    if (atomic_exchange(&mailbox->scheduled, 1) == 0) {
+        orobi_gateway_worker_t* home = &pool->workers[robot->api_key % pool->count];
+        // backlog vor dem Einreihen erhöhen: ein Worker darf nie mehr entnehmen, als gezählt ist
+        atomic_fetch_add(&pool->backlog, 1);
+        pthread_mutex_lock(&home->lock);
+        __orobi_queue_push(home, (uint16_t)(robot - gw->robots));
+        pthread_mutex_unlock(&home->lock);
+        woken[home->index] = true;
+    }
+    return true;
+}
+
+static void __orobi_pool_deliver(orobi_gateway_t* gw, uint32_t index, bool* woken) {
+    orobi_gateway_pool_t* pool = gw->pool;
+    orobi_gateway_buffer_t* buffer = &pool->buffers[index];
+
+    buffer->job = OROBI_GATEWAY_JOB_DATAGRAM;
+    orobi_gateway_robot_t* robot = __orobi_gateway_route(gw, &gw->lane, buffer->data, buffer->size);
+    if (!robot) {
+        __orobi_pool_free(pool, index);
+        return;
+    }
+    if (!__orobi_pool_schedule(gw, robot, index, woken)) {
+        gw->lane.stats.rx_dropped++;
+        __orobi_pool_free(pool, index);
+    }
+}
+
+// Heimat-Worker wecken; bei Rückstau zusätzlich schlafende Worker zum Stehlen
+static void __orobi_pool_wake(orobi_gateway_pool_t* pool, const bool* woken) {
+    const bool backlog = atomic_load(&pool->backlog) > 1;
+    for (unsigned i = 0; i < pool->count; i++) {
+        if (woken[i] || backlog) {
+            __orobi_worker_wake(&pool->workers[i], !woken[i]);
+        }
+    }
+}
+
+void __orobi_gateway_pool_timeouts(orobi_gateway_t* gw, const orobi_ticket_t* expired, size_t count) {
+    orobi_gateway_pool_t* pool = gw->pool;
+    bool woken[OROBI_GATEWAY_MAX_WORKERS] = { false };
+
+    for (size_t i = 0; i < count; i++) {
+        orobi_gateway_robot_t* robot = &gw->robots[expired[i].id >> OROBI_RELIABLE_WINDOW_BITS];
+        const uint32_t index = __orobi_pool_alloc(pool);
+        if (index != OROBI_GATEWAY_NO_BUFFER) {
+            pool->buffers[index].job = OROBI_GATEWAY_JOB_TIMEOUT;
+            pool->buffers[index].ticket = expired[i];
+            if (__orobi_pool_schedule(gw, robot, index, woken)) {
+                continue;
+            }
+            __orobi_pool_free(pool, index);
+        }
+
+        // Kein Puffer oder Postfach voll: im nächsten tick erneut. Gibt es inzwischen ein neueres Ticket
+        // für den Fensterplatz, ist die Nachricht schon bestätigt oder wiederholt.
+        orobi_ticket_t current;
+        pthread_mutex_lock(&gw->timers_lock);
+        if (orobi_ticket_table_find(&gw->timers, expired[i].id, &current) != OROBI_OK) {
+            orobi_ticket_table_create(&gw->timers, expired[i].id, expired[i].ip, 1);
+        }
+        pthread_mutex_unlock(&gw->timers_lock);
+    }
+    __orobi_pool_wake(pool, woken);
+}
+
+size_t __orobi_gateway_pool_receive(orobi_gateway_t* gw) {
+    orobi_gateway_pool_t* pool = gw->pool;
+    bool woken[OROBI_GATEWAY_MAX_WORKERS] = { false };
+    size_t total = 0;
+
+    for (;;) {
+        // Freie Puffer für diesen recvmmsg-Aufruf bereitstellen (nicht benutzte bleiben für den nächsten)
+        unsigned ready = 0;
+        while (ready < OROBI_GATEWAY_BATCH) {
+            if (pool->rx_index[ready] == OROBI_GATEWAY_NO_BUFFER &&
+                (pool->rx_index[ready] = __orobi_pool_alloc(pool)) == OROBI_GATEWAY_NO_BUFFER) {
+                break;
+            }
+            orobi_gateway_buffer_t* buffer = &pool->buffers[pool->rx_index[ready]];
+            gw->rx_iov[ready].iov_base = buffer->data;
+            gw->rx_msgs[ready].msg_hdr.msg_name = &buffer->addr;
+            gw->rx_msgs[ready].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            ready++;
+        }
+        if (ready == 0) {
+            __orobi_pool_rx_pause(gw);
+            break;
+        }
+
+        const int n = recvmmsg(gw->sock, gw->rx_msgs, ready, MSG_DONTWAIT, NULL);
+        if (n <= 0) {
+            break;
+        }
+
+        gw->rx_syscalls++;
+        gw->rx_datagrams += (uint64_t)n;
+        const uint32_t rx_ms = orobi_clock_local_ms();
+        for (int i = 0; i < n; i++) {
+            const uint32_t index = pool->rx_index[i];
+            pool->buffers[index].size = (uint16_t)gw->rx_msgs[i].msg_len;
+            pool->buffers[index].rx_ms = rx_ms;
+            __orobi_pool_deliver(gw, index, woken);
+        }
+        // Verbrauchte Einträge nachrücken, damit rx_index[0..] wieder die übrigen Puffer hält
+        memmove(pool->rx_index, pool->rx_index + n, (OROBI_GATEWAY_BATCH - (size_t)n) * sizeof(uint32_t));
+        for (unsigned i = OROBI_GATEWAY_BATCH - (unsigned)n; i < OROBI_GATEWAY_BATCH; i++) {
+            pool->rx_index[i] = OROBI_GATEWAY_NO_BUFFER;
+        }
+        total += (size_t)n;
+
+        if ((unsigned)n < ready) {
+            break;
+        }
+    }
+
+    __orobi_pool_wake(pool, woken);
+
+    // rx-Vektor wieder auf die eigenen Puffer für den Betrieb ohne Worker stellen
+    for (unsigned i = 0; i < OROBI_GATEWAY_BATCH; i++) {
+        gw->rx_iov[i].iov_base = gw->rx_buf[i];
+        gw->rx_msgs[i].msg_hdr.msg_name = &gw->rx_addr[i];
+    }
+    return total;
+}
+
+// Stoppt die ersten started Worker-Threads und gibt den Pool frei
+static void __orobi_pool_shutdown(orobi_gateway_t* gateway, unsigned started) {
+    orobi_gateway_pool_t* pool = gateway->pool;
+    atomic_store(&pool->stop, true);
+    for (unsigned i = 0; i < pool->count; i++) {
+        __orobi_worker_wake(&pool->workers[i], false);
+    }
+    for (unsigned i = 0; i < started; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    if (atomic_load(&pool->rx_paused)) {
+        __orobi_pool_rx_arm(gateway, EPOLLIN);
+    }
+
+    // Datagramme verwerfen, abgelaufene Timer aber nachholen: sonst bliebe die Nachricht ohne Timer liegen
+    for (unsigned slot = 0; slot < OROBI_GATEWAY_MAX_ROBOTS; slot++) {
+        uint32_t index;
+        while ((index = __orobi_mailbox_pop(&pool->mailboxes[slot])) != OROBI_GATEWAY_NO_BUFFER) {
+            if (pool->buffers[index].job == OROBI_GATEWAY_JOB_TIMEOUT) {
+                __orobi_gateway_reliable_timeout(gateway, &gateway->robots[slot], &pool->buffers[index].ticket);
+            }
+        }
+    }
+
+    // Zähler der Worker in die Spur des Poll-Threads übernehmen, damit orobi_gateway_get_stats stimmt
+    for (unsigned i = 0; i < pool->count; i++) {
+        pthread_mutex_destroy(&pool->workers[i].lock);
+        pthread_cond_destroy(&pool->workers[i].wake);
+        __orobi_gateway_sum_stats(&gateway->lane.stats, &pool->workers[i].lane.stats);
+    }
+
+    free(pool->workers);
+    free(pool->buffers);
+    free(pool);
+    gateway->pool = NULL;
+}
+
+orobi_error_t orobi_gateway_start_workers(orobi_gateway_t* gateway, unsigned count) {
+    if (!gateway || count == 0 || count > OROBI_GATEWAY_MAX_WORKERS) {
+        return OROBI_ERROR_INVALID_INPUT;
+    }
+    if (gateway->pool) {
+        return OROBI_ERROR_INVALID_CONFIGURATION;
+    }
+
+    orobi_gateway_pool_t* pool = calloc(1, sizeof(orobi_gateway_pool_t));
+    if (!pool) {
+        return OROBI_ERROR_MEMORY;
+    }
+    pool->workers = calloc(count, sizeof(orobi_gateway_worker_t));
+    pool->buffers = calloc(OROBI_GATEWAY_POOL_BUFFERS, sizeof(orobi_gateway_buffer_t));
+    if (!pool->workers || !pool->buffers) {
+        free(pool->workers);
+        free(pool->buffers);
+        free(pool);
+        return OROBI_ERROR_MEMORY;
+    }
+
+    atomic_init(&pool->free_head, OROBI_GATEWAY_NO_BUFFER);
+    for (uint32_t i = OROBI_GATEWAY_POOL_BUFFERS; i > 0; i--) {
+        __orobi_pool_free(pool, i - 1);
+    }
+    for (unsigned i = 0; i < OROBI_GATEWAY_BATCH; i++) {
+        pool->rx_index[i] = OROBI_GATEWAY_NO_BUFFER;
+    }
+    atomic_init(&pool->rx_paused, false);
+    atomic_init(&pool->stop, false);
+    atomic_init(&pool->backlog, 0);
+    // Alle Worker vollständig anlegen, bevor der erste Thread startet (Stehlen greift auf alle zu)
+    pool->count = count;
+    for (unsigned i = 0; i < count; i++) {
+        orobi_gateway_worker_t* worker = &pool->workers[i];
+        worker->gateway = gateway;
+        worker->index = i;
+        pthread_mutex_init(&worker->lock, NULL);
+        pthread_cond_init(&worker->wake, NULL);
+        __orobi_gateway_lane_init(&worker->lane);
+    }
+    gateway->pool = pool;
+
+    for (unsigned i = 0; i < count; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, __orobi_worker_main, &pool->workers[i]) != 0) {
+            __orobi_pool_shutdown(gateway, i);
+            return OROBI_ERROR_INITIALIZATION_FAILED;
+        }
+    }
+    return OROBI_OK;
+}
+
+void orobi_gateway_stop_workers(orobi_gateway_t* gateway) {
+    if (gateway && gateway->pool) {
+        __orobi_pool_shutdown(gateway, gateway->pool->count);
+    }
+}
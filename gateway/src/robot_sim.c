@@ -0,0 +1,269 @@
+// robot_sim.c
+// Lasttest für das Gateway über Loopback: ein Gateway und N simulierte Roboter in einem Prozess.
+// Jeder Roboter hat eigenen Socket, Schlüssel und orobi_secure_t und sendet mit festem Takt einen Batch
+// aus MOTORDATA + INT (Sendezeit, über orobi_txqueue eingereiht); das Gateway antwortet mit einem INT-Echo,
+// der Roboter misst die Laufzeit. Die Sitzungsuhr jedes Roboters gleicht sich über orobi_clock mit dem
+// Gateway ab, ab dann prüft das Gateway das Alter seiner Pakete.
+//
+//   robot_sim [robots=200] [rate_hz=100] [seconds=5] [workers=0]
+#define _GNU_SOURCE
+#include "gateway.h"
+#include "orobi_txqueue.h"
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    int                 sock;
+    uint16_t            api_key;
+    uint128_t           id;
+    unsigned char       public_key[crypto_box_PUBLICKEYBYTES];
+    unsigned char       secret_key[crypto_box_SECRETKEYBYTES];
+    orobi_secure_t      secure;
+    orobi_clock_t       clock;
+    uint8_t             seq;
+    uint64_t            sent;
+    uint64_t            acked;
+    uint64_t            rtt_total_us;
+    uint32_t            rtt_max_us;
+} sim_robot_t;
+
+typedef struct {
+    sim_robot_t*        robots;
+    int                 count;
+    int                 rate_hz;
+    int                 seconds;
+    int                 workers;
+    uint16_t            port;
+    unsigned char       gateway_key[crypto_box_PUBLICKEYBYTES];
+    atomic_bool         done;
+} sim_t;
+
+static uint64_t sim_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// Gateway-Seite: INT-Kommandos unverändert zurückschicken
+static void sim_gateway_handler(orobi_gateway_t* gateway, orobi_gateway_robot_t* robot,
+                                const uint8_t* message, size_t size, void* user) {
+    (void)user;
+    orobi_batch_t reply;        // mit Workern läuft der Handler parallel
+    orobi_batch_init(&reply, 0, 0);
+
+    orobi_batch_reader_t reader;
+    orobi_command_t command;
+    orobi_command_status_t status;
+    orobi_batch_reader_init(&reader, message, size);
+    while ((status = orobi_batch_next(&reader, &command, NULL, NULL)) != OROBI_COMMAND_STATUS_NODATA) {
+        if (status == OROBI_COMMAND_STATUS_OK && command.type == OROBI_COMMAND_INT) {
+            orobi_batch_add(&reply, &command, 0);
+        }
+    }
+    if (reply.count > 0) {
+        orobi_gateway_send(gateway, robot, reply.buffer, reply.size);
+    }
+}
+
+static void sim_robot_receive(sim_t* sim, sim_robot_t* robot, orobi_packet_t* packet, uint8_t* inflate) {
+    uint8_t buffer[OROBI_NETPACKET_MAXSIZE];
+    ssize_t len;
+    while ((len = recv(robot->sock, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+        orobi_netpacket_view_t view;
+        const uint8_t* message;
+        size_t message_size;
+        const uint32_t rx_ms = orobi_clock_local_ms();
+        if (orobi_netpacket_open(&robot->secure, buffer, (size_t)len, sim->gateway_key, packet, inflate,
+                                 OROBI_MAXMESSAGESIZE, &view, &message, &message_size) != OROBI_OK) {
+            continue;
+        }
+        if (message_size > 0 && message[0] == OROBI_CLOCK_RESPONSE_MARKER) {
+            orobi_clock_response(&robot->clock, message, message_size, rx_ms);
+            continue;
+        }
+
+        orobi_batch_reader_t reader;
+        orobi_command_t command;
+        orobi_batch_reader_init(&reader, message, message_size);
+        while (orobi_batch_next(&reader, &command, NULL, NULL) == OROBI_COMMAND_STATUS_OK) {
+            const uint32_t rtt = (uint32_t)sim_now_us() - command.value;
+            robot->acked++;
+            robot->rtt_total_us += rtt;
+            if (rtt > robot->rtt_max_us) {
+                robot->rtt_max_us = rtt;
+            }
+        }
+    }
+}
+
+static void* sim_robot_thread(void* arg) {
+    sim_t* sim = arg;
+    static orobi_packet_t packet;
+    static orobi_batch_t batch;
+    static orobi_txqueue_t queue;
+    static uint8_t inflate[OROBI_MAXMESSAGESIZE];
+    uint8_t buffer[OROBI_NETPACKET_MAXSIZE];
+    const uint64_t period_us = 1000000u / (uint64_t)sim->rate_hz;
+    const uint64_t end = sim_now_us() + (uint64_t)sim->seconds * 1000000u;
+    uint64_t next = sim_now_us();
+
+    orobi_batch_init(&batch, 0, 0);
+    orobi_txqueue_init(&queue);
+    while (sim_now_us() < end) {
+        for (int i = 0; i < sim->count; i++) {
+            sim_robot_t* robot = &sim->robots[i];
+            orobi_command_t command = { .type = OROBI_COMMAND_MOTORDATA };
+            command.motor.speed = (uint16_t)robot->seq;
+            command.motor.rotation = 512;
+
+            const uint32_t now_ms = (uint32_t)(sim_now_us() / 1000u);
+            size_t written;
+            if (orobi_clock_request_due(&robot->clock, now_ms)) {
+                uint8_t request[OROBI_CLOCK_REQUEST_SIZE];
+                size_t request_size;
+                orobi_clock_request_write(&robot->clock, now_ms, request, sizeof(request), &request_size);
+                if (orobi_netpacket_seal(&robot->secure, NULL, &packet, robot->seq++, robot->api_key, request,
+                                         (uint16_t)request_size, sim->gateway_key, buffer, sizeof(buffer),
+                                         &written) == OROBI_OK) {
+                    send(robot->sock, buffer, written, 0);
+                }
+            }
+
+            orobi_txqueue_push(&queue, &command, 0, now_ms);
+            command.type = OROBI_COMMAND_INT;
+            command.value = (uint32_t)sim_now_us();
+            orobi_txqueue_push(&queue, &command, 0, now_ms);
+            orobi_batch_reset(&batch);
+            orobi_txqueue_fill(&queue, &batch, now_ms);
+
+            if (orobi_batch_seal(&robot->secure, NULL, &packet, &batch, robot->seq++, robot->api_key,
+                                 sim->gateway_key, buffer, sizeof(buffer), &written) == OROBI_OK &&
+                send(robot->sock, buffer, written, 0) == (ssize_t)written) {
+                robot->sent++;
+            }
+            sim_robot_receive(sim, robot, &packet, inflate);
+        }
+
+        next += period_us;
+        const uint64_t now = sim_now_us();
+        if (next > now) {
+            usleep((useconds_t)(next - now));
+        }
+    }
+
+    // Letzte Antworten abholen
+    usleep(100000);
+    for (int i = 0; i < sim->count; i++) {
+        sim_robot_receive(sim, &sim->robots[i], &packet, inflate);
+    }
+    atomic_store(&sim->done, true);
+    return NULL;
+}
+
+static int sim_robot_open(sim_robot_t* robot, uint16_t port) {
+    robot->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    return robot->sock >= 0 && connect(robot->sock, (struct sockaddr*)&addr, sizeof(addr)) == 0 ? 0 : -1;
+}
+
+int main(int argc, char** argv) {
+    sim_t sim = {
+        .count = argc > 1 ? atoi(argv[1]) : 200,
+        .rate_hz = argc > 2 ? atoi(argv[2]) : 100,
+        .seconds = argc > 3 ? atoi(argv[3]) : 5,
+        .workers = argc > 4 ? atoi(argv[4]) : 0
+    };
+    if (sim.count <= 0 || sim.count > OROBI_GATEWAY_MAX_ROBOTS || sim.rate_hz <= 0 || sim.seconds <= 0 || sim.workers < 0) {
+        fprintf(stderr, "usage: %s [robots] [rate_hz] [seconds] [workers]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned char gateway_secret[crypto_box_SECRETKEYBYTES];
+    crypto_box_keypair(sim.gateway_key, gateway_secret);
+
+    orobi_gateway_t* gateway;
+    orobi_error_t status = orobi_gateway_create(&gateway, "127.0.0.1", 0, sim.gateway_key, gateway_secret,
+                                                sim_gateway_handler, NULL);
+    if (status != OROBI_OK) {
+        fprintf(stderr, "gateway: %d\n", status);
+        return 1;
+    }
+    sim.port = orobi_gateway_port(gateway);
+
+    sim.robots = calloc((size_t)sim.count, sizeof(sim_robot_t));
+    for (int i = 0; i < sim.count; i++) {
+        sim_robot_t* robot = &sim.robots[i];
+        robot->api_key = (uint16_t)(1000 + i);
+        robot->id.high = 0x0B0B000000000000ull | (uint64_t)i;
+        robot->id.low = (uint64_t)i * 2654435761u;
+        crypto_box_keypair(robot->public_key, robot->secret_key);
+        orobi_secure_init(&robot->secure, robot->id, robot->public_key, robot->secret_key);
+        orobi_secure_alloc_scratch(&robot->secure);
+        orobi_clock_init(&robot->clock, false);
+        orobi_secure_set_clock(&robot->secure, &robot->clock, 0);
+        if (sim_robot_open(robot, sim.port) != 0 ||
+            orobi_gateway_add_robot(gateway, robot->api_key, robot->id, robot->public_key, NULL) != OROBI_OK) {
+            fprintf(stderr, "robot %d setup failed\n", i);
+            return 1;
+        }
+    }
+
+    if (sim.workers > 0 && orobi_gateway_start_workers(gateway, (unsigned)sim.workers) != OROBI_OK) {
+        fprintf(stderr, "workers failed\n");
+        return 1;
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, sim_robot_thread, &sim);
+    while (!atomic_load(&sim.done)) {
+        orobi_gateway_poll(gateway, 10, NULL);
+    }
+    pthread_join(thread, NULL);
+    orobi_gateway_stop_workers(gateway);
+
+    uint64_t sent = 0, acked = 0, rtt_total = 0;
+    uint32_t rtt_max = 0, synced = 0, clock_error_max = 0;
+    const uint32_t local_ms = orobi_clock_local_ms();
+    for (int i = 0; i < sim.count; i++) {
+        orobi_clock_quality_t quality;
+        orobi_clock_get_quality(&sim.robots[i].clock, local_ms, &quality);
+        if (quality.synced) {
+            synced++;
+            if (quality.error_ms > clock_error_max) {
+                clock_error_max = quality.error_ms;
+            }
+        }
+        sent += sim.robots[i].sent;
+        acked += sim.robots[i].acked;
+        rtt_total += sim.robots[i].rtt_total_us;
+        if (sim.robots[i].rtt_max_us > rtt_max) {
+            rtt_max = sim.robots[i].rtt_max_us;
+        }
+        close(sim.robots[i].sock);
+    }
+
+    orobi_gateway_stats_t stats;
+    orobi_gateway_get_stats(gateway, &stats);
+    printf("robots %d, %d Hz, %d s, %d workers\n", sim.count, sim.rate_hz, sim.seconds, sim.workers);
+    printf("sent %llu, acked %llu, rtt avg %llu us, max %u us\n", (unsigned long long)sent,
+           (unsigned long long)acked, acked ? (unsigned long long)(rtt_total / acked) : 0ull, rtt_max);
+    printf("clock synced %u/%d, error max %u ms\n", synced, sim.count, clock_error_max);
+    printf("gateway rx %llu in %llu recvmmsg, tx %llu in %llu sendmmsg, dropped %llu/%llu, paused %llu, rejected %llu, malformed %llu, stolen %llu\n",
+           (unsigned long long)stats.rx_datagrams, (unsigned long long)stats.rx_syscalls,
+           (unsigned long long)stats.tx_datagrams, (unsigned long long)stats.tx_syscalls,
+           (unsigned long long)stats.rx_dropped, (unsigned long long)stats.tx_dropped,
+           (unsigned long long)stats.rx_paused, (unsigned long long)stats.rejected,
+           (unsigned long long)stats.malformed, (unsigned long long)stats.robots_stolen);
+
+    orobi_gateway_destroy(gateway);
+    free(sim.robots);
+    return acked > 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#ifndef __LIBOPENROBI_HOST_TWEETNACL_H__
+#define __LIBOPENROBI_HOST_TWEETNACL_H__
+
+// Host-Build: bildet die TweetNaCl-Namen auf libsodium ab (gleiche Primitive, gleiche Signaturen).
+// Auf dem ESP32 kommt tweetnacl.h aus der Komponente des Projekts.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define crypto_box_PUBLICKEYBYTES           32
+#define crypto_box_SECRETKEYBYTES           32
+#define crypto_box_BEFORENMBYTES            32
+#define crypto_box_NONCEBYTES               24
+#define crypto_box_ZEROBYTES                32
+#define crypto_box_BOXZEROBYTES             16
+#define crypto_stream_salsa20_KEYBYTES      32
+#define crypto_stream_salsa20_NONCEBYTES    8
+
+#define crypto_box                  crypto_box_curve25519xsalsa20poly1305
+#define crypto_box_open             crypto_box_curve25519xsalsa20poly1305_open
+#define crypto_box_keypair          crypto_box_curve25519xsalsa20poly1305_keypair
+#define crypto_box_beforenm         crypto_box_curve25519xsalsa20poly1305_beforenm
+#define crypto_box_afternm          crypto_box_curve25519xsalsa20poly1305_afternm
+#define crypto_box_open_afternm     crypto_box_curve25519xsalsa20poly1305_open_afternm
+
+int crypto_box_curve25519xsalsa20poly1305(unsigned char* c, const unsigned char* m, unsigned long long mlen,
+                                          const unsigned char* n, const unsigned char* pk, const unsigned char* sk);
+int crypto_box_curve25519xsalsa20poly1305_open(unsigned char* m, const unsigned char* c, unsigned long long clen,
+                                               const unsigned char* n, const unsigned char* pk,
+                                               const unsigned char* sk);
+int crypto_box_curve25519xsalsa20poly1305_keypair(unsigned char* pk, unsigned char* sk);
+int crypto_box_curve25519xsalsa20poly1305_beforenm(unsigned char* k, const unsigned char* pk, const unsigned char* sk);
+int crypto_box_curve25519xsalsa20poly1305_afternm(unsigned char* c, const unsigned char* m, unsigned long long mlen,
+                                                  const unsigned char* n, const unsigned char* k);
+int crypto_box_curve25519xsalsa20poly1305_open_afternm(unsigned char* m, const unsigned char* c,
+                                                       unsigned long long clen, const unsigned char* n,
+                                                       const unsigned char* k);
+int crypto_stream_salsa20(unsigned char* c, unsigned long long clen, const unsigned char* n, const unsigned char* k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LIBOPENROBI_HOST_TWEETNACL_H__
@@ -0,0 +1,31 @@
+#ifndef __LIBOPENROBI_TEST_H__
+#define __LIBOPENROBI_TEST_H__
+
+// Minimaler Rahmen für die Host-Tests (make test): jeder Test ist ein eigenes Programm,
+// OROBI_CHECK zählt Fehlschläge, OROBI_TEST_RESULT liefert den Rückgabewert für main.
+
+#include <stdio.h>
+
+static int orobi_test_failures = 0;
+
+#define OROBI_CHECK(cond)                                                       \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            orobi_test_failures++;                                              \
+        }                                                                       \
+    } while (0)
+
+#define OROBI_CHECK_STATUS(expr, expected)                                      \
+    do {                                                                        \
+        const int __status = (int)(expr);                                       \
+        if (__status != (int)(expected)) {                                     \
+            fprintf(stderr, "%s:%d: %s returned %d, expected %d\n",             \
+                    __FILE__, __LINE__, #expr, __status, (int)(expected));      \
+            orobi_test_failures++;                                              \
+        }                                                                       \
+    } while (0)
+
+#define OROBI_TEST_RESULT() (orobi_test_failures == 0 ? 0 : 1)
+
+#endif // __LIBOPENROBI_TEST_H__
@@ -0,0 +1,11 @@
+#ifndef __LIBOPENROBI_TEST_ALLOC_H__
+#define __LIBOPENROBI_TEST_ALLOC_H__
+
+// Zähl-Hook für OROBI_MALLOC/OROBI_FREE, per -include in die Bibliothek von test_alloc eingebunden (siehe Makefile)
+
+#include <stddef.h>
+
+void* orobi_test_malloc(size_t size);
+void  orobi_test_free(void* ptr);
+
+#endif // __LIBOPENROBI_TEST_ALLOC_H__
@@ -0,0 +1,86 @@
+// test_alloc.c
+// Der heiße Pfad (create/encrypt/decrypt, encode/decode) darf mit Arbeitspuffer keinen Heap anfassen.
+// Die Bibliothek ist für diesen Test mit OROBI_MALLOC/OROBI_FREE auf die Zähler unten gebaut.
+#include "orobi_packet.h"
+#include "orobi_test.h"
+#include "orobi_test_alloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_ROUNDS 1000
+
+static size_t test_mallocs = 0;
+
+void* orobi_test_malloc(size_t size) {
+    test_mallocs++;
+    return malloc(size);
+}
+
+void orobi_test_free(void* ptr) {
+    free(ptr);
+}
+
+typedef struct {
+    unsigned char   public_key[crypto_box_PUBLICKEYBYTES];
+    unsigned char   secret_key[crypto_box_SECRETKEYBYTES];
+    orobi_secure_t  secure;
+} test_peer_t;
+
+static void test_peer_init(test_peer_t* peer, uint128_t id) {
+    crypto_box_keypair(peer->public_key, peer->secret_key);
+    orobi_secure_init(&peer->secure, id, peer->public_key, peer->secret_key);
+}
+
+// Ein Durchlauf altes Format und Wire-Format, Rückgabe: Anzahl Allokationen
+static size_t test_round(test_peer_t* robot, test_peer_t* ground, const char* message, uint16_t size) {
+    static orobi_packet_t packet, opened;
+    static orobi_crypt_packet_t crypt;
+    static uint8_t wire[OROBI_WIRE_SIZE(OROBI_MAXMESSAGESIZE)];
+    size_t wire_size = 0;
+
+    const size_t before = test_mallocs;
+    OROBI_CHECK_STATUS(orobi_create_packet(&robot->secure, &packet, message, size), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_encrypt_packet(&robot->secure, &packet, &crypt, ground->public_key), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_decrypt_packet(&ground->secure, &crypt, &opened, robot->public_key), OROBI_OK);
+    OROBI_CHECK(opened.message_size == size && memcmp(opened.message, message, size) == 0);
+
+    OROBI_CHECK_STATUS(orobi_create_packet(&robot->secure, &packet, message, size), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_encode_packet(&robot->secure, &packet, ground->public_key, wire, sizeof(wire), &wire_size),
+                       OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_decode_packet(&ground->secure, wire, wire_size, &opened, robot->public_key), OROBI_OK);
+    OROBI_CHECK(opened.message_size == size && memcmp(opened.message, message, size) == 0);
+    return test_mallocs - before;
+}
+
+int main(void) {
+    // Beide Seiten mit derselben id: der Pakethash ist mit der id geseedet
+    const uint128_t id = { .high = 0x0B0B000000000001ull, .low = 42 };
+    static test_peer_t robot, ground;
+    static char message[OROBI_MAXMESSAGESIZE];
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (char)('a' + i % 26);
+    }
+    test_peer_init(&robot, id);
+    test_peer_init(&ground, id);
+
+    // Ohne Arbeitspuffer weicht die Bibliothek auf den Heap aus: belegt, dass der Hook greift
+    OROBI_CHECK(test_round(&robot, &ground, message, 64) > 0);
+
+    OROBI_CHECK_STATUS(orobi_secure_alloc_scratch(&robot.secure), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_secure_alloc_scratch(&ground.secure), OROBI_OK);
+
+    // Aufwärmen (Peer-Slots, Schlüssel-Cache), danach stationär
+    test_round(&robot, &ground, message, 64);
+
+    size_t steady = 0;
+    for (int i = 0; i < TEST_ROUNDS; i++) {
+        steady += test_round(&robot, &ground, message, (uint16_t)(1 + i % OROBI_MAXMESSAGESIZE));
+    }
+    OROBI_CHECK(steady == 0);
+    if (steady != 0) {
+        fprintf(stderr, "%zu allocations in %d steady-state rounds\n", steady, TEST_ROUNDS);
+    }
+
+    // Kein orobi_secure_close: es gibt ctx selbst frei, die Kontexte liegen hier statisch
+    return OROBI_TEST_RESULT();
+}
@@ -0,0 +1,57 @@
+// test_crypto.c
+// Krypto-Backends: Testvektoren (orobi_crypto_self_test) je Backend und byte-identische Ausgaben
+// über alle Längen, also Box aus einem Backend lässt sich mit dem anderen öffnen.
+#include "orobi_crypto.h"
+#include "orobi_packet.h"
+#include "orobi_test.h"
+#include <string.h>
+
+#define TEST_MAX_SIZE   1100
+
+int main(void) {
+    static const orobi_crypto_backend_t backends[] = { OROBI_CRYPTO_NACL, OROBI_CRYPTO_NATIVE };
+    static uint8_t plain[crypto_box_ZEROBYTES + TEST_MAX_SIZE];
+    static uint8_t cipher[2][crypto_box_ZEROBYTES + TEST_MAX_SIZE];
+    static uint8_t opened[crypto_box_ZEROBYTES + TEST_MAX_SIZE];
+    uint8_t key[crypto_box_BEFORENMBYTES], nonce[crypto_box_NONCEBYTES];
+
+    for (size_t b = 0; b < 2; b++) {
+        OROBI_CHECK_STATUS(orobi_crypto_self_test(backends[b]), OROBI_OK);
+    }
+    OROBI_CHECK_STATUS(orobi_crypto_self_test((orobi_crypto_backend_t)7), OROBI_ERROR_INVALID_CONFIGURATION);
+    OROBI_CHECK_STATUS(orobi_crypto_set_backend((orobi_crypto_backend_t)7), OROBI_ERROR_INVALID_CONFIGURATION);
+
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = (uint8_t)(i * 13u + 5u);
+    }
+    for (size_t i = crypto_box_ZEROBYTES; i < sizeof(plain); i++) {
+        plain[i] = (uint8_t)(i * 131u + 7u);
+    }
+
+    // Alle Längen bis über mehrere 512-Byte-Blöcke (8 Salsa20-Blöcke parallel) und den Rest
+    for (size_t size = 0; size <= TEST_MAX_SIZE; size++) {
+        const size_t mlen = crypto_box_ZEROBYTES + size;
+        memset(nonce, (int)(size & 0xFF), sizeof(nonce));
+        for (size_t b = 0; b < 2; b++) {
+            OROBI_CHECK_STATUS(orobi_crypto_set_backend(backends[b]), OROBI_OK);
+            OROBI_CHECK(orobi_crypto_box_afternm(cipher[b], plain, mlen, nonce, key) == 0);
+        }
+        OROBI_CHECK(memcmp(cipher[0], cipher[1], mlen) == 0);
+
+        for (size_t b = 0; b < 2; b++) {
+            OROBI_CHECK_STATUS(orobi_crypto_set_backend(backends[b]), OROBI_OK);
+            OROBI_CHECK(orobi_crypto_box_open_afternm(opened, cipher[1 - b], mlen, nonce, key) == 0);
+            OROBI_CHECK(memcmp(opened, plain, mlen) == 0);
+
+            // Manipulierter Authenticator
+            cipher[1 - b][crypto_box_BOXZEROBYTES] ^= 0x80;
+            OROBI_CHECK(orobi_crypto_box_open_afternm(opened, cipher[1 - b], mlen, nonce, key) != 0);
+            cipher[1 - b][crypto_box_BOXZEROBYTES] ^= 0x80;
+        }
+        if (orobi_test_failures > 0) {
+            fprintf(stderr, "first mismatch at size %zu\n", size);
+            break;
+        }
+    }
+    return OROBI_TEST_RESULT();
+}
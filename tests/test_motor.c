@@ -0,0 +1,85 @@
+// test_motor.c
+// Motor-Codec: Roundtrip mit Bestätigungen, Verlust der Referenz und Wiederaufsetzen per Keyframe,
+// auch nach mehr als 127 verlorenen Frames.
+#include "orobi_motor.h"
+#include "orobi_test.h"
+
+static orobi_motor_encoder_t enc;
+static orobi_motor_decoder_t dec;
+
+static orobi_motordata_t test_frame(int i) {
+    orobi_motordata_t frame = {
+        .speed = (uint16_t)(1000 + i * 3),
+        .rotation = (uint16_t)(500 - i),
+        .buttons = { (i & 1) != 0, false, (i & 4) != 0, false }
+    };
+    return frame;
+}
+
+static bool test_equal(const orobi_motordata_t* a, const orobi_motordata_t* b) {
+    return a->speed == b->speed && a->rotation == b->rotation && a->buttons[0] == b->buttons[0] &&
+           a->buttons[1] == b->buttons[1] && a->buttons[2] == b->buttons[2] && a->buttons[3] == b->buttons[3];
+}
+
+// Sendet Frame i; deliver false: geht verloren. Rückgabe: Status des Decoders
+static orobi_error_t test_step(int i, bool deliver, bool* keyframe) {
+    uint8_t buffer[OROBI_MOTOR_MAXFRAME];
+    size_t written;
+    const orobi_motordata_t frame = test_frame(i);
+    OROBI_CHECK_STATUS(orobi_motor_encode(&enc, &frame, buffer, sizeof(buffer), &written), OROBI_OK);
+    if (keyframe) {
+        *keyframe = (buffer[0] & OROBI_MOTOR_FLAG_KEYFRAME) != 0;
+    }
+    if (!deliver) {
+        return OROBI_OK;
+    }
+
+    orobi_motordata_t decoded;
+    uint8_t seq;
+    const orobi_error_t status = orobi_motor_decode(&dec, buffer, written, &decoded, &seq);
+    if (status == OROBI_OK) {
+        OROBI_CHECK(test_equal(&decoded, &frame));
+        orobi_motor_ack(&enc, seq);
+    }
+    return status;
+}
+
+int main(void) {
+    orobi_motor_encoder_init(&enc);
+    orobi_motor_decoder_init(&dec);
+
+    int i = 0;
+    for (; i < 200; i++) {
+        OROBI_CHECK_STATUS(test_step(i, true, NULL), OROBI_OK);
+    }
+
+    // Verbindungsabbruch über mehr als 127 Frames: der nächste Keyframe setzt wieder auf
+    for (int lost = 0; lost < 200; lost++, i++) {
+        test_step(i, false, NULL);
+    }
+    bool keyframe = false;
+    OROBI_CHECK_STATUS(test_step(i++, true, &keyframe), OROBI_OK);
+    OROBI_CHECK(keyframe);
+    for (int n = 0; n < 100; n++, i++) {
+        OROBI_CHECK_STATUS(test_step(i, true, NULL), OROBI_OK);
+    }
+
+    // Abbruch um genau 128 Frames: seq liegt scheinbar in der Vergangenheit
+    for (int lost = 0; lost < 128; lost++, i++) {
+        test_step(i, false, NULL);
+    }
+    OROBI_CHECK_STATUS(test_step(i++, true, &keyframe), OROBI_OK);
+    OROBI_CHECK(keyframe);
+
+    // Ein überholtes Delta wird weiterhin abgewiesen
+    uint8_t older[OROBI_MOTOR_MAXFRAME], newer[OROBI_MOTOR_MAXFRAME];
+    size_t older_size, newer_size;
+    orobi_motordata_t frame = test_frame(i++), decoded;
+    OROBI_CHECK_STATUS(orobi_motor_encode(&enc, &frame, older, sizeof(older), &older_size), OROBI_OK);
+    frame = test_frame(i++);
+    OROBI_CHECK_STATUS(orobi_motor_encode(&enc, &frame, newer, sizeof(newer), &newer_size), OROBI_OK);
+    OROBI_CHECK(!(older[0] & OROBI_MOTOR_FLAG_KEYFRAME) && !(newer[0] & OROBI_MOTOR_FLAG_KEYFRAME));
+    OROBI_CHECK_STATUS(orobi_motor_decode(&dec, newer, newer_size, &decoded, NULL), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_motor_decode(&dec, older, older_size, &decoded, NULL), OROBI_ERROR_PACKET_TOO_OLD);
+    return OROBI_TEST_RESULT();
+}
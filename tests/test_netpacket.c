@@ -0,0 +1,41 @@
+// test_netpacket.c
+// Header des Netzwerkpakets: serialize -> parse/parse_view, insbesondere das compressed-Flag im
+// Bitfeld von orobi_netpacket_t (muss als 1 zurückgelesen werden, nicht als -1).
+#include "orobi_command.h"
+#include "orobi_test.h"
+#include <string.h>
+
+static void test_roundtrip(bool compressed) {
+    static uint8_t buffer[OROBI_NETPACKET_MAXSIZE];
+    static const char payload[] = "payload";
+    memcpy(OROBI_NETPACKET_PAYLOAD(buffer), payload, sizeof(payload));
+
+    const orobi_netpacket_view_t view = {
+        .seq_nr = 7,
+        .api_key = 0xBEEF,
+        .compressed = compressed,
+        .compress_size = compressed ? 100 : 0,
+        .payload = OROBI_NETPACKET_PAYLOAD(buffer),
+        .payload_size = sizeof(payload)
+    };
+    size_t written = 0;
+    OROBI_CHECK_STATUS(orobi_netpacket_serialize(&view, buffer, sizeof(buffer), &written), OROBI_OK);
+    OROBI_CHECK(written == OROBI_NETPACKET_HEADER_SIZE + sizeof(payload));
+
+    orobi_netpacket_view_t parsed;
+    OROBI_CHECK_STATUS(orobi_netpacket_parse_view(buffer, written, &parsed), OROBI_OK);
+    OROBI_CHECK(parsed.compressed == compressed && parsed.seq_nr == 7 && parsed.api_key == 0xBEEF);
+
+    orobi_netpacket_t net;
+    OROBI_CHECK_STATUS(orobi_netpacket_parse(buffer, written, &net), OROBI_OK);
+    OROBI_CHECK(net.compressed == (compressed ? 1 : 0));
+    OROBI_CHECK(net.compress_size == (compressed ? 100u : sizeof(payload)));
+    OROBI_CHECK(net.raw_packet == OROBI_NETPACKET_PAYLOAD(buffer));
+    OROBI_CHECK_STATUS(orobi_netpacket_validate(&net), OROBI_OK);
+}
+
+int main(void) {
+    test_roundtrip(false);
+    test_roundtrip(true);
+    return OROBI_TEST_RESULT();
+}
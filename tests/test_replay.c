@@ -0,0 +1,152 @@
+// test_replay.c
+// Nonce-Präfixe und Replay-Fenster über Neustarts der Gegenstelle: ein neuer Präfix löst den laufenden nur
+// mit frischem Zeitstempel ab; mitgeschnittene Pakete alter Sitzungen sperren die laufende Sitzung nicht.
+#include "orobi_clock.h"
+#include "orobi_packet.h"
+#include "orobi_test.h"
+#include <string.h>
+#include <time.h>
+
+#define TEST_SESSIONS   8
+#define TEST_MAX_AGE_MS 20
+
+typedef struct {
+    uint8_t data[OROBI_WIRE_SIZE(16)];
+    size_t  size;
+} test_wire_t;
+
+static const uint128_t test_id = { .high = 0x0B0B000000000001ull, .low = 42 };
+static unsigned char robot_pk[crypto_box_PUBLICKEYBYTES], robot_sk[crypto_box_SECRETKEYBYTES];
+static unsigned char ground_pk[crypto_box_PUBLICKEYBYTES], ground_sk[crypto_box_SECRETKEYBYTES];
+static orobi_secure_t robot, ground;
+static orobi_packet_t packet, opened;
+
+// Roboter -> Bodenstation, mit oder ohne Sitzungsuhr (ohne: Zeitstempel 0)
+static test_wire_t test_send(const orobi_clock_t* clock) {
+    test_wire_t wire;
+    orobi_secure_set_clock(&robot, clock, TEST_MAX_AGE_MS);
+    OROBI_CHECK_STATUS(orobi_create_packet(&robot, &packet, "drive", 5), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_encode_packet(&robot, &packet, ground_pk, wire.data, sizeof(wire.data), &wire.size),
+                       OROBI_OK);
+    return wire;
+}
+
+static orobi_error_t test_receive(const test_wire_t* wire) {
+    return orobi_decode_packet(&ground, wire->data, wire->size, &opened, robot_pk);
+}
+
+static void test_sleep_ms(long ms) {
+    const struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// Acht Sitzungen des Roboters (sieben Neustarts), jede beginnt vor dem Uhrabgleich ohne Zeitstempel.
+// Danach werden Pakete aus Sitzung 0 (nicht mehr unter den gesperrten Präfixen) wiederholt.
+static void test_old_session_replay(void) {
+    static orobi_clock_t robot_clock, ground_clock;
+    test_wire_t first[TEST_SESSIONS], synced[TEST_SESSIONS];
+
+    orobi_clock_init(&ground_clock, true);
+    orobi_clock_init(&robot_clock, true);   // gleiche lokale Uhr: synchron ohne Anfrage/Antwort
+    orobi_secure_init(&ground, test_id, ground_pk, ground_sk);
+    orobi_secure_set_clock(&ground, &ground_clock, TEST_MAX_AGE_MS);
+
+    for (int s = 0; s < TEST_SESSIONS; s++) {
+        unsigned char live_prefix[OROBI_NONCE_PREFIX_SIZE];
+        memcpy(live_prefix, ground.peers[0].session_prefix, sizeof(live_prefix));
+        orobi_secure_init(&robot, test_id, robot_pk, robot_sk);
+        first[s] = test_send(NULL);
+        OROBI_CHECK_STATUS(test_receive(&first[s]), OROBI_OK);
+        if (s > 0) {
+            // Neuer Präfix ohne Zeitstempel ist nur Kandidat: die vorige Sitzung läuft weiter
+            OROBI_CHECK(memcmp(ground.peers[0].session_prefix, live_prefix, sizeof(live_prefix)) == 0);
+            OROBI_CHECK(ground.peers[0].candidate_top != 0);
+        }
+        synced[s] = test_send(&robot_clock);
+        OROBI_CHECK_STATUS(test_receive(&synced[s]), OROBI_OK);
+        OROBI_CHECK(ground.peers[0].candidate_top == 0);
+
+        // Kandidat mit frischem Zeitstempel bestätigt: Pakete der Sitzung davor sind gesperrt,
+        // Pakete des Kandidaten vor der Bestätigung gelten als gesehen
+        OROBI_CHECK(test_receive(&first[s]) != OROBI_OK);
+        if (s > 0) {
+            OROBI_CHECK_STATUS(test_receive(&first[s - 1]), OROBI_ERROR_NONCE_REPLAY);
+        }
+    }
+
+    test_sleep_ms(3 * TEST_MAX_AGE_MS);
+
+    // Erstes Paket aus Sitzung 0: wird höchstens als Kandidat angenommen, genau einmal
+    const orobi_error_t replayed = test_receive(&first[0]);
+    OROBI_CHECK(replayed == OROBI_OK || replayed == OROBI_ERROR_NONCE_REPLAY);
+    OROBI_CHECK_STATUS(test_receive(&first[0]), OROBI_ERROR_NONCE_REPLAY);
+    // Mit Zeitstempel ist es zu alt und löst die laufende Sitzung nicht ab
+    OROBI_CHECK_STATUS(test_receive(&synced[0]), OROBI_ERROR_PACKET_TOO_OLD);
+    OROBI_CHECK_STATUS(test_receive(&synced[1]), OROBI_ERROR_PACKET_TOO_OLD);
+
+    // Die laufende Sitzung ist davon unberührt, mit und ohne Zeitstempel
+    for (int i = 0; i < 4; i++) {
+        const test_wire_t live = test_send(&robot_clock);
+        OROBI_CHECK_STATUS(test_receive(&live), OROBI_OK);
+        OROBI_CHECK_STATUS(test_receive(&live), OROBI_ERROR_NONCE_REPLAY);
+    }
+    const test_wire_t live = test_send(NULL);
+    OROBI_CHECK_STATUS(test_receive(&live), OROBI_OK);
+}
+
+// Ohne Uhr beim Empfänger bleibt ein neuer Präfix Kandidat: er wird angenommen (streng steigend),
+// der laufende Präfix bleibt gültig
+static void test_candidate_without_clock(void) {
+    orobi_secure_init(&ground, test_id, ground_pk, ground_sk);
+    orobi_secure_init(&robot, test_id, robot_pk, robot_sk);
+    const test_wire_t old_first = test_send(NULL);
+    const test_wire_t old_second = test_send(NULL);
+    OROBI_CHECK_STATUS(test_receive(&old_first), OROBI_OK);
+
+    orobi_secure_init(&robot, test_id, robot_pk, robot_sk);
+    for (int i = 0; i < 4; i++) {
+        const test_wire_t wire = test_send(NULL);
+        OROBI_CHECK_STATUS(test_receive(&wire), OROBI_OK);
+        OROBI_CHECK_STATUS(test_receive(&wire), OROBI_ERROR_NONCE_REPLAY);
+    }
+    OROBI_CHECK_STATUS(test_receive(&old_second), OROBI_OK);
+    OROBI_CHECK_STATUS(test_receive(&old_second), OROBI_ERROR_NONCE_REPLAY);
+}
+
+// Altes Format: Alter und Replay hängen an den Nonce-Bytes, nicht an der Klartext-Kopie im orobi_crypt_packet_t
+static void test_plaintext_timestamp(void) {
+    static orobi_clock_t clock;
+    static orobi_crypt_packet_t crypt;
+    orobi_clock_init(&clock, true);
+    orobi_secure_init(&ground, test_id, ground_pk, ground_sk);
+    orobi_secure_init(&robot, test_id, robot_pk, robot_sk);
+    orobi_secure_set_clock(&ground, &clock, TEST_MAX_AGE_MS);
+    orobi_secure_set_clock(&robot, &clock, TEST_MAX_AGE_MS);
+
+    OROBI_CHECK_STATUS(orobi_create_packet(&robot, &packet, "drive", 5), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_encrypt_packet(&robot, &packet, &crypt, ground_pk), OROBI_OK);
+    test_sleep_ms(3 * TEST_MAX_AGE_MS);
+
+    // Veralteter Zeitstempel in der Klartext-Kopie durch einen aktuellen bzw. 0 ersetzt
+    crypt.nonce.timestamp_ms = orobi_clock_now(&clock);
+    OROBI_CHECK_STATUS(orobi_decrypt_packet(&ground, &crypt, &opened, robot_pk), OROBI_ERROR_PACKET_TOO_OLD);
+    crypt.nonce.timestamp_ms = 0;
+    OROBI_CHECK_STATUS(orobi_decrypt_packet(&ground, &crypt, &opened, robot_pk), OROBI_ERROR_PACKET_TOO_OLD);
+
+    // Frisches Paket mit verfälschtem Klartext-Zeitstempel: geprüft und gezählt wird der geschützte
+    OROBI_CHECK_STATUS(orobi_create_packet(&robot, &packet, "drive", 5), OROBI_OK);
+    OROBI_CHECK_STATUS(orobi_encrypt_packet(&robot, &packet, &crypt, ground_pk), OROBI_OK);
+    crypt.nonce.timestamp_ms = 0;
+    OROBI_CHECK_STATUS(orobi_decrypt_packet(&ground, &crypt, &opened, robot_pk), OROBI_OK);
+    OROBI_CHECK(ground.peers[0].synced_counter == crypt.nonce.counter);
+}
+
+int main(void) {
+    crypto_box_keypair(robot_pk, robot_sk);
+    crypto_box_keypair(ground_pk, ground_sk);
+
+    test_old_session_replay();
+    test_candidate_without_clock();
+    test_plaintext_timestamp();
+    return OROBI_TEST_RESULT();
+}